@@ -0,0 +1,66 @@
+#include <Core/binary.h>
+#include <Core/h5.h>
+
+const char *USAGE=
+"\n\
+Usage:  binTool <file>\n\
+\n\
+  file.rbin:  lists the records and writes them as text graph to file.rbin.g\n\
+  file.h5:    writes all datasets as array records to file.h5.rbin\n\
+  otherwise:  reads the file as graph and writes it as one record 'graph' to file.g.rbin\n";
+
+//===========================================================================
+
+template<class T> bool addArray(rai::BinaryWriter& W, rai::Node* n){
+  if(!n->is<rai::Array<T>>()) return false;
+  W.add(n->key, n->as<rai::Array<T>>());
+  return true;
+}
+
+void list(rai::BinaryReader& R){
+  for(auto& r:R.records){
+    cout <<"  " <<r.name <<": ";
+    if(r.kind=='G') cout <<"graph";
+    else cout <<"array '" <<r.type <<"' " <<r.dim;
+    cout <<" (" <<r.size <<" bytes)" <<endl;
+  }
+}
+
+//===========================================================================
+
+int MAIN(int argc, char** argv){
+  rai::initCmdLine(argc, argv);
+
+  rai::String file=rai::getParameter<rai::String>("file",STRING("none"));
+  if(rai::argc>=2 && rai::argv[1][0]!='-') file=rai::argv[1];
+  if(file=="none"){ cout <<USAGE <<endl; return 1; }
+
+  if(file.endsWith(".rbin")){
+    rai::BinaryReader R(file);
+    cout <<"== " <<file <<": " <<R.records.N <<" records" <<endl;
+    list(R);
+    rai::String out = STRING(file <<".g");
+    if(R.records.N==1 && R.records(0).kind=='G' && R.records(0).name=="graph") FILE(out) <<R.readGraph(0u);
+    else FILE(out) <<R.readAll();
+    cout <<"== written " <<out <<endl;
+    return 0;
+  }
+
+  rai::String out = STRING(file <<".rbin");
+  rai::BinaryWriter W(out);
+  if(file.endsWith(".h5")){
+    rai::H5_Reader H(file);
+    H.readAll();
+    for(rai::Node* n:H.G){
+      if(addArray<double>(W, n) || addArray<float>(W, n) || addArray<int>(W, n) || addArray<uint>(W, n)
+         || addArray<int16_t>(W, n) || addArray<uint16_t>(W, n)) continue;
+      LOG(-1) <<"skipping dataset '" <<n->key <<"' of unsupported type";
+    }
+  } else {
+    rai::Graph G(file.p);
+    W.addGraph("graph", G);
+  }
+  cout <<"== written " <<out <<endl;
+
+  return 0;
+}
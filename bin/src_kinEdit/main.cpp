@@ -13,6 +13,7 @@ const char *USAGE =
     "\n  -collisions      compute collisions in the scene and report proxies"
     "\n  -writeMeshes     write all meshes in a folder"
     "\n  -convert         write various export formats (urdf, collada)"
+    "\n  -compile         write a binary scene file z.gbin (with all meshes and convex cores) and validate it"
     "\n  -dot             illustrate the tree structure as graph"
     "\n  -cleanOnly       skip the animation/edit loop\n";
 
@@ -93,6 +94,16 @@ int main(int argc,char **argv){
       C.writeCollada("z.dae");
     }
 
+    if(rai::checkParameter<bool>("compile")){
+      LOG(0) <<"compiling binary scene file";
+      C.writeBinaryFile("z.gbin");
+      rai::Configuration C2("z.gbin");
+      rai::String g1, g2;
+      g1 <<C;
+      g2 <<C2;
+      if(!(g1==g2)) LOG(-1) <<"binary scene differs from the configuration after reloading!";
+    }
+
     if(rai::checkParameter<double>("scale")){
       for(rai::Frame *f:C.frames) if(f->shape){
         f->shape->mesh().scale(rai::getParameter<double>("scale"));
@@ -20,6 +20,8 @@
 #include "util.h"
 #include "util.ipp"
 
+#include <atomic>
+
 #ifdef RAI_LAPACK
 extern "C" {
 #include "cblas.h"
@@ -67,6 +69,89 @@ const char* arrayElemsep=", ";
 const char* arrayLinesep=",\n ";
 const char* arrayBrackets="[]";
 
+//===========================================================================
+
+thread_local ArrayAllocStats arrayAllocStats;
+
+ArrayAllocStats ArrayAllocStats::operator-(const ArrayAllocStats& s) const {
+  ArrayAllocStats d;
+  d.heapAllocs = heapAllocs-s.heapAllocs;
+  d.heapFrees = heapFrees-s.heapFrees;
+  d.heapBytes = heapBytes-s.heapBytes;
+  d.inlineUses = inlineUses-s.inlineUses;
+  d.arenaAllocs = arenaAllocs-s.arenaAllocs;
+  return d;
+}
+
+ArrayAllocStats& ArrayAllocStats::operator+=(const ArrayAllocStats& s) {
+  heapAllocs += s.heapAllocs;
+  heapFrees += s.heapFrees;
+  heapBytes += s.heapBytes;
+  inlineUses += s.inlineUses;
+  arenaAllocs += s.arenaAllocs;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const ArrayAllocStats& s) {
+  os <<"heap allocs: " <<s.heapAllocs <<" frees: " <<s.heapFrees <<" bytes: " <<s.heapBytes
+     <<" inline: " <<s.inlineUses <<" arena: " <<s.arenaAllocs;
+  return os;
+}
+
+//-- arena: each allocation is preceded by a header pointing to its block; a block is referenced by its allocations
+//   and, while it is the current block, by the thread
+
+namespace {
+struct alignas(16) ArenaBlock {
+  std::atomic<uint> refs;
+  size_t used;
+  char* data() { return (char*)(this+1); }
+};
+
+struct ArenaHeader {
+  ArenaBlock* block;
+  size_t pad;
+};
+
+void unrefBlock(ArenaBlock* b) {
+  if(b->refs.fetch_sub(1)==1) free(b);
+}
+
+struct ThreadArena {
+  ArenaBlock* current=0;
+  ~ThreadArena() { if(current) unrefBlock(current); }
+};
+thread_local ThreadArena threadArena;
+}
+
+thread_local uint ArrayArena::scopes=0;
+
+void* ArrayArena::alloc(size_t bytes) {
+  size_t need = sizeof(ArenaHeader) + ((bytes+15)&~size_t(15));
+  if(need>blockSize/4) return 0;
+  ArenaBlock*& b = threadArena.current;
+  if(b && b->refs.load()==1) b->used=0; //all allocations of the current block were freed: start over
+  if(!b || b->used+need>blockSize) {
+    if(b) unrefBlock(b); //lives on while allocations remain
+    b = (ArenaBlock*)malloc(sizeof(ArenaBlock)+blockSize);
+    if(!b) { HALT("memory allocation failed! Wanted size = " <<blockSize <<"bytes"); }
+    new(&b->refs) std::atomic<uint>(1);
+    b->used=0;
+    arrayAllocStats.heapAllocs++;
+    arrayAllocStats.heapBytes += blockSize;
+  }
+  ArenaHeader* h = (ArenaHeader*)(b->data()+b->used);
+  h->block = b;
+  b->used += need;
+  b->refs++;
+  return h+1;
+}
+
+void ArrayArena::free(void* p) {
+  ArenaHeader* h = (ArenaHeader*)p - 1;
+  unrefBlock(h->block);
+}
+
 //===========================================================================
 }
 
@@ -1367,6 +1452,17 @@ arr lapack_Ainv_b_sym(const arr& A, const arr& b) {
   return x;
 }
 
+void lapack_Ainv_b_symPosDef_inPlace(arr& A, arr& b) {
+  CHECK(!isSpecial(A) && A.nd==2 && A.d0==A.d1 && b.nd==1 && b.N==A.d0, "");
+  integer N=A.d0, NRHS=1, INFO;
+  dposv_((char*)"L", &N, &NRHS, A.p, &N, b.p, &N, &INFO);
+  if(INFO) {
+    rai::errStringStream() <<"lapack_Ainv_b_symPosDef_inPlace error info = " <<INFO
+                           <<". Typically this is because A is not pos-def.";
+    throw(rai::errString());
+  }
+}
+
 uint lapack_SVD(
   arr& U,
   arr& d,
@@ -1604,6 +1700,7 @@ arr lapack_Ainv_b_sym(const arr& A, const arr& b) {
 };
 double lapack_determinantSymPosDef(const arr& A) { NICO; }
 void lapack_mldivide(arr& X, const arr& A, const arr& b) { NICO; }
+void lapack_Ainv_b_symPosDef_inPlace(arr& A, arr& b) { b = lapack_Ainv_b_sym(A, b); }
 arr lapack_Ainv_b_symPosDef_givenCholesky(const arr& U, const arr& b) { return inverse(U)*b; }
 arr lapack_Ainv_b_triangular(const arr& L, const arr& b) { return inverse(L)*b; }
 #endif
@@ -2581,10 +2678,50 @@ arr rai::unpack(const arr& X) {
   return arr();
 }
 
+//-- dense kernels, traversing A row by row (no transposed copy)
+
+/// z = A^T (x+y) (or A^T x if y is empty)
+static void dense_At_xpy(arr& z, const arr& A, const arr& x, const arr& y) {
+  CHECK_EQ(A.nd, 2, "");
+  CHECK_EQ(A.d0, x.N, "wrong dimensions");
+  CHECK(!y.N || y.N==x.N, "wrong dimensions");
+  uint n=A.d1;
+  z.resize(n).setZero();
+  double* zp=z.p;
+  for(uint i=0; i<A.d0; i++) {
+    double c = x.p[i];
+    if(y.N) c += y.p[i];
+    if(!c) continue;
+    const double* a=A.p+i*n;
+    for(uint j=0; j<n; j++) zp[j] += c*a[j];
+  }
+}
+
+/// X = A^T diag(w) A (or A^T A if w is empty); accumulates the upper triangle, then mirrors it
+static void dense_At_W_A(arr& X, const arr& A, const arr& w) {
+  CHECK_EQ(A.nd, 2, "");
+  CHECK(!w.N || w.N==A.d0, "wrong dimensions");
+  uint n=A.d1;
+  X.resize(n, n).setZero();
+  for(uint i=0; i<A.d0; i++) {
+    double wi = w.N ? w.p[i] : 1.;
+    if(!wi) continue;
+    const double* a=A.p+i*n;
+    for(uint j=0; j<n; j++) {
+      double c = wi*a[j];
+      if(!c) continue;
+      double* x=X.p+j*n;
+      for(uint k=j; k<n; k++) x[k] += c*a[k];
+    }
+  }
+  for(uint j=0; j<n; j++) for(uint k=0; k<j; k++) X.p[j*n+k] = X.p[k*n+j];
+}
+
 arr rai::comp_At_A(const arr& A) {
   if(!isSpecial(A)) {
     arr X;
-    if(rai::useLapack) blas_At_A(X, A);
+    if(A.nd==2 && !A.jac) dense_At_W_A(X, A, NoArr);
+    else if(rai::useLapack) blas_At_A(X, A);
     else X = ~A * A;
     return X;
   }
@@ -2606,12 +2743,34 @@ arr rai::comp_A_At(const arr& A) {
 //}
 
 arr rai::comp_At_x(const arr& A, const arr& x) {
-  if(!isSpecial(A)) { arr y; op_innerProduct(y, ~A, x); return y; }
+  if(!isSpecial(A)) {
+    arr y;
+    if(A.nd==2 && !A.jac && !x.jac) dense_At_xpy(y, A, x, NoArr);
+    else op_innerProduct(y, ~A, x);
+    return y;
+  }
   if(isRowShifted(A)) return ((rai::RowShifted*)A.special)->At_x(x);
   if(isSparseMatrix(A)) return ((rai::SparseMatrix*)A.special)->At_x(x);
   return NoArr;
 }
 
+arr rai::comp_At_xpy(const arr& A, const arr& x, const arr& y) {
+  if(!isSpecial(A) && A.nd==2) { arr z; dense_At_xpy(z, A, x, y); return z; }
+  return comp_At_x(A, x+y);
+}
+
+arr rai::comp_At_W_A(const arr& A, const arr& w) {
+  if(!isSpecial(A)) { arr X; dense_At_W_A(X, A, w); return X; }
+  //special matrices: scale the rows of a copy by sqrt(w)
+  for(double wi:w) CHECK_GE(wi, 0., "for sparse matrices, w needs to be non-negative");
+  arr tmp = A;
+  arr sqrtW = sqrt(w);
+  if(isSparseMatrix(tmp)) tmp.sparse().rowWiseMult(sqrtW);
+  else if(isRowShifted(tmp)) tmp.rowShifted().rowWiseMult(sqrtW);
+  else NIY;
+  return comp_At_A(tmp);
+}
+
 arr rai::comp_At(const arr& A) {
   if(!isSpecial(A)) { return ~A; }
   if(isRowShifted(A)) return ((rai::RowShifted*)A.special)->At();
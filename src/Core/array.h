@@ -13,6 +13,7 @@
 
 #include <initializer_list>
 #include <tuple>
+#include <type_traits>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -31,6 +32,42 @@ extern const char* arrayBrackets;
 extern int64_t globalMemoryTotal, globalMemoryBound;
 extern bool globalMemoryStrict;
 
+/// per-thread counts of Array memory operations
+struct ArrayAllocStats {
+  uint64_t heapAllocs=0, heapFrees=0; ///< malloc/realloc/new[] and free/delete[] calls
+  uint64_t heapBytes=0;               ///< bytes requested from the heap
+  uint64_t inlineUses=0;              ///< tiny arrays placed in their inline buffer instead
+  uint64_t arenaAllocs=0;             ///< allocations served by an ArrayArena
+  ArrayAllocStats operator-(const ArrayAllocStats& s) const;
+  ArrayAllocStats& operator+=(const ArrayAllocStats& s);
+};
+extern thread_local ArrayAllocStats arrayAllocStats;
+std::ostream& operator<<(std::ostream& os, const ArrayAllocStats& s);
+
+/// counts the Array memory operations of this thread since construction (or the last reset)
+struct ArrayAllocCounter {
+  ArrayAllocStats start;
+  ArrayAllocCounter() : start(arrayAllocStats) {}
+  void reset() { start = arrayAllocStats; }
+  ArrayAllocStats operator()() const { return arrayAllocStats - start; }
+};
+
+/** While a Scope is alive, (memmove-able) arrays of this thread that would allocate on the heap take their memory
+ *  from a thread-local bump allocator instead, e.g. around an NLP evaluation. Blocks are reused once all arrays in
+ *  them are freed; arrays that escape the scope keep their block alive, so this is always safe. */
+struct ArrayArena {
+  struct Scope {
+    bool on;
+    Scope(bool on=true) : on(on) { if(on) scopes++; }
+    ~Scope() { if(on) scopes--; }
+  };
+  static thread_local uint scopes;
+  static const uint blockSize = 1<<16;
+
+  static void* alloc(size_t bytes); ///< 0 if bytes is too large for a block (then use the heap)
+  static void free(void* p);        ///< also from other threads
+};
+
 // default sorting methods
 template<class T> bool lower(const T& a, const T& b) { return a<b; }
 template<class T> bool lowerEqual(const T& a, const T& b) { return a<=b; }
@@ -54,6 +91,21 @@ struct SparseVector;
 struct SparseMatrix;
 struct RowShifted;
 
+#ifndef RAI_ARRAY_INLINE_BYTES
+#  define RAI_ARRAY_INLINE_BYTES 32
+#endif
+
+/// inline storage of arrays of elementary types: tiny arrays (3-vectors, quaternions, index pairs) need no allocation
+template<class T, bool=std::is_arithmetic<T>::value && (RAI_ARRAY_INLINE_BYTES>0)> struct ArrayInlineMem {
+  static constexpr uint inlineN=0;
+  T* inlineP() { return 0; }
+};
+template<class T> struct ArrayInlineMem<T, true> {
+  static constexpr uint inlineN=RAI_ARRAY_INLINE_BYTES/sizeof(T);
+  alignas(T) char inlineMem[RAI_ARRAY_INLINE_BYTES];
+  T* inlineP() { return (T*)inlineMem; }
+};
+
 /** Simple array container to store arbitrary-dimensional arrays (tensors).
   Can buffer more memory than necessary for faster
   resize; enables non-const reference of subarrays; enables fast
@@ -62,7 +114,7 @@ struct RowShifted;
   Please see also the reference for the \ref array.h
   header, which contains lots of functions that can be applied on
   Arrays. */
-template<class T> struct Array {
+template<class T> struct Array : ArrayInlineMem<T> {
   T* p;     ///< the pointer on the linear memory allocated
   uint N;   ///< number of elements
   uint nd;  ///< number of dimensions
@@ -70,6 +122,8 @@ template<class T> struct Array {
   uint* d;  ///< pointer to dimensions (for nd<=3 points to d0)
   bool isReference; ///< true if this refers to memory of another array
   uint M;   ///< memory allocated (>=N)
+  enum { memHeap=0, memInline, memArena };
+  char memSource=memHeap; ///< where p was allocated
   SpecialArray* special=0; ///< auxiliary data, e.g. if this is a sparse matrics, depends on special type
 
   static int  sizeT;   ///< constant for each type T: stores the sizeof(T)
@@ -304,6 +358,8 @@ template<class T> struct Array {
   void resizeMEM(uint n, bool copy, int Mforce=-1);
   void reserveMEM(uint Mforce) { resizeMEM(N, true, Mforce); if(!nd) nd=1; }
   void freeMEM();
+  T* allocMEM(uint m);
+  void deallocMEM(T* q, uint m, char source);
   void resetD();
 
   /// @name serialization
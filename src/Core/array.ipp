@@ -75,14 +75,19 @@ template<class T> Array<T>::Array(Array<T>&& a)
     d(&d0),
     isReference(a.isReference),
     M(a.M),
+    memSource(a.memSource),
     special(a.special) {
   if constexpr(std::is_same_v<T, double>){
     if(a.jac) jac = std::move(a.jac);
   }
   // CHECK_EQ(a.d, &a.d0, "NIY for larger tensors");
   if(a.d!=&a.d0) { d=a.d; a.d=&a.d0; }
+  if constexpr(Array<T>::inlineN>0) {
+    if(memSource==memInline) { p=this->inlineP(); memmove(p, a.p, N*sizeT); } //the inline buffer can't be stolen
+  }
   a.p=NULL;
-  a.N=a.nd=a.d0=a.d1=a.d2=0;
+  a.N=a.nd=a.d0=a.d1=a.d2=a.M=0;
+  a.memSource=memHeap;
   a.isReference=false;
   a.special=NULL;
 }
@@ -110,10 +115,7 @@ template<class T> Array<T>::~Array() {
 #else //faster (leaves members non-zeroed..)
   if(special) { delete special; special=NULL; }
   if(d!=&d0) { delete[] d; }
-  if(M) {
-    globalMemoryTotal -= M*sizeT;
-    if(memMove==1) free(p); else delete[] p;
-  }
+  if(M) deallocMEM(p, M, memSource);
 #endif
 }
 
@@ -294,6 +296,8 @@ template<class T> void Array<T>::resizeMEM(uint n, bool copy, int Mforce) {
     }
 #endif
   }
+  //tiny arrays use the inline buffer (and stay there while they fit)
+  if(Mnew && Mnew<=this->inlineN && (!Mold || memSource==memInline)) Mnew=this->inlineN;
 
 #ifdef RAI_USE_STDVEC
   if(Mnew!=Mold) { vec_type::resize(Mnew); }
@@ -304,43 +308,39 @@ template<class T> void Array<T>::resizeMEM(uint n, bool copy, int Mforce) {
   CHECK_GE(Mnew, n, "");
   CHECK((p && M) || (!p && !M), "");
   if(Mnew!=Mold) {  //if M changed, allocate the memory
-    globalMemoryTotal -= Mold*sizeT;
-    globalMemoryTotal += Mnew*sizeT;
-    if(globalMemoryTotal>globalMemoryBound) {
-      if(globalMemoryStrict) {
-        globalMemoryTotal -= Mnew*sizeT;
-        HALT("out of memory: " <<((globalMemoryTotal+Mnew)>>20) <<"MB");
-      }
-      LOG(0) <<"using massive memory: " <<(globalMemoryTotal>>20) <<"MB";
-    }
-    if(Mnew) {
-      if(memMove==1) {
-        if(p) {
-          p=(T*)realloc(p, Mnew*sizeT);
-        } else {
-          p=(T*)malloc(Mnew*sizeT);
-          //memset(p, 0, Mnew*sizeT);
+    if(Mnew && memMove==1 && p && memSource==memHeap) { //heap memory is resized in place
+      globalMemoryTotal += (int64_t(Mnew)-int64_t(Mold))*sizeT;
+      if(globalMemoryTotal>globalMemoryBound) {
+        if(globalMemoryStrict) {
+          globalMemoryTotal -= Mnew*sizeT;
+          HALT("out of memory: " <<((globalMemoryTotal+Mnew)>>20) <<"MB");
         }
-        if(!p) { HALT("memory allocation failed! Wanted size = " <<Mnew*sizeT <<"bytes"); }
-      } else {
-        T* pold = p;
-        p=new T [Mnew];
-        if(!p) { HALT("memory allocation failed! Wanted size = " <<Mnew*sizeT <<"bytes"); }
-        if(copy) for(uint i=N<n?N:n; i--;) p[i]=pold[i];
-        if(pold) delete[] pold;
+        LOG(0) <<"using massive memory: " <<(globalMemoryTotal>>20) <<"MB";
       }
-      M=Mnew;
+      p=(T*)realloc(p, Mnew*sizeT);
+      if(!p) { HALT("memory allocation failed! Wanted size = " <<Mnew*sizeT <<"bytes"); }
+      arrayAllocStats.heapAllocs++;
+      arrayAllocStats.heapBytes += Mnew*sizeT;
     } else {
-      if(p) {
-        if(memMove==1) {
-          free(p);
-        } else {
-          delete[] p;
-        }
+      T* pold = p;
+      char sourceOld = memSource;
+      if(!Mnew) {
         p=0;
-        M=0;
+        memSource=memHeap;
+      } else if(Mnew==this->inlineN && !Mold) {
+        p=this->inlineP();
+        memSource=memInline;
+        arrayAllocStats.inlineUses++;
+      } else {
+        p=allocMEM(Mnew);
+        if(copy && pold) {
+          if(memMove==1) memmove(p, pold, sizeT*(N<n?N:n));
+          else for(uint i=N<n?N:n; i--;) p[i]=pold[i];
+        }
       }
+      if(pold) deallocMEM(pold, Mold, sourceOld);
     }
+    M=Mnew;
   }
 #endif
   N = n;
@@ -353,14 +353,10 @@ template<class T> void Array<T>::freeMEM() {
   vec_type::clear();
 #else
   if(M) {
-    globalMemoryTotal -= M*sizeT;
-    if(memMove==1) {
-      free(p);
-    } else {
-      delete[] p;
-    }
+    deallocMEM(p, M, memSource);
     p=0;
     M=0;
+    memSource=memHeap;
   }
 #endif
   if(d && d!=&d0) { delete[] d; d=NULL; }
@@ -370,6 +366,39 @@ template<class T> void Array<T>::freeMEM() {
   isReference=false;
 }
 
+/// allocate m elements (of memmove-able arrays from the ArrayArena, if in a scope); sets memSource
+template<class T> T* Array<T>::allocMEM(uint m) {
+  if(memMove==1 && ArrayArena::scopes) {
+    T* q = (T*)ArrayArena::alloc(m*sizeT);
+    if(q) { memSource=memArena; arrayAllocStats.arenaAllocs++; return q; }
+  }
+  globalMemoryTotal += m*sizeT;
+  if(globalMemoryTotal>globalMemoryBound) {
+    if(globalMemoryStrict) {
+      globalMemoryTotal -= m*sizeT;
+      HALT("out of memory: " <<((globalMemoryTotal+m)>>20) <<"MB");
+    }
+    LOG(0) <<"using massive memory: " <<(globalMemoryTotal>>20) <<"MB";
+  }
+  T* q;
+  if(memMove==1) q=(T*)malloc(m*sizeT);
+  else q=new T [m];
+  if(!q) { HALT("memory allocation failed! Wanted size = " <<m*sizeT <<"bytes"); }
+  memSource=memHeap;
+  arrayAllocStats.heapAllocs++;
+  arrayAllocStats.heapBytes += m*sizeT;
+  return q;
+}
+
+/// release the m elements at q, allocated from source
+template<class T> void Array<T>::deallocMEM(T* q, uint m, char source) {
+  if(source==memInline) return;
+  if(source==memArena) { ArrayArena::free(q); return; }
+  globalMemoryTotal -= m*sizeT;
+  if(memMove==1) free(q); else delete[] q;
+  arrayAllocStats.heapFrees++;
+}
+
 ///this was a reference; becomes a copy
 template<class T> Array<T>& Array<T>::dereference() {
   CHECK(isReference, "can only dereference a reference!");
@@ -1383,7 +1412,10 @@ template<class T> void Array<T>::takeOver(Array<T>& a) {
   freeMEM();
   memMove=a.memMove;
   N=a.N; nd=a.nd; d0=a.d0; d1=a.d1; d2=a.d2;
-  p=a.p; M=a.M;
+  p=a.p; M=a.M; memSource=a.memSource;
+  if constexpr(Array<T>::inlineN>0) {
+    if(memSource==memInline) { p=this->inlineP(); memmove(p, a.p, N*sizeT); }
+  }
   special=a.special;
 #if 0 //a remains reference on this
   a.isReference=true;
@@ -1391,6 +1423,7 @@ template<class T> void Array<T>::takeOver(Array<T>& a) {
 #else //a is cleared
   a.p=NULL;
   a.M=a.N=a.nd=a.d0=a.d1=a.d2=0;
+  a.memSource=memHeap;
   if(a.d && a.d!=&a.d0) { delete[] a.d; a.d=NULL; }
   a.special=0;
   a.isReference=false;
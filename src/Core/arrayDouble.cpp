@@ -1152,6 +1152,41 @@ double scalarProduct(const arr& g, const arr& v, const arr& w) {
   return t;
 }
 
+//===========================================================================
+
+void op_axpy(arr& y, double a, const arr& x) {
+  CHECK_EQ(y.N, x.N, "axpy on different array dimensions");
+  CHECK(!y.special && !x.special, "only for dense arrays");
+  double* yp=y.p;
+  const double* xp=x.p;
+  for(uint i=0; i<y.N; i++) yp[i] += a*xp[i];
+}
+
+void op_scaledSum(arr& z, double a, const arr& x, double b, const arr& y) {
+  CHECK_EQ(x.N, y.N, "scaled sum of different array dimensions");
+  CHECK(!x.special && !y.special, "only for dense arrays");
+  if(&z!=&x && &z!=&y) z.resizeAs(x);
+  double* zp=z.p;
+  const double* xp=x.p, *yp=y.p;
+  for(uint i=0; i<z.N; i++) zp[i] = a*xp[i] + b*yp[i];
+}
+
+double scalarProductOfDiff(const arr& x, const arr& y, const arr& g) {
+  CHECK(x.N==y.N && x.N==g.N, "scalar product on different array dimensions");
+  double t=0.;
+  for(uint i=0; i<x.N; i++) t += (x.p[i]-y.p[i])*g.p[i];
+  return t;
+}
+
+double absMaxDiff(const arr& x, const arr& y) {
+  CHECK_EQ(x.N, y.N, "different array dimensions");
+  double m=0.;
+  for(uint i=0; i<x.N; i++) { double d=std::fabs(x.p[i]-y.p[i]); if(d>m) m=d; }
+  return m;
+}
+
+//===========================================================================
+
 arr elemWiseMin(const arr& v, const arr& w) {
   arr z;
   z.resizeAs(v);
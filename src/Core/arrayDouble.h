@@ -529,6 +529,16 @@ arr elemWiseHinge(const arr& x);
 
 void writeConsecutiveConstant(std::ostream& os, const arr& x);
 
+//===========================================================================
+/// @}
+/// @name fused kernels: single pass loops without temporaries (dense arrays, no autodiff)
+/// @{
+
+void op_axpy(arr& y, double a, const arr& x);                               ///< y += a*x
+void op_scaledSum(arr& z, double a, const arr& x, double b, const arr& y); ///< z = a*x + b*y (z may be x or y)
+double scalarProductOfDiff(const arr& x, const arr& y, const arr& g);       ///< (x-y)^T g
+double absMaxDiff(const arr& x, const arr& y);                             ///< absMax(x-y)
+
 //===========================================================================
 /// @}
 /// @name arrays interpreted as a set
@@ -588,6 +598,7 @@ void lapack_choleskySymPosDef(arr& Achol, const arr& A);
 double lapack_determinantSymPosDef(const arr& A);
 inline arr lapack_inverseSymPosDef(const arr& A) { arr Ainv; lapack_inverseSymPosDef(Ainv, A); return Ainv; }
 arr lapack_Ainv_b_sym(const arr& A, const arr& b);
+void lapack_Ainv_b_symPosDef_inPlace(arr& A, arr& b); ///< dense A only: overwrites A with its Cholesky factor and b with the solution -- no copies
 void lapack_min_Ax_b(arr& x, const arr& A, const arr& b);
 arr lapack_Ainv_b_symPosDef_givenCholesky(const arr& U, const arr& b);
 arr lapack_Ainv_b_triangular(const arr& L, const arr& b);
@@ -718,6 +729,8 @@ arr unpack(const arr& X);
 arr comp_At_A(const arr& A);
 arr comp_A_At(const arr& A);
 arr comp_At_x(const arr& A, const arr& x);
+arr comp_At_xpy(const arr& A, const arr& x, const arr& y); ///< A^T (x+y), without forming x+y
+arr comp_At_W_A(const arr& A, const arr& w);               ///< A^T diag(w) A
 arr comp_At(const arr& A);
 arr comp_A_x(const arr& A, const arr& x);
 arr makeRowSparse(const arr& X);
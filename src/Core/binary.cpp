@@ -0,0 +1,462 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#include "binary.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rai {
+
+//===========================================================================
+
+static const char binaryMagic[8] = {'R', 'A', 'I', 'B', 'I', 'N', '1', '\n'};
+static const uint32_t binaryEndian = 0x01020304;
+
+struct BinaryRecordHead {
+  uint64_t size;     //of the whole record, including this head; a multiple of 8
+  char kind;         //'A' array, 'G' graph
+  char type;         //element type of arrays
+  uint8_t nd;
+  uint8_t reserved;
+  uint32_t nameLen;
+};
+
+static uint64_t pad8(uint64_t n) { return (n+7)&~uint64_t(7); }
+
+template<class T> char binaryType();
+template<> char binaryType<double>() { return 'd'; }
+template<> char binaryType<float>() { return 'f'; }
+template<> char binaryType<int>() { return 'i'; }
+template<> char binaryType<uint>() { return 'u'; }
+template<> char binaryType<int16_t>() { return 's'; }
+template<> char binaryType<uint16_t>() { return 'S'; }
+template<> char binaryType<char>() { return 'c'; }
+template<> char binaryType<unsigned char>() { return 'b'; }
+
+//===========================================================================
+//
+// graph encoding
+//
+
+template<class T> static void put(std::string& buf, const T& x) { buf.append((const char*)&x, sizeof(T)); }
+
+static void putString(std::string& buf, const char* p, uint32_t n) { put(buf, n); buf.append(p, n); }
+
+template<class T> static void putArray(std::string& buf, const Array<T>& x) {
+  put(buf, binaryType<T>());
+  put(buf, (uint8_t)x.nd);
+  for(uint i=0; i<x.nd; i++) put(buf, (uint32_t)x.dim(i));
+  buf.append((const char*)x.p, x.N*sizeof(T));
+}
+
+static void encodeGraph(std::string& buf, const Graph& G);
+
+static void encodeNode(std::string& buf, const Node* n) {
+  char v=0;
+  if(n->is<bool>()) v='b';
+  else if(n->is<double>()) v='d';
+  else if(n->is<int>()) v='i';
+  else if(n->is<uint>()) v='u';
+  else if(n->is<String>()) v='s';
+  else if(n->is<StringA>()) v='S';
+  else if(n->is<arr>() || n->is<floatA>() || n->is<intA>() || n->is<uintA>() || n->is<uint16A>() || n->is<byteA>()) v='A';
+  else if(n->is<Graph>()) v='G';
+
+  if(!v) { //any other type: its text form, read back with readNode
+    String str;
+    n->write(str);
+    put(buf, 'T');
+    putString(buf, str.p, str.N);
+    return;
+  }
+
+  put(buf, v);
+  putString(buf, n->key.p, n->key.N);
+  //parents by the number of levels up in the graph hierarchy and their index there
+  put(buf, (uint32_t)n->parents.N);
+  for(Node* p:n->parents) {
+    uint32_t up=0;
+    const Graph* g=&n->container;
+    while(&p->container!=g) {
+      CHECK(g->isNodeOfGraph, "parent '" <<p->key <<"' of node '" <<n->key <<"' is not in an enclosing graph");
+      g = &g->isNodeOfGraph->container;
+      up++;
+    }
+    if(!p->container.isIndexed) p->container.index();
+    put(buf, up);
+    put(buf, (uint32_t)p->index);
+  }
+
+  switch(v) {
+    case 'b': put(buf, (uint8_t)n->as<bool>()); break;
+    case 'd': put(buf, n->as<double>()); break;
+    case 'i': put(buf, n->as<int>()); break;
+    case 'u': put(buf, n->as<uint>()); break;
+    case 's': putString(buf, n->as<String>().p, n->as<String>().N); break;
+    case 'S': {
+      const StringA& S = n->as<StringA>();
+      put(buf, (uint32_t)S.N);
+      for(const String& s:S) putString(buf, s.p, s.N);
+    } break;
+    case 'A': {
+      if(n->is<arr>()) putArray(buf, n->as<arr>());
+      else if(n->is<floatA>()) putArray(buf, n->as<floatA>());
+      else if(n->is<intA>()) putArray(buf, n->as<intA>());
+      else if(n->is<uintA>()) putArray(buf, n->as<uintA>());
+      else if(n->is<uint16A>()) putArray(buf, n->as<uint16A>());
+      else putArray(buf, n->as<byteA>());
+    } break;
+    case 'G': encodeGraph(buf, n->graph()); break;
+  }
+}
+
+static void encodeGraph(std::string& buf, const Graph& G) {
+  put(buf, (uint32_t)G.N);
+  for(const Node* n:G) encodeNode(buf, n);
+}
+
+//===========================================================================
+//
+// graph decoding (from memory)
+//
+
+struct BinaryDecoder {
+  const char* p;
+  const char* end;
+  struct ParentRef { Node* n; uint32_t up, index; };
+  Array<ParentRef> parentRefs; //resolved when all nodes exist (parents may come later in enclosing graphs)
+
+  void need(uint64_t n) { if((uint64_t)(end-p)<n) HALT("binary graph data is truncated"); }
+  template<class T> T get() { need(sizeof(T)); T x; memcpy(&x, p, sizeof(T)); p+=sizeof(T); return x; }
+  void getString(String& s) { uint32_t n=get<uint32_t>(); need(n); s.set(p, n); p+=n; }
+
+  template<class T> Node* getArray(Graph& G, const char* key, uint nd) {
+    uintA dim(nd);
+    for(uint i=0; i<nd; i++) dim(i) = get<uint32_t>();
+    Node_typed<Array<T>>* n = G.add<Array<T>>(key);
+    Array<T>& x = n->value;
+    x.resize(dim);
+    need(x.N*sizeof(T));
+    if(x.N) memcpy((void*)x.p, p, x.N*sizeof(T));
+    p += x.N*sizeof(T);
+    return n;
+  }
+
+  void decode(Graph& G) {
+    graph(G);
+    for(const ParentRef& r:parentRefs) {
+      Graph* g=&r.n->container;
+      for(uint32_t j=0; j<r.up; j++) {
+        CHECK(g->isNodeOfGraph, "binary graph data: parent reference out of the graph hierarchy");
+        g = &g->isNodeOfGraph->container;
+      }
+      CHECK_LE(r.index+1, g->N, "binary graph data: parent reference out of range");
+      r.n->addParent(g->elem(r.index));
+    }
+  }
+
+  void graph(Graph& G) {
+    uint32_t N = get<uint32_t>();
+    for(uint32_t i=0; i<N; i++) node(G);
+  }
+
+  void node(Graph& G) {
+    char v = get<char>();
+    String key;
+    getString(key);
+    if(v=='T') { G.readNode(key, false, false); return; }
+
+    uint32_t nParents = get<uint32_t>();
+    Array<ParentRef> refs(nParents);
+    for(ParentRef& r:refs) { r.up=get<uint32_t>(); r.index=get<uint32_t>(); }
+
+    Node* n=0;
+    switch(v) {
+      case 'b': n = G.add<bool>(key, get<uint8_t>()); break;
+      case 'd': n = G.add<double>(key, get<double>()); break;
+      case 'i': n = G.add<int>(key, get<int>()); break;
+      case 'u': n = G.add<uint>(key, get<uint>()); break;
+      case 's': n = G.add<String>(key); getString(n->as<String>()); break;
+      case 'S': {
+        n = G.add<StringA>(key);
+        StringA& S = n->as<StringA>();
+        S.resize(get<uint32_t>());
+        for(String& s:S) getString(s);
+      } break;
+      case 'A': {
+        char type = get<char>();
+        uint nd = get<uint8_t>();
+        switch(type) {
+          case 'd': n = getArray<double>(G, key, nd); break;
+          case 'f': n = getArray<float>(G, key, nd); break;
+          case 'i': n = getArray<int>(G, key, nd); break;
+          case 'u': n = getArray<uint>(G, key, nd); break;
+          case 'S': n = getArray<uint16_t>(G, key, nd); break;
+          case 'b': n = getArray<byte>(G, key, nd); break;
+          default: HALT("binary graph data: unknown array type '" <<type <<"'");
+        }
+      } break;
+      case 'G': {
+        Graph& sub = G.addSubgraph(key);
+        n = sub.isNodeOfGraph;
+        graph(sub);
+      } break;
+      default: HALT("binary graph data: unknown node type '" <<v <<"'");
+    }
+    for(ParentRef& r:refs) { r.n=n; parentRefs.append(r); }
+  }
+};
+
+//===========================================================================
+
+BinaryWriter::BinaryWriter(const char* filename, bool append) {
+  uint64_t end=0;
+  if(append) {
+    //validate the existing file and cut a truncated last record
+    std::ifstream is(filename, std::ios::binary);
+    if(is.good()) {
+      char head[16];
+      is.read(head, 16);
+      if(is.gcount()==16) {
+        CHECK(!memcmp(head, binaryMagic, 8), "can't append to '" <<filename <<"': not a rai binary file");
+        is.seekg(0, std::ios::end);
+        uint64_t fileSize = is.tellg();
+        end=16;
+        BinaryRecordHead rec;
+        for(;;) {
+          is.seekg(end);
+          is.read((char*)&rec, sizeof(rec));
+          if(is.gcount()!=sizeof(rec) || rec.size<sizeof(rec) || end+rec.size>fileSize) break;
+          end += rec.size;
+        }
+        if(end<fileSize) {
+          LOG(-1) <<"'" <<filename <<"' has a truncated last record -- overwriting it";
+          if(::truncate(filename, end)) HALT("could not truncate '" <<filename <<"'");
+        }
+      }
+    }
+  }
+
+  if(end) {
+    fil.open(filename, std::ios::binary | std::ios::app);
+  } else {
+    fil.open(filename, std::ios::binary | std::ios::trunc);
+    fil.write(binaryMagic, 8);
+    uint32_t zero=0;
+    fil.write((const char*)&binaryEndian, 4);
+    fil.write((const char*)&zero, 4);
+  }
+  if(!fil.good()) HALT("could not open '" <<filename <<"' for writing");
+}
+
+BinaryWriter::~BinaryWriter() {
+  fil.flush();
+}
+
+void BinaryWriter::flush() {
+  fil.flush();
+}
+
+void BinaryWriter::writeRecord(const char* name, char kind, char type, const uintA& dim, const char* data, uint64_t size) {
+  static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  BinaryRecordHead rec;
+  rec.kind = kind;
+  rec.type = type;
+  rec.nd = dim.N;
+  rec.reserved = 0;
+  rec.nameLen = strlen(name);
+  rec.size = sizeof(rec) + pad8(rec.nameLen) + pad8(4*dim.N) + pad8(size);
+  CHECK_LE(dim.N, 255, "");
+
+  fil.write((const char*)&rec, sizeof(rec));
+  fil.write(name, rec.nameLen);
+  fil.write(zeros, pad8(rec.nameLen)-rec.nameLen);
+  for(uint d:dim) { uint32_t d32=d; fil.write((const char*)&d32, 4); }
+  fil.write(zeros, pad8(4*dim.N)-4*dim.N);
+  fil.write(data, size);
+  fil.write(zeros, pad8(size)-size);
+  if(!fil.good()) HALT("writing binary record '" <<name <<"' failed");
+}
+
+template<class T> void BinaryWriter::add(const char* name, const rai::Array<T>& x) {
+  writeRecord(name, 'A', binaryType<T>(), x.dim(), (const char*)x.p, x.N*sizeof(T));
+}
+
+void BinaryWriter::addGraph(const char* name, const Graph& G) {
+  std::string buf;
+  encodeGraph(buf, G);
+  writeRecord(name, 'G', 0, {}, buf.data(), buf.size());
+}
+
+//===========================================================================
+
+BinaryReader::BinaryReader(const char* filename) {
+  int fd = ::open(filename, O_RDONLY);
+  if(fd<0) HALT("file '" <<filename <<"' does not exist");
+  struct stat st;
+  fstat(fd, &st);
+  size = st.st_size;
+  if(size<16) { ::close(fd); HALT("'" <<filename <<"' is not a rai binary file"); }
+  data = (const char*)::mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(data==MAP_FAILED) { data=0; HALT("could not map '" <<filename <<"'"); }
+
+  CHECK(!memcmp(data, binaryMagic, 8), "'" <<filename <<"' is not a rai binary file");
+  CHECK_EQ(*(const uint32_t*)(data+8), binaryEndian, "'" <<filename <<"' was written on a machine of different endianness");
+
+  //-- index all records
+  uint64_t off=16;
+  while(off<size) {
+    const BinaryRecordHead* rec = (const BinaryRecordHead*)(data+off);
+    if(size-off<sizeof(*rec) || rec->size<sizeof(*rec) || rec->size>size-off) {
+      LOG(-1) <<"'" <<filename <<"' has a truncated last record -- ignoring it";
+      break;
+    }
+    Record& r = records.append();
+    const char* p = data+off+sizeof(*rec);
+    r.name.set(p, rec->nameLen);
+    p += pad8(rec->nameLen);
+    r.kind = rec->kind;
+    r.type = rec->type;
+    r.dim.resize(rec->nd);
+    for(uint i=0; i<rec->nd; i++) r.dim(i) = ((const uint32_t*)p)[i];
+    p += pad8(4*rec->nd);
+    r.offset = p-data;
+    r.size = off+rec->size - r.offset;
+    off += rec->size;
+  }
+}
+
+BinaryReader::~BinaryReader() {
+  if(data) ::munmap((void*)data, size);
+}
+
+int BinaryReader::find(const char* name) {
+  for(uint i=records.N; i--;) if(records(i).name==name) return i;
+  return -1;
+}
+
+bool BinaryReader::exists(const char* name) {
+  return find(name)>=0;
+}
+
+template<class T> rai::Array<T> BinaryReader::refer(uint i) {
+  const Record& r = records(i);
+  CHECK_EQ(r.kind, 'A', "record '" <<r.name <<"' is not an array");
+  CHECK_EQ(r.type, binaryType<T>(), "record '" <<r.name <<"' has type '" <<r.type <<"', not '" <<binaryType<T>() <<"'");
+  rai::Array<T> x;
+  if(!r.dim.N) return x;
+  uint n = product(r.dim);
+  CHECK_LE(n*sizeof(T), r.size, "record '" <<r.name <<"' is corrupt");
+  x.referTo((const T*)(data+r.offset), n);
+  x.reshape(r.dim);
+  return x;
+}
+
+template<class T> rai::Array<T> BinaryReader::read(uint i) {
+  rai::Array<T> x;
+  x = refer<T>(i);
+  return x;
+}
+
+template<class T> rai::Array<T> BinaryReader::read(const char* name, bool ifExists) {
+  int i = find(name);
+  if(i<0) {
+    if(ifExists) return {};
+    HALT("record '" <<name <<"' does not exist");
+  }
+  return read<T>(i);
+}
+
+template<class T> rai::Array<T> BinaryReader::refer(const char* name) {
+  int i = find(name);
+  if(i<0) HALT("record '" <<name <<"' does not exist");
+  return refer<T>(i);
+}
+
+Graph BinaryReader::readGraph(uint i) {
+  const Record& r = records(i);
+  CHECK_EQ(r.kind, 'G', "record '" <<r.name <<"' is not a graph");
+  Graph G;
+  BinaryDecoder dec = {data+r.offset, data+r.offset+r.size};
+  dec.decode(G);
+  return G;
+}
+
+Graph BinaryReader::readGraph(const char* name, bool ifExists) {
+  int i = find(name);
+  if(i<0) {
+    if(ifExists) return {};
+    HALT("record '" <<name <<"' does not exist");
+  }
+  return readGraph(i);
+}
+
+Graph BinaryReader::readAll() {
+  Graph G;
+  for(uint i=0; i<records.N; i++) {
+    const Record& r = records(i);
+    if(r.kind=='G') {
+      BinaryDecoder dec = {data+r.offset, data+r.offset+r.size};
+      dec.decode(G.addSubgraph(r.name));
+    } else {
+      switch(r.type) {
+        case 'd': G.add<arr>(r.name, read<double>(i)); break;
+        case 'f': G.add<floatA>(r.name, read<float>(i)); break;
+        case 'i': G.add<intA>(r.name, read<int>(i)); break;
+        case 'u': G.add<uintA>(r.name, read<uint>(i)); break;
+        case 's': G.add<int16A>(r.name, read<int16_t>(i)); break;
+        case 'S': G.add<uint16A>(r.name, read<uint16_t>(i)); break;
+        case 'c': G.add<charA>(r.name, read<char>(i)); break;
+        case 'b': G.add<byteA>(r.name, read<byte>(i)); break;
+        default: HALT("record '" <<r.name <<"' has unknown type '" <<r.type <<"'");
+      }
+    }
+  }
+  return G;
+}
+
+// explicit instantiations
+template void BinaryWriter::add<double>(const char* name, const rai::Array<double>& x);
+template void BinaryWriter::add<float>(const char* name, const rai::Array<float>& x);
+template void BinaryWriter::add<int>(const char* name, const rai::Array<int>& x);
+template void BinaryWriter::add<uint>(const char* name, const rai::Array<uint>& x);
+template void BinaryWriter::add<int16_t>(const char* name, const rai::Array<int16_t>& x);
+template void BinaryWriter::add<uint16_t>(const char* name, const rai::Array<uint16_t>& x);
+template void BinaryWriter::add<char>(const char* name, const rai::Array<char>& x);
+template void BinaryWriter::add<unsigned char>(const char* name, const rai::Array<unsigned char>& x);
+
+template rai::Array<double> BinaryReader::read<double>(const char* name, bool ifExists);
+template rai::Array<float> BinaryReader::read<float>(const char* name, bool ifExists);
+template rai::Array<int> BinaryReader::read<int>(const char* name, bool ifExists);
+template rai::Array<uint> BinaryReader::read<uint>(const char* name, bool ifExists);
+template rai::Array<int16_t> BinaryReader::read<int16_t>(const char* name, bool ifExists);
+template rai::Array<uint16_t> BinaryReader::read<uint16_t>(const char* name, bool ifExists);
+template rai::Array<char> BinaryReader::read<char>(const char* name, bool ifExists);
+template rai::Array<byte> BinaryReader::read<byte>(const char* name, bool ifExists);
+
+template rai::Array<double> BinaryReader::refer<double>(const char* name);
+template rai::Array<float> BinaryReader::refer<float>(const char* name);
+template rai::Array<int> BinaryReader::refer<int>(const char* name);
+template rai::Array<uint> BinaryReader::refer<uint>(const char* name);
+template rai::Array<int16_t> BinaryReader::refer<int16_t>(const char* name);
+template rai::Array<uint16_t> BinaryReader::refer<uint16_t>(const char* name);
+template rai::Array<char> BinaryReader::refer<char>(const char* name);
+template rai::Array<byte> BinaryReader::refer<byte>(const char* name);
+
+template rai::Array<double> BinaryReader::read<double>(uint i);
+template rai::Array<float> BinaryReader::read<float>(uint i);
+template rai::Array<int> BinaryReader::read<int>(uint i);
+template rai::Array<uint> BinaryReader::read<uint>(uint i);
+template rai::Array<double> BinaryReader::refer<double>(uint i);
+template rai::Array<float> BinaryReader::refer<float>(uint i);
+
+}//namespace
@@ -0,0 +1,71 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#pragma once
+
+#include "array.h"
+#include "graph.h"
+
+/* Binary files (.rbin) of named arrays and graphs:
+ *
+ *   rai::BinaryWriter W("log.rbin");              //or ("log.rbin", true) to append to an existing file
+ *   W.add("x", x);  W.addGraph("info", G);        //each add writes a record -- files can be streamed and appended
+ *
+ *   rai::BinaryReader R("log.rbin");              //maps the file
+ *   arr x = R.read<double>("x");                  //copy
+ *   arr y = R.refer<double>("x");                 //no copy: refers to the mapped file (valid while R lives)
+ *
+ * A file is a 16 byte header followed by records; each record is a header, its name, and either array dimensions and
+ * raw (native endian) data, or an encoded graph. Everything is 8 byte aligned, so array data can be used directly from
+ * the mapped file. Graph nodes of types other than bool, numbers, strings, file tokens, numeric arrays and subgraphs
+ * are stored in their text form. A truncated last record (e.g. of a killed process) is ignored when reading. */
+
+namespace rai {
+
+//===========================================================================
+
+struct BinaryWriter {
+  BinaryWriter(const char* filename, bool append=false);
+  ~BinaryWriter();
+
+  template<class T> void add(const char* name, const rai::Array<T>& x);
+  void addGraph(const char* name, const Graph& G);
+  void flush();
+
+ private:
+  std::ofstream fil;
+  void writeRecord(const char* name, char kind, char type, const uintA& dim, const char* data, uint64_t size);
+};
+
+//===========================================================================
+
+struct BinaryReader {
+  struct Record { String name; char kind, type; uintA dim; uint64_t offset, size; };
+  Array<Record> records; ///< all records in file order (names may repeat, e.g. in appended logs)
+
+  BinaryReader(const char* filename);
+  ~BinaryReader();
+
+  bool exists(const char* name);
+  int find(const char* name); ///< index of the last record of that name, -1 if none
+
+  template<class T> rai::Array<T> read(const char* name, bool ifExists=false);
+  template<class T> rai::Array<T> refer(const char* name);
+  Graph readGraph(const char* name, bool ifExists=false);
+
+  template<class T> rai::Array<T> read(uint i);
+  template<class T> rai::Array<T> refer(uint i);
+  Graph readGraph(uint i);
+  Graph readAll(); ///< all records as nodes of one graph (the format of H5_Reader::G)
+
+ private:
+  const char* data=0;
+  uint64_t size=0;
+};
+
+} //namespace
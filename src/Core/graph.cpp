@@ -12,6 +12,7 @@
 #include <type_traits>
 
 #include <map>
+#include <unordered_set>
 
 #ifdef RAI_JSON
 #  include <json/json.h>
@@ -92,6 +93,7 @@ Node::Node(const std::type_info& _type, Graph& _container, const char* _key)
 }
 
 Node::~Node() {
+  container.resetKeyIndex();
   if(container.isDoubleLinked) while(children.N) children.elem(-1)->removeParent(this);
   if(numChildren) LOG(-2) <<"It is not allowed to delete nodes that still have children";
   while(parents.N) removeParent(parents.elem(-1));
@@ -255,6 +257,14 @@ NodeInitializer::NodeInitializer(const char* key, const char* stringValue) {
 //  Graph methods
 //
 
+/// key -> nodes (in graph order) for the nodes [0,N); it catches up with appended nodes on each query, is dropped when nodes are
+/// deleted, and rebuilt when a returned node turns out inconsistent (e.g. after directly editing a key)
+struct GraphKeyIndex {
+  std::unordered_map<std::string, NodeL> nodes;
+  uint N=0;
+  std::mutex mutex; //lookups are const and may be concurrent
+};
+
 Graph::Graph() : isNodeOfGraph(nullptr), pi(nullptr), ri(nullptr) {
 }
 
@@ -301,6 +311,7 @@ bool Graph::operator!() const {
 void Graph::clear() {
   if(ri) { delete ri; ri=nullptr; }
   if(pi) { delete pi; pi=nullptr; }
+  delete keyIndex.exchange(nullptr);
   DEBUG(checkConsistency();)
   if(!isNodeOfGraph) { //this is not a subgraph; save to delete connections in batch -> faster
     NodeL all = getAllNodesRecursively();
@@ -353,9 +364,50 @@ void Graph::appendDict(const std::map<std::string, std::string>& dict) {
   }
 }
 
+//===========================================================================
+
+static const uint GraphKeyIndex_minNodes = 32; //smaller graphs are scanned linearly
+
+bool Graph::findIndexed(NodeL& ret, const char* key) const {
+  if(N<GraphKeyIndex_minNodes || !key || !isIndexed) return false;
+  Graph& G = const_cast<Graph&>(*this);
+  GraphKeyIndex* idxp = G.keyIndex.load();
+  if(!idxp) { //concurrent first lookups: only one index is installed
+    GraphKeyIndex* fresh = new GraphKeyIndex;
+    if(G.keyIndex.compare_exchange_strong(idxp, fresh)) idxp = fresh;
+    else delete fresh;
+  }
+  GraphKeyIndex& idx = *idxp;
+  std::lock_guard<std::mutex> lock(idx.mutex);
+  for(uint k=0; k<2; k++) {
+    if(idx.N>N) { std::unordered_map<std::string, NodeL>().swap(idx.nodes); idx.N=0; }
+    for(; idx.N<N; idx.N++) { Node* n=elem(idx.N); idx.nodes[n->key.N ? std::string(n->key.p, n->key.N) : std::string()].append(n); }
+    auto it = idx.nodes.find(key);
+    ret.clear();
+    if(it==idx.nodes.end()) return true;
+    bool consistent=true;
+    for(Node* n:it->second) if(n->index>=N || elem(n->index)!=n || !(n->key==key)) { consistent=false; break; }
+    if(consistent) { ret = it->second; return true; }
+    std::unordered_map<std::string, NodeL>().swap(idx.nodes); //rebuild
+    idx.N=0;
+  }
+  HALT("inconsistent key index");
+  return false;
+}
+
+void Graph::resetKeyIndex() {
+  GraphKeyIndex* idx = keyIndex.load();
+  if(!idx) return;
+  std::lock_guard<std::mutex> lock(idx->mutex);
+  if(idx->N) std::unordered_map<std::string, NodeL>().swap(idx->nodes);
+  idx->N=0;
+}
+
 Node* Graph::findNode(const char* key, bool recurseUp, bool recurseDown) const {
 //  for(uint i=N;i--;) if(elem(i)->matches(key)) return elem(i);
-  for(Node* n:(*this)) if(n->key==key) return n;
+  NodeL L;
+  if(findIndexed(L, key)) { if(L.N) return L.elem(0); }
+  else for(Node* n:(*this)) if(n->key==key) return n;
   Node* ret=nullptr;
   if(recurseUp && isNodeOfGraph) ret = isNodeOfGraph->container.findNode(key, true, false);
   if(ret) return ret;
@@ -369,7 +421,9 @@ Node* Graph::findNode(const char* key, bool recurseUp, bool recurseDown) const {
 }
 
 Node* Graph::findNodeOfType(const std::type_info& type, const char* key, bool recurseUp, bool recurseDown) const {
-  for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) return n;
+  NodeL L;
+  if(findIndexed(L, key)) { for(Node* n:L) if(n->type==type) return n; }
+  else for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) return n;
   Node* ret=nullptr;
   if(recurseUp && isNodeOfGraph) ret = isNodeOfGraph->container.findNodeOfType(type, key, true, false);
   if(ret) return ret;
@@ -382,15 +436,16 @@ Node* Graph::findNodeOfType(const std::type_info& type, const char* key, bool re
 
 NodeL Graph::findNodes(const char* key, bool recurseUp, bool recurseDown) const {
   NodeL ret;
-  for(Node* n: (*this)) if(n->key==key) ret.append(n);
+  if(!findIndexed(ret, key)) for(Node* n: (*this)) if(n->key==key) ret.append(n);
   if(recurseUp && isNodeOfGraph) ret.append(isNodeOfGraph->container.findNodes(key, true, false));
   if(recurseDown) for(Node* n: (*this)) if(n->is<Graph>()) ret.append(n->graph().findNodes(key, false, true));
   return ret;
 }
 
 NodeL Graph::findNodesOfType(const std::type_info& type, const char* key, bool recurseUp, bool recurseDown) const {
-  NodeL ret;
-  for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) ret.append(n);
+  NodeL ret, L;
+  if(findIndexed(L, key)) { for(Node* n:L) if(n->type==type) ret.append(n); }
+  else for(Node* n: (*this)) if(n->type==type && (!key || n->key==key)) ret.append(n);
   if(recurseUp && isNodeOfGraph) ret.append(isNodeOfGraph->container.findNodesOfType(type, key, true, false));
   if(recurseDown) for(Node* n: (*this)) if(n->is<Graph>()) ret.append(n->graph().findNodesOfType(type, key, false, true));
   return ret;
@@ -507,6 +562,7 @@ Node* Graph::edit(Node* ed) {
 }
 
 bool Graph::checkUniqueKeys(bool makeUnique) {
+  if(makeUnique) resetKeyIndex();
   for(Node* a: list()) {
     if(makeUnique && !a->key.N) a->key <<'_' <<a->index;
     for(Node* b: list()) {
@@ -660,6 +716,7 @@ void Graph::read(std::istream& is, bool parseInfo) {
           if(elem(i)->is<Graph>()) tmp=elem(i)->graph().find<rai::String>("mimic");
           if(tmp) tmp->prepend(namePrefix);
         }
+        resetKeyIndex();
         namePrefix.clear();
       }
       n->as<FileToken>().cd_base();
@@ -1347,6 +1404,7 @@ void Graph::sortByDotOrder() {
     }
   }
   permuteInv(perm);
+  resetKeyIndex();
   it_COUNT=0;
   for(Node* it: list()) it->index=it_COUNT++;
 }
@@ -1593,6 +1651,35 @@ void initParameters(int _argc, char* _argv[], bool forceReload, bool verbose) {
   if(verbose) {
     LOG(1) <<"** parsed parameters:\n" <<P() <<'\n';
   }
+  parametersChanged();
+}
+
+std::atomic<uint64_t> parametersVersion(0);
+
+void parametersChanged() { parametersVersion++; }
+
+static Mutex usedParametersMutex;
+static StringA usedParameters; //in order of first use
+static std::unordered_set<std::string> usedParametersSet;
+
+void registerUsedParameter(const char* key) {
+  auto lock = usedParametersMutex(RAI_HERE);
+  if(usedParametersSet.insert(key).second) usedParameters.append(String(key));
+}
+
+Graph getUsedParameters() {
+  StringA keys;
+  {
+    auto lock = usedParametersMutex(RAI_HERE);
+    keys = usedParameters;
+  }
+  Graph G;
+  auto P = params();
+  for(const String& k:keys) {
+    Node* n = P->findNode(k);
+    if(n) n->newClone(G);
+  }
+  return G;
 }
 
 rai::String getParamsDump() {
@@ -14,6 +14,7 @@
 #include <math.h>
 #include <map>
 #include <memory>
+#include <atomic>
 
 //===========================================================================
 
@@ -26,6 +27,7 @@ struct ParseInfo;
 struct RenderingInfo;
 struct GraphEditCallback;
 struct BracketOp;
+struct GraphKeyIndex;
 typedef Array<Node*> NodeL;
 typedef Array<GraphEditCallback*> GraphEditCallbackL;
 }
@@ -100,6 +102,7 @@ struct Graph : NodeL {
 
   ArrayG<ParseInfo>* pi;     ///< optional annotation of nodes: when detailed file parsing is enabled
   ArrayG<RenderingInfo>* ri; ///< optional annotation of nodes: dot style commands
+  std::atomic<GraphKeyIndex*> keyIndex{nullptr}; ///< hash index key -> nodes, built on demand by the find methods of large graphs
 
   //-- constructors
   Graph();                                               ///< empty graph
@@ -200,6 +203,8 @@ struct Graph : NodeL {
   //private:
   friend struct Node;
   uint index(bool subKVG=false, uint start=0);
+  bool findIndexed(NodeL& ret, const char* key) const;
+  void resetKeyIndex(); ///< call after changing keys or the order of nodes directly
 
 };
 
@@ -346,6 +351,8 @@ stdOutPipe(RenderingInfo)
 /// global registry of parameters (taken from cmd line or file) as a singleton graph
 Mutex::TypedToken<rai::Graph> params();
 void initParameters(int _argc, char* _argv[], bool forceReload=false, bool verbose=true);
+/// all parameters queried so far (user given or defaults), in order of first use -- written as cfg file, it reproduces the run
+rai::Graph getUsedParameters();
 
 //===========================================================================
 
@@ -12,6 +12,10 @@
 
 #include <H5Cpp.h>
 
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
 namespace rai {
 
 //===========================================================================
@@ -28,8 +32,243 @@ template<> H5::DataType get_h5type<unsigned char>() { return H5::PredType::NATIV
 
 //===========================================================================
 
-H5_Writer::H5_Writer(const char* filename) {
-  file = make_shared<H5::H5File>(filename, H5F_ACC_TRUNC);
+//===========================================================================
+//
+// streamed datasets
+//
+
+struct H5_Stream {
+  String name;
+  H5::DataSet dataset;
+  H5::DataType h5type;
+  const std::type_info* type;
+  uintA frameDim;
+  uint64_t frameBytes, chunkFrames, capacity; //capacity of the queue in frames
+  byteA queue;                                //ring buffer of frames
+  uint64_t head=0, tail=0;                    //frames appended / taken by the writer thread (queue index: modulo capacity)
+  hsize_t written=0;                          //frames in the dataset
+  uint dropped=0;
+};
+
+struct H5_Streams {
+  std::shared_ptr<H5::H5File> file;
+  bool swmr;
+  double flushPeriod=1.;
+  bool blockIfFull=true;
+  std::vector<std::unique_ptr<H5_Stream>> streams;
+
+  std::mutex mutex;
+  std::condition_variable toWriter, toProducers;
+  std::thread thread;
+  bool running=false, stop=false, failed=false;
+  uint64_t flushRequested=0, flushDone=0;
+
+  H5_Streams(const std::shared_ptr<H5::H5File>& file, bool swmr) : file(file), swmr(swmr) {}
+
+  ~H5_Streams() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if(!running) return;
+      stop=true;
+    }
+    toWriter.notify_one();
+    thread.join();
+  }
+
+  void start() { //with the mutex locked
+    if(swmr) {
+      if(H5Fstart_swmr_write(file->getId())<0) HALT("could not start swmr writing -- the file needs to be created with swmr");
+    }
+    running=true;
+    thread = std::thread(&H5_Streams::loop, this);
+  }
+
+  bool append(uint i, const void* p, uint64_t bytes, const std::type_info& type) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if(!running) start();
+    CHECK_LE(i+1, streams.size(), "stream " <<i <<" does not exist");
+    H5_Stream& s = *streams[i];
+    CHECK(type==*s.type, "stream " <<i <<" has type " <<s.type->name() <<", not " <<type.name());
+    CHECK_EQ(bytes, s.frameBytes, "frame size does not match the stream's frameDim " <<s.frameDim);
+    if(!failed && s.head-s.tail==s.capacity) {
+      if(!blockIfFull) { s.dropped++; return false; }
+      toWriter.notify_one();
+      toProducers.wait(lock, [this, &s]() { return failed || s.head-s.tail<s.capacity; });
+    }
+    if(failed) { s.dropped++; return false; } //the file can't be written anymore
+    memcpy(s.queue.p+(s.head%s.capacity)*s.frameBytes, p, bytes);
+    s.head++;
+    if(s.head-s.tail>=s.chunkFrames) toWriter.notify_one();
+    return true;
+  }
+
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if(!running) return;
+    uint64_t request = ++flushRequested;
+    toWriter.notify_one();
+    toProducers.wait(lock, [this, request]() { return flushDone>=request; });
+  }
+
+  bool chunkFull() {
+    for(auto& s:streams) if(s->head-s->tail>=s->chunkFrames) return true;
+    return false;
+  }
+
+  void loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto period = std::chrono::duration<double>(flushPeriod);
+    auto lastFlush = std::chrono::steady_clock::now();
+    bool unflushed=false;
+    for(;;) {
+      toWriter.wait_for(lock, period, [this]() { return stop || flushRequested>flushDone || chunkFull(); });
+      uint64_t request = flushRequested;
+      bool all = stop || request>flushDone || std::chrono::steady_clock::now()-lastFlush>=period;
+      //-- write queued frames: only whole chunks, unless flushing
+      bool wrote=false;
+      for(auto& s:streams) {
+        uint64_t n = s->head-s->tail;
+        if(!all) n -= n%s->chunkFrames;
+        if(!n) continue;
+        uint64_t from = s->tail;
+        lock.unlock(); //producers may append meanwhile -- they only write beyond head
+        bool ok = write(*s, from, n);
+        lock.lock();
+        if(!ok) { failed=true; s->dropped += n; }
+        s->tail += n;
+        wrote=true;
+        toProducers.notify_all();
+      }
+      if(all) {
+        if(wrote || unflushed) {
+          lock.unlock();
+          bool ok = flushFile();
+          lock.lock();
+          if(!ok) failed=true;
+          unflushed=false;
+        }
+        lastFlush = std::chrono::steady_clock::now();
+        flushDone = request;
+        toProducers.notify_all();
+        if(stop) break;
+      } else if(wrote) unflushed=true;
+    }
+  }
+
+  //on the writer thread; failed is only set by this thread, so it may be read here without the lock
+  bool write(H5_Stream& s, uint64_t from, uint64_t n) {
+    if(failed) return false;
+    try {
+      //the queue is a ring: at most two contiguous pieces
+      uint64_t i = from%s.capacity;
+      uint64_t k = std::min(n, s.capacity-i);
+      writeFrames(s, s.queue.p+i*s.frameBytes, k);
+      if(k<n) writeFrames(s, s.queue.p, n-k);
+    } catch(const H5::Exception& e) {
+      LOG(-1) <<"writing stream failed: " <<e.getDetailMsg() <<" -- dropping all further frames";
+      return false;
+    }
+    return true;
+  }
+
+  bool flushFile() {
+    if(failed) return false;
+    try {
+      file->flush(H5F_SCOPE_LOCAL); //makes the frames visible to swmr readers
+    } catch(const H5::Exception& e) {
+      LOG(-1) <<"flushing streams failed: " <<e.getDetailMsg() <<" -- dropping all further frames";
+      return false;
+    }
+    return true;
+  }
+
+  void writeFrames(H5_Stream& s, const byte* p, uint64_t k) {
+    uint nd = s.frameDim.N+1;
+    std::vector<hsize_t> size(nd), start(nd, 0), count(nd);
+    size[0] = s.written+k;
+    start[0] = s.written;
+    count[0] = k;
+    for(uint j=1; j<nd; j++) size[j] = count[j] = s.frameDim(j-1);
+    s.dataset.extend(size.data());
+    H5::DataSpace fileSpace = s.dataset.getSpace();
+    fileSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data());
+    H5::DataSpace memSpace(nd, count.data());
+    s.dataset.write(p, s.h5type, memSpace, fileSpace);
+    s.written += k;
+  }
+};
+
+//===========================================================================
+
+H5_Writer::H5_Writer(const char* filename, bool swmr) {
+  if(swmr) {
+    H5::FileAccPropList fapl;
+    fapl.setLibverBounds(H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    file = make_shared<H5::H5File>(filename, H5F_ACC_TRUNC, H5::FileCreatPropList::DEFAULT, fapl);
+  } else {
+    file = make_shared<H5::H5File>(filename, H5F_ACC_TRUNC);
+  }
+  streams = make_shared<H5_Streams>(file, swmr);
+}
+
+H5_Writer::~H5_Writer() {
+  streams.reset(); //writes all queued frames, before the file closes
+}
+
+template<class T> uint H5_Writer::addStream(const char* name, const uintA& frameDim) {
+  CHECK(!streams->running, "all datasets need to be added before the first append");
+  CHECK_GE(opt.queueChunks, 1, "");
+  auto s = make_unique<H5_Stream>();
+  s->name = name;
+  s->h5type = get_h5type<T>();
+  s->type = &typeid(T);
+  s->frameDim = frameDim;
+  s->frameBytes = sizeof(T);
+  for(uint d:frameDim) s->frameBytes *= d;
+  CHECK_GE(s->frameBytes, 1, "empty frames");
+  s->chunkFrames = std::max<uint64_t>(1, opt.chunkBytes/s->frameBytes);
+  s->capacity = opt.queueChunks*s->chunkFrames;
+  s->queue.resize(s->capacity*s->frameBytes);
+
+  uint nd = frameDim.N+1;
+  std::vector<hsize_t> dim(nd), maxDim(nd), chunk(nd);
+  dim[0] = 0;
+  maxDim[0] = H5S_UNLIMITED;
+  chunk[0] = s->chunkFrames;
+  for(uint j=1; j<nd; j++) dim[j] = maxDim[j] = chunk[j] = frameDim(j-1);
+  H5::DataSpace dataspace(nd, dim.data(), maxDim.data());
+  H5::DSetCreatPropList props;
+  props.setChunk(nd, chunk.data());
+  if(opt.compression>0) { props.setShuffle(); props.setDeflate(opt.compression); }
+  s->dataset = file->createDataSet(name, s->h5type, dataspace, props);
+
+  streams->flushPeriod = opt.flushPeriod;
+  streams->blockIfFull = opt.blockIfFull;
+  streams->streams.push_back(std::move(s));
+  return streams->streams.size()-1;
+}
+
+template<class T> bool H5_Writer::append(uint stream, const rai::Array<T>& frame) {
+  return streams->append(stream, frame.p, frame.N*sizeof(T), typeid(T));
+}
+
+template<class T> bool H5_Writer::append(const char* name, const rai::Array<T>& frame) {
+  for(uint i=0; i<streams->streams.size(); i++) {
+    if(streams->streams[i]->name==name) return append(i, frame);
+  }
+  HALT("stream '" <<name <<"' does not exist");
+  return false;
+}
+
+void H5_Writer::flush() {
+  streams->flush();
+}
+
+uint H5_Writer::dropped() {
+  std::lock_guard<std::mutex> lock(streams->mutex);
+  uint n=0;
+  for(auto& s:streams->streams) n += s->dropped;
+  return n;
 }
 
 void H5_Writer::addDict(const char* name, const Graph& dict){
@@ -41,10 +280,12 @@ void H5_Writer::addDict(const char* name, const Graph& dict){
 }
 
 void H5_Writer::addGroup(const char* group) {
+  CHECK(!streams->running, "all datasets need to be added before the first append");
   file->createGroup(group);
 }
 
 template<class T> void H5_Writer::add(const char* name, const rai::Array<T>& x) {
+  CHECK(!streams->running, "all datasets need to be added before the first append");
   rai::Array<hsize_t> dim = rai::convert<hsize_t>(x.dim());
   if(!dim.N) dim = {0};
   H5::DataSpace dataspace(dim.N, dim.p);
@@ -55,9 +296,9 @@ template<class T> void H5_Writer::add(const char* name, const rai::Array<T>& x)
 
 //===========================================================================
 
-H5_Reader::H5_Reader(const char* filename) {
+H5_Reader::H5_Reader(const char* filename, bool swmr) : swmr(swmr) {
   CHECK(FileToken(filename).exists(), "file '" <<filename <<"' does not exist");
-  file = make_shared<H5::H5File>(filename, H5F_ACC_RDONLY);
+  file = make_shared<H5::H5File>(filename, swmr ? H5F_ACC_RDONLY|H5F_ACC_SWMR_READ : H5F_ACC_RDONLY);
 }
 
 uintA get_dim(H5::DataSet& dataset) {
@@ -74,6 +315,7 @@ bool H5_Reader::exists(const char* name) {
 template<class T> rai::Array<T> H5_Reader::read(const char* name, bool ifExists) {
   if(ifExists && !exists(name)) return {};
   H5::DataSet dataset = file->openDataSet(name);
+  if(swmr) H5Drefresh(dataset.getId()); //the dataset might be growing
   rai::Array<T> x;
   x.resize(get_dim(dataset));
   dataset.read(x.p, get_h5type<T>());
@@ -135,10 +377,17 @@ void H5_Reader::readAll() {
 
 #else
 
-H5_Writer::H5_Writer(const char* filename) { NICO }
+struct H5_Streams {};
+H5_Writer::H5_Writer(const char* filename, bool swmr) { NICO }
+H5_Writer::~H5_Writer() {}
 void H5_Writer::addGroup(const char* group) { NICO }
 template<class T> void H5_Writer::add(const char* name, const rai::Array<T>& x) { NICO }
-H5_Reader::H5_Reader(const char* filename) { NICO }
+template<class T> uint H5_Writer::addStream(const char* name, const uintA& frameDim) { NICO }
+template<class T> bool H5_Writer::append(uint stream, const rai::Array<T>& frame) { NICO }
+template<class T> bool H5_Writer::append(const char* name, const rai::Array<T>& frame) { NICO }
+void H5_Writer::flush() { NICO }
+uint H5_Writer::dropped() { NICO }
+H5_Reader::H5_Reader(const char* filename, bool swmr) { NICO }
 template<class T> rai::Array<T> H5_Reader::read(const char* name, bool ifExists) { NICO }
 bool H5_Reader::exists(const char* name) { NICO }
 
@@ -154,6 +403,33 @@ template void H5_Writer::add<uint16_t>(const char* name, const rai::Array<uint16
 template void H5_Writer::add<char>(const char* name, const rai::Array<char>& x);
 template void H5_Writer::add<unsigned char>(const char* name, const rai::Array<unsigned char>& x);
 
+template uint H5_Writer::addStream<double>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<float>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<int>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<uint>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<int16_t>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<uint16_t>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<char>(const char* name, const uintA& frameDim);
+template uint H5_Writer::addStream<unsigned char>(const char* name, const uintA& frameDim);
+
+template bool H5_Writer::append<double>(uint stream, const rai::Array<double>& frame);
+template bool H5_Writer::append<float>(uint stream, const rai::Array<float>& frame);
+template bool H5_Writer::append<int>(uint stream, const rai::Array<int>& frame);
+template bool H5_Writer::append<uint>(uint stream, const rai::Array<uint>& frame);
+template bool H5_Writer::append<int16_t>(uint stream, const rai::Array<int16_t>& frame);
+template bool H5_Writer::append<uint16_t>(uint stream, const rai::Array<uint16_t>& frame);
+template bool H5_Writer::append<char>(uint stream, const rai::Array<char>& frame);
+template bool H5_Writer::append<unsigned char>(uint stream, const rai::Array<unsigned char>& frame);
+
+template bool H5_Writer::append<double>(const char* name, const rai::Array<double>& frame);
+template bool H5_Writer::append<float>(const char* name, const rai::Array<float>& frame);
+template bool H5_Writer::append<int>(const char* name, const rai::Array<int>& frame);
+template bool H5_Writer::append<uint>(const char* name, const rai::Array<uint>& frame);
+template bool H5_Writer::append<int16_t>(const char* name, const rai::Array<int16_t>& frame);
+template bool H5_Writer::append<uint16_t>(const char* name, const rai::Array<uint16_t>& frame);
+template bool H5_Writer::append<char>(const char* name, const rai::Array<char>& frame);
+template bool H5_Writer::append<unsigned char>(const char* name, const rai::Array<unsigned char>& frame);
+
 template rai::Array<double> H5_Reader::read<double>(const char* name, bool ifExists);
 template rai::Array<float> H5_Reader::read<float>(const char* name, bool ifExists);
 template rai::Array<int> H5_Reader::read<int>(const char* name, bool ifExists);
@@ -17,14 +17,40 @@ namespace rai {
 
 //===========================================================================
 
+struct H5_Writer_Options {
+  RAI_PARAM("h5/", int, chunkBytes, 1<<20) //target size of the chunks of streamed datasets (rounded to whole frames)
+  RAI_PARAM("h5/", int, compression, 4) //deflate level of streamed datasets; 0: uncompressed
+  RAI_PARAM("h5/", int, queueChunks, 4) //per stream, the queue to the writer thread holds that many chunks
+  RAI_PARAM("h5/", double, flushPeriod, 1.) //partially filled chunks are written (and visible to readers) at least that often
+  RAI_PARAM("h5/", bool, blockIfFull, true) //when a queue is full: wait; otherwise drop the frame (counted in dropped())
+};
+
+struct H5_Streams;
+
+/** Writes datasets in one shot (add), or streams frames: addStream declares an extendible, chunked (and compressed)
+ *  dataset of dimension {frames, frameDim}; append copies a frame into the stream's preallocated queue, which a
+ *  background thread writes in whole chunks -- so appending costs a copy and never waits for the file (unless the
+ *  queue is full), and memory is fixed to queueChunks*chunkBytes per stream.
+ *  With swmr, the file is written in HDF5's single-writer/multiple-reader mode: H5_Reader(filename, true) can read it
+ *  while it grows. All datasets have to be added before the first append; from then on, the file is only accessed by
+ *  the writer thread (other HDF5 use in parallel requires a thread safe HDF5 build). */
 struct H5_Writer {
   std::shared_ptr<H5::H5File> file;
+  std::shared_ptr<H5_Streams> streams;
+  H5_Writer_Options opt;
 
-  H5_Writer(const char* filename);
+  H5_Writer(const char* filename, bool swmr=false);
+  ~H5_Writer();
 
   template<class T> void add(const char* name, const rai::Array<T>& x);
   void addDict(const char* name, const Graph& dict);
   void addGroup(const char* group);
+
+  template<class T> uint addStream(const char* name, const uintA& frameDim); ///< returns the stream id
+  template<class T> bool append(uint stream, const rai::Array<T>& frame);    ///< false if the frame was dropped (queue full, or the file failed)
+  template<class T> bool append(const char* name, const rai::Array<T>& frame);
+  void flush(); ///< blocks until all queued frames are written
+  uint dropped(); ///< number of frames lost so far: dropped on a full queue (without blockIfFull), or not written after a file error
 };
 
 //===========================================================================
@@ -32,9 +58,10 @@ struct H5_Writer {
 struct H5_Reader {
   std::shared_ptr<H5::H5File> file;
   int verbose=0;
+  bool swmr=false;
   Graph G;
 
-  H5_Reader(const char* filename);
+  H5_Reader(const char* filename, bool swmr=false); ///< swmr: read a file while it is streamed
   void readAll();
   template<class T> rai::Array<T> read(const char* name, bool ifExists=false);
   Graph readDict(const char* name, bool ifExists=false);
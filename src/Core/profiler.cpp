@@ -0,0 +1,326 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#include "profiler.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <unistd.h>
+
+namespace rai {
+
+//===========================================================================
+
+//-- per-thread buffers: written only by their thread, without locks; readers (report, traces) use the atomics
+
+struct ProfileNode {
+  const char* name="";
+  int parent=-1, nextSibling=-1;
+  std::atomic<int> firstChild{-1};
+  std::atomic<uint64_t> calls{0}, time{0};
+};
+
+struct ProfileEvent {
+  std::atomic<const char*> name{""};
+  std::atomic<uint64_t> start{0}, duration{0};
+};
+
+struct ProfileThread {
+  static const int chunkBits=10, chunkSize=1<<chunkBits, maxChunks=256; //nodes are never moved
+  uint id;
+  std::unique_ptr<ProfileNode[]> chunks[maxChunks];
+  std::atomic<int> size{0}; //published nodes
+  int current=0;
+  std::unique_ptr<ProfileEvent[]> ring;
+  uint64_t ringSize;
+  std::atomic<uint64_t> events{0}, cleared{0}; //events before 'cleared' are not exported
+
+  ProfileThread(uint id, uint bufferSize) : id(id), ringSize(bufferSize) {
+    chunks[0].reset(new ProfileNode[chunkSize]);
+    size.store(1, std::memory_order_release);
+    if(ringSize) ring.reset(new ProfileEvent[ringSize]);
+  }
+
+  ProfileNode& operator[](int i) const { return chunks[i>>chunkBits][i&(chunkSize-1)]; }
+
+  int child(const char* name) {
+    ProfileNode& p = (*this)[current];
+    int i = p.firstChild.load(std::memory_order_relaxed);
+    for(; i>=0; i=(*this)[i].nextSibling) {
+      if((*this)[i].name==name || !strcmp((*this)[i].name, name)) return i;
+    }
+    i = size.load(std::memory_order_relaxed);
+    CHECK_LE((i>>chunkBits), maxChunks-1, "too many profile zones (distinct paths) in one thread");
+    if(!(i&(chunkSize-1))) chunks[i>>chunkBits].reset(new ProfileNode[chunkSize]);
+    ProfileNode& n = (*this)[i];
+    n.name = name;
+    n.parent = current;
+    n.nextSibling = p.firstChild.load(std::memory_order_relaxed);
+    size.store(i+1, std::memory_order_release);
+    p.firstChild.store(i, std::memory_order_release);
+    return i;
+  }
+
+  void record(ProfileNode& n, uint64_t start, uint64_t duration) {
+    n.calls.store(n.calls.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+    n.time.store(n.time.load(std::memory_order_relaxed)+duration, std::memory_order_relaxed);
+    if(!ringSize) return;
+    uint64_t e = events.load(std::memory_order_relaxed);
+    ProfileEvent& r = ring[e%ringSize];
+    r.name.store(n.name, std::memory_order_relaxed);
+    r.start.store(start, std::memory_order_relaxed);
+    r.duration.store(duration, std::memory_order_relaxed);
+    events.store(e+1, std::memory_order_release);
+  }
+};
+
+struct ProfileTraceEvent {
+  const char* name;
+  uint64_t start, duration;
+  uint tid;
+};
+
+/// copies the events still in the ring; entries that the thread overwrote meanwhile are dropped
+static void profiler_copyEvents(const ProfileThread& t, std::vector<ProfileTraceEvent>& out) {
+  uint64_t n = t.ringSize;
+  if(!n) return;
+  uint64_t to = t.events.load(std::memory_order_acquire);
+  uint64_t from = std::max<uint64_t>(to>n ? to-n : 0, t.cleared.load(std::memory_order_relaxed));
+  size_t first = out.size();
+  for(uint64_t i=from; i<to; i++) {
+    const ProfileEvent& e = t.ring[i%n];
+    out.push_back({e.name.load(std::memory_order_relaxed), e.start.load(std::memory_order_relaxed), e.duration.load(std::memory_order_relaxed), t.id});
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t now = t.events.load(std::memory_order_relaxed);
+  uint64_t valid = now>=n ? now-n+1 : 0; //the thread may be writing event 'now', overwriting now-n
+  if(valid>from) out.erase(out.begin()+first, out.begin()+first+std::min(valid-from, to-from));
+}
+
+//-- merging call trees
+
+struct ProfileSum {
+  std::string name;
+  uint64_t calls=0, time=0;
+  std::vector<ProfileSum> children;
+
+  ProfileSum& child(const char* key) {
+    for(ProfileSum& x:children) if(x.name==key) return x;
+    children.emplace_back();
+    children.back().name=key;
+    return children.back();
+  }
+
+  void add(const ProfileThread& t, int i) {
+    calls += t[i].calls.load(std::memory_order_relaxed);
+    time += t[i].time.load(std::memory_order_relaxed);
+    for(int c=t[i].firstChild.load(std::memory_order_acquire); c>=0; c=t[c].nextSibling) child(t[c].name).add(t, c);
+  }
+
+  void add(const ProfileSum& s) {
+    calls += s.calls;
+    time += s.time;
+    for(const ProfileSum& c:s.children) child(c.name.c_str()).add(c);
+  }
+
+  void clear() {
+    calls=time=0;
+    for(ProfileSum& c:children) c.clear();
+  }
+
+  void write(std::ostream& os, uint depth, uint64_t parentTime, double minFraction) {
+    //children in order of decreasing time
+    std::sort(children.begin(), children.end(), [](const ProfileSum& a, const ProfileSum& b) { return a.time>b.time; });
+    for(ProfileSum& c:children) {
+      if(!c.calls) continue;
+      double fraction = parentTime ? double(c.time)/double(parentTime) : 1.;
+      if(fraction<minFraction) continue;
+      uint64_t childTime=0;
+      for(ProfileSum& cc:c.children) childTime += cc.time;
+      String label;
+      for(uint d=0; d<depth; d++) label <<"  ";
+      label <<c.name;
+      os <<std::left <<std::setw(48) <<label.p <<std::right
+         <<" calls: " <<std::setw(8) <<c.calls
+         <<" total: " <<std::setw(10) <<1e-6*c.time <<"ms"
+         <<" self: " <<std::setw(10) <<1e-6*(c.time-childTime) <<"ms"
+         <<" (" <<std::setw(5) <<std::setprecision(3) <<100.*fraction <<"%)" <<std::setprecision(6) <<endl;
+      c.write(os, depth+1, c.time, minFraction);
+    }
+  }
+
+  double find(const char* key) {
+    double t = (name==key) ? 1e-9*time : 0.;
+    for(ProfileSum& c:children) t += c.find(key);
+    return t;
+  }
+};
+
+/// what remains of exited threads
+struct Profiler::Retired {
+  ProfileSum tree;
+  std::vector<ProfileTraceEvent> events;
+  uint threads=0;
+};
+
+//===========================================================================
+
+#ifndef RAI_NO_PROFILER
+
+uint64_t ProfileZone::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::atomic<bool> ProfileZone::isEnabled(false);
+
+namespace {
+/// hands the thread's buffers back to the profiler when the thread exits
+struct ProfileThreadHandle {
+  ProfileThread* thread=nullptr;
+  ~ProfileThreadHandle() { if(thread) profiler().retire(thread); }
+};
+}
+
+void ProfileZone::begin(const char* name) {
+  thread_local ProfileThreadHandle handle;
+  if(!handle.thread) handle.thread = profiler().thisThread();
+  thread = handle.thread;
+  node = thread->current = thread->child(name);
+  start = now();
+}
+
+void ProfileZone::end() {
+  if(!thread && !counter) return;
+  uint64_t duration = now()-start;
+  if(counter) { *counter += 1e-9*duration; counter=nullptr; }
+  if(!thread) return;
+  ProfileThread* th = thread;
+  thread = nullptr;
+  ProfileNode& n = (*th)[node];
+  CHECK_EQ(th->current, node, "profile zone '" <<n.name <<"' ends while a zone begun after it is still open -- zones must end in reverse order");
+  th->record(n, start, duration);
+  th->current = n.parent;
+}
+
+#endif
+
+//===========================================================================
+
+Profiler::Profiler() : retired(new Retired) {
+#ifndef RAI_NO_PROFILER
+  if(opt.enabled) ProfileZone::isEnabled = true;
+#endif
+}
+
+Profiler::~Profiler() {
+  if(opt.traceFile.N) writeChromeTrace(opt.traceFile);
+}
+
+void Profiler::enable(bool on) {
+#ifndef RAI_NO_PROFILER
+  ProfileZone::isEnabled = on;
+#else
+  if(on) LOG(-1) <<"compiled with RAI_NO_PROFILER -- no zones are recorded";
+#endif
+}
+
+bool Profiler::enabled() const {
+#ifndef RAI_NO_PROFILER
+  return ProfileZone::isEnabled;
+#else
+  return false;
+#endif
+}
+
+ProfileThread* Profiler::thisThread() {
+  std::lock_guard<std::mutex> lock(mutex);
+  threads.emplace_back(new ProfileThread(threads.size()+retired->threads, rai::MAX(opt.bufferSize, 0)));
+  return threads.back().get();
+}
+
+void Profiler::retire(ProfileThread* thread) {
+  std::lock_guard<std::mutex> lock(mutex);
+  retired->tree.add(*thread, 0);
+  profiler_copyEvents(*thread, retired->events);
+  size_t n = std::max(opt.bufferSize, 0);
+  if(retired->events.size()>n) retired->events.erase(retired->events.begin(), retired->events.end()-n);
+  retired->threads++;
+  for(uint i=0; i<threads.size(); i++) if(threads[i].get()==thread) { threads.erase(threads.begin()+i); break; }
+}
+
+uint Profiler::liveThreads() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return threads.size();
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for(auto& t:threads) {
+    int n = t->size.load(std::memory_order_acquire);
+    for(int i=0; i<n; i++) { (*t)[i].calls=0; (*t)[i].time=0; } //(races with a running zone at most lose that zone)
+    t->cleared = t->events.load();
+  }
+  retired->tree.clear();
+  retired->events.clear();
+}
+
+void Profiler::report(std::ostream& os, double minFraction) {
+  ProfileSum root;
+  uint nThreads;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& t:threads) root.add(*t, 0);
+    root.add(retired->tree);
+    nThreads = threads.size()+retired->threads;
+  }
+  root.time=0;
+  for(ProfileSum& c:root.children) root.time += c.time;
+  os <<"Profiler: " <<nThreads <<" threads, " <<1e-6*root.time <<"ms in zones" <<endl;
+  root.write(os, 0, root.time, minFraction);
+}
+
+double Profiler::time(const char* name) {
+  ProfileSum root;
+  std::lock_guard<std::mutex> lock(mutex);
+  for(auto& t:threads) root.add(*t, 0);
+  root.add(retired->tree);
+  return root.find(name);
+}
+
+void Profiler::writeChromeTrace(const char* filename) {
+  std::vector<ProfileTraceEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    events = retired->events;
+    for(auto& t:threads) profiler_copyEvents(*t, events);
+  }
+  std::ofstream fil(filename);
+  if(!fil.good()) { cerr <<"could not open trace file '" <<filename <<"'" <<endl; return; }
+  fil <<"{\"traceEvents\":[";
+  bool first=true;
+  int pid = getpid();
+  for(const ProfileTraceEvent& e:events) {
+    if(!first) fil <<',';
+    first=false;
+    fil <<"\n{\"name\":\"";
+    for(const char* c=e.name; *c; c++) { if(*c=='"' || *c=='\\') fil <<'\\'; fil <<*c; }
+    fil <<"\",\"ph\":\"X\",\"ts\":" <<std::fixed <<std::setprecision(3) <<1e-3*e.start
+        <<",\"dur\":" <<1e-3*e.duration <<",\"pid\":" <<pid <<",\"tid\":" <<e.tid <<'}';
+  }
+  fil <<"\n],\"displayTimeUnit\":\"ms\"}" <<endl;
+}
+
+Profiler& profiler() {
+  static Profiler P;
+  return P;
+}
+
+} //namespace
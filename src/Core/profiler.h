@@ -0,0 +1,116 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#pragma once
+
+#include "util.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+
+/* Scoped profiling zones:
+ *
+ *   { RAI_PROFILE("KOMO::set_x"); ... }                        //zone until the end of the scope
+ *   rai::ProfileZone zone("features"); ... zone.end();         //or explicitly ended
+ *
+ * Zones nest; each thread aggregates them into a call tree (calls and total time per path) and records the completed
+ * zones in a ring buffer, which can be exported as Chrome trace (chrome://tracing, ui.perfetto.dev). Recording is off
+ * by default, costing a single branch per zone: enable with profiler().enable() or the parameter profiler/enabled (read
+ * when the profiler is created, which initCmdLine does). Compiling with RAI_NO_PROFILER removes all zones.
+ *
+ *   rai::ProfileZone zone("KOMO features", komo.timeFeatures); //also adds its seconds to a counter (even if disabled)
+ *
+ * Recording takes no locks: each thread writes only its own buffers, which readers (report, traces) access via atomics.
+ * When a thread exits, its call tree and trace are merged into the profiler and its buffers are freed. */
+
+namespace rai {
+
+struct Profiler_Options {
+  RAI_PARAM("profiler/", bool, enabled, false)
+  RAI_PARAM("profiler/", int, bufferSize, 1<<14) //completed zones kept per thread for traces; 0: aggregate only
+  RAI_PARAM("profiler/", rai::String, traceFile, "") //if set, the trace is written there at exit
+};
+
+//===========================================================================
+
+struct ProfileThread; //per-thread call tree and ring buffer
+
+#ifndef RAI_NO_PROFILER
+
+struct ProfileZone {
+  ProfileThread* thread=nullptr;
+  double* counter=nullptr;
+  int node;
+  uint64_t start;
+  ProfileZone(const char* name) { if(isEnabled.load(std::memory_order_relaxed)) begin(name); }
+  ProfileZone(const char* name, double& _counter) : counter(&_counter) { if(isEnabled.load(std::memory_order_relaxed)) begin(name); else start=now(); }
+  ~ProfileZone() { if(thread || counter) end(); }
+  void end();
+
+  static std::atomic<bool> isEnabled;
+  static uint64_t now(); ///< in nanoseconds
+ private:
+  void begin(const char* name);
+};
+
+#define RAI_PROFILE_CAT2(a, b) a##b
+#define RAI_PROFILE_CAT(a, b) RAI_PROFILE_CAT2(a, b)
+#define RAI_PROFILE(name) rai::ProfileZone RAI_PROFILE_CAT(__profileZone, __LINE__)(name)
+
+#else
+
+struct ProfileZone {
+  double* counter=nullptr;
+  double start=0.;
+  ProfileZone(const char* name) {}
+  ProfileZone(const char* name, double& _counter) : counter(&_counter), start(realTime()) {}
+  ~ProfileZone() { end(); }
+  void end() { if(counter) { *counter += realTime()-start; counter=nullptr; } }
+};
+
+#define RAI_PROFILE(name)
+
+#endif
+
+//===========================================================================
+
+/// collects the zones of all threads
+struct Profiler {
+  Profiler_Options opt;
+
+  Profiler();
+  ~Profiler();
+
+  void enable(bool on=true);
+  bool enabled() const;
+  void clear(); ///< reset all counts and traces (the call trees of open zones remain valid)
+
+  /// the call tree merged over all threads: calls, total and self time (in msec) per zone, and the fraction of its parent
+  void report(std::ostream& os=std::cout, double minFraction=0.);
+  /// all recorded zones as Chrome trace json (chrome://tracing, ui.perfetto.dev)
+  void writeChromeTrace(const char* filename);
+  /// total seconds spent in all zones of this name (over all threads and paths)
+  double time(const char* name);
+
+  ProfileThread* thisThread();
+  void retire(ProfileThread* thread); ///< (at thread exit) merges the thread's call tree and trace, and frees its buffers
+  uint liveThreads(); ///< number of threads with buffers
+
+ private:
+  struct Retired;
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ProfileThread>> threads;
+  std::unique_ptr<Retired> retired;
+};
+
+/// the process-wide profiler
+Profiler& profiler();
+
+} //namespace
@@ -542,6 +542,79 @@ void Thread::main() {
   event.setStatus(tsIsClosed);
 }
 
+//===========================================================================
+//
+// ThreadPool
+//
+
+ThreadPool::ThreadPool(uint nThreads) {
+  if(!nThreads) nThreads = std::thread::hardware_concurrency();
+  if(!nThreads) nThreads = 1;
+  for(uint i=0; i<nThreads; i++) workers.emplace_back(&ThreadPool::workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    auto lock = jobsMutex(RAI_HERE);
+    stop=true;
+  }
+  jobAdded.notify_all();
+  for(std::thread& th:workers) th.join();
+}
+
+void ThreadPool::add(const Job& job) {
+  {
+    auto lock = jobsMutex(RAI_HERE);
+    CHECK(!stop, "pool is stopping");
+    jobs.push_back(job);
+  }
+  jobAdded.notify_one();
+}
+
+void ThreadPool::waitForAll() {
+  auto lock = jobsMutex(RAI_HERE);
+  jobDone.wait(lock, [this]() { return jobs.empty() && !busy; });
+  if(error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void ThreadPool::workerMain(uint worker) {
+  for(;;) {
+    Job job;
+    {
+      auto lock = jobsMutex(RAI_HERE);
+      jobAdded.wait(lock, [this]() { return stop || !jobs.empty(); });
+      if(jobs.empty()) return; //stop and nothing left to do
+      job = std::move(jobs.front());
+      jobs.pop_front();
+      busy++;
+    }
+    try {
+      job(worker);
+    } catch(...) {
+      auto lock = jobsMutex(RAI_HERE);
+      if(!error) error = std::current_exception();
+    }
+    {
+      auto lock = jobsMutex(RAI_HERE);
+      busy--;
+    }
+    jobDone.notify_all();
+  }
+}
+
+void parallelFor(uint n, const std::function<void(uint i, uint worker)>& f, uint nThreads) {
+  if(!nThreads) nThreads = std::thread::hardware_concurrency();
+  if(nThreads>n) nThreads=n;
+  if(nThreads<=1) { for(uint i=0; i<n; i++) f(i, 0); return; }
+  ThreadPool pool(nThreads);
+  for(uint i=0; i<n; i++) pool.add([&f, i](uint worker) { f(i, worker); });
+  pool.waitForAll();
+}
+
 //===========================================================================
 //
 // controlling threads
@@ -15,6 +15,8 @@
 #include <shared_mutex>
 #include <condition_variable>
 #include <thread>
+#include <deque>
+#include <atomic>
 
 enum ThreadState { tsIsClosed=-6, tsToOpen=-1, tsLOOPING=-2, tsBEATING=-3, tsIDLE=0, tsToStep=1, tsToClose=-4,  tsFAILURE=-5,  }; //positive states indicate steps-to-go
 struct Signaler;
@@ -222,6 +224,102 @@ struct Var {
 
 template<class T> std::ostream& operator<<(std::ostream& os, Var<T>& x) { x.write(os); return os; }
 
+//===========================================================================
+//
+// lock-free single-producer/multi-consumer variables
+//
+
+/** The shared data of a LockFreeVar: a small pool of slots, each holding a full copy of T. The writer fills a free
+ *  slot and publishes it by a single atomic exchange; a reader pins the latest slot by a single fetch_add on the
+ *  packed (slot, pin count) word -- readers never block or retry. Pins are transferred to the slot's reference
+ *  count on the next publish, and the writer only reuses slots with zero references. With 1 concurrent reader this
+ *  is a triple buffer; in general maxReaders+2 slots are needed for the writer never to wait. */
+template<class T>
+struct LockFreeVar_data : NonCopyable {
+  struct Slot {
+    T data;
+    int revision=0;
+    double data_time=0.;
+    std::atomic<int64_t> refs{0};  ///< readers holding this slot (may transiently be negative for the current slot)
+  };
+  static constexpr uint64_t countBits=48;
+
+  std::unique_ptr<Slot[]> slots;
+  uint nSlots;
+  std::atomic<uint64_t> current{0}; ///< (slot index<<countBits) | number of readers that pinned it
+  std::atomic<int> revision{0};
+  uint writeSlot=0;                 ///< slot currently written (writer only)
+  rai::String name;
+
+  //-- only for blocking waits (never touched in get/set unless someone waits)
+  std::atomic<int> waiters{0};
+  Mutex waitMutex;
+  std::condition_variable waitCond;
+
+  LockFreeVar_data(uint maxReaders=1, const char* _name=0) : slots(new Slot[maxReaders+2]), nSlots(maxReaders+2), name(_name) {}
+
+  uint pin() { return uint(current.fetch_add(1, std::memory_order_acquire)>>countBits); }
+  void unpin(uint s) { slots[s].refs.fetch_sub(1, std::memory_order_release); }
+  T& beginWrite();
+  void publish(double dataTime);
+};
+
+template<class T>
+struct LockFreeVar_RToken {
+  LockFreeVar_data<T>* var;
+  uint slot;
+  LockFreeVar_RToken(LockFreeVar_data<T>& _var, int* getRevision=nullptr) : var(&_var), slot(_var.pin()) {
+    if(getRevision) *getRevision=var->slots[slot].revision;
+  }
+  LockFreeVar_RToken(LockFreeVar_RToken&& t) : var(t.var), slot(t.slot) { t.var=nullptr; }
+  ~LockFreeVar_RToken() { if(var) var->unpin(slot); }
+  const T* operator->() { return &var->slots[slot].data; }
+  operator const T& () { return var->slots[slot].data; }
+  const T& operator()() { return var->slots[slot].data; }
+  int revision() const { return var->slots[slot].revision; }
+  double dataTime() const { return var->slots[slot].data_time; }
+};
+
+template<class T>
+struct LockFreeVar_WToken {
+  LockFreeVar_data<T>* var;
+  T* data;
+  double dataTime;
+  LockFreeVar_WToken(LockFreeVar_data<T>& _var, double _dataTime=0.) : var(&_var), data(&_var.beginWrite()), dataTime(_dataTime) {}
+  LockFreeVar_WToken(LockFreeVar_WToken&& t) : var(t.var), data(t.data), dataTime(t.dataTime) { t.var=nullptr; }
+  ~LockFreeVar_WToken() { if(var) var->publish(dataTime); }
+  void operator=(const T& y) { *data=y; }
+  T* operator->() { return data; }
+  operator T& () { return *data; }
+  T& operator()() { return *data; }
+};
+
+/** A variable for high-rate messages (control commands/states, sensor frames) with one writer thread and several reader
+ *  threads. Same usage and revision semantics as Var, but get() and set() never lock: readers are wait-free (they
+ *  access the latest published revision while the writer fills another slot), the writer only waits if more than
+ *  maxReaders readers hold tokens at the same time. Note: set() gives access to a slot holding an *older* revision,
+ *  which has to be overwritten completely; tokens should be held briefly. There are no callbacks and no Thread
+ *  listening -- use waitForNextRevision (which blocks on a condition variable only while waiting). */
+template<class T>
+struct LockFreeVar {
+  shared_ptr<LockFreeVar_data<T>> data;
+  int last_read_revision=0;   ///< last revision that has been read by this access
+
+  LockFreeVar(uint maxReaders=1, const char* name=0) : data(make_shared<LockFreeVar_data<T>>(maxReaders, name)) {}
+  /// another access to the same variable (e.g. for another thread), with its own last_read_revision
+  LockFreeVar(const LockFreeVar<T>& v) : data(v.data) {}
+  LockFreeVar& operator=(const LockFreeVar& v) { HALT("you can't copy LockFreeVar!") }
+
+  LockFreeVar_RToken<T> get() { return LockFreeVar_RToken<T>(*data, &last_read_revision); } ///< read access to the latest revision
+  LockFreeVar_WToken<T> set(double dataTime=0.) { return LockFreeVar_WToken<T>(*data, dataTime); } ///< write access; publishes on destruction
+
+  rai::String& name() const { return data->name; }
+  int getRevision() { return data->revision.load(std::memory_order_acquire); }
+  bool hasNewRevision() { return getRevision()>last_read_revision; }
+  void waitForNextRevision(uint multipleRevisions=0) { waitForRevisionGreaterThan(last_read_revision+multipleRevisions); }
+  int waitForRevisionGreaterThan(int rev, double timeout=-1.); ///< returns the revision after waiting
+};
+
 //===========================================================================
 
 /// a basic condition variable
@@ -406,6 +504,35 @@ inline shared_ptr<ScriptThread> run(const std::function<int ()>& script, double
   return make_shared<ScriptThread>(script, beatIntervalSec);
 }
 
+//===========================================================================
+
+/// a fixed set of worker threads processing a FIFO of jobs; each job is called with the index of the worker running it,
+/// so that callers can keep per-worker resources (configurations, solvers, rngs)
+struct ThreadPool : NonCopyable {
+  typedef std::function<void(uint worker)> Job;
+
+  std::vector<std::thread> workers;
+  std::deque<Job> jobs;
+  Mutex jobsMutex;
+  std::condition_variable jobAdded, jobDone;
+  uint busy=0;
+  bool stop=false;
+  std::exception_ptr error; ///< first exception thrown by a job; rethrown by waitForAll
+
+  ThreadPool(uint nThreads=0); ///< nThreads=0 means: as many as hardware threads
+  ~ThreadPool();
+
+  uint size() const { return workers.size(); }
+  void add(const Job& job);
+  void waitForAll(); ///< blocks until all jobs are done; rethrows the first job exception
+
+ private:
+  void workerMain(uint worker);
+};
+
+/// calls f(i, worker) for all i<n on a temporary ThreadPool; blocks until done
+void parallelFor(uint n, const std::function<void(uint i, uint worker)>& f, uint nThreads=0);
+
 // ================================================
 //
 // template definitions
@@ -447,3 +574,43 @@ int Var<T>::waitForRevisionGreaterThan(int rev) {
 
 template<class T>
 void Var<T>::stopListening() { thread->event.stopListenTo(data); }
+
+template<class T>
+T& LockFreeVar_data<T>::beginWrite() {
+  //find a slot that is neither the current one, nor held by readers
+  for(;;) {
+    uint cur = uint(current.load(std::memory_order_relaxed)>>countBits);
+    for(uint i=1; i<nSlots; i++) {
+      uint s = (writeSlot+i)%nSlots;
+      if(s!=cur && !slots[s].refs.load(std::memory_order_acquire)) { writeSlot=s; return slots[s].data; }
+    }
+    std::this_thread::yield(); //more than maxReaders readers hold tokens
+  }
+}
+
+template<class T>
+void LockFreeVar_data<T>::publish(double dataTime) {
+  Slot& slot = slots[writeSlot];
+  int rev = revision.load(std::memory_order_relaxed)+1;
+  slot.revision = rev;
+  slot.data_time = dataTime;
+  uint64_t old = current.exchange(uint64_t(writeSlot)<<countBits, std::memory_order_acq_rel);
+  slots[old>>countBits].refs.fetch_add(int64_t(old & ((uint64_t(1)<<countBits)-1)), std::memory_order_release);
+  revision.store(rev);
+  if(waiters.load()) { auto lock = waitMutex(RAI_HERE); waitCond.notify_all(); }
+}
+
+template<class T>
+int LockFreeVar<T>::waitForRevisionGreaterThan(int rev, double timeout) {
+  int r = getRevision();
+  if(r>rev) return r;
+  data->waiters++;
+  {
+    auto lock = data->waitMutex(RAI_HERE);
+    auto pred = [this, rev, &r]() { return (r=getRevision())>rev; };
+    if(timeout<0.) data->waitCond.wait(lock, pred);
+    else data->waitCond.wait_for(lock, std::chrono::duration<double>(timeout), pred);
+  }
+  data->waiters--;
+  return r;
+}
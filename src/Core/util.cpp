@@ -7,6 +7,7 @@
     --------------------------------------------------------------  */
 
 #include "util.h"
+#include "profiler.h"
 
 #include <math.h>
 #include <string>
@@ -570,6 +571,7 @@ void initCmdLine(int _argc, char* _argv[], bool quiet) {
   initParameters(argc, argv, false, !quiet);
 
   if(checkParameter<rai::String>("raiPath")) setRaiPath(getParameter<rai::String>("raiPath"));
+  profiler(); //creates the profiler now that parameters are loaded: it reads profiler/enabled
 }
 
 /// returns true if the tag was found on command line
@@ -1108,7 +1110,7 @@ rai::String rai::FileToken::fullPath() const {
 // random number generator
 //
 
-rai::Rnd rnd;
+thread_local rai::Rnd rnd;
 
 uint32_t rai::Rnd::seed(uint32_t n) {
   uint32_t s, c;
@@ -1120,8 +1122,21 @@ uint32_t rai::Rnd::seed(uint32_t n) {
   return n;
 }
 
+/// 0 for the main thread; other threads are numbered 1, 2, .. in the order they seed lazily
+static uint32_t rnd_threadIndex() {
+  static std::atomic<uint32_t> count(0);
+#ifndef RAI_MSVC
+  if(syscall(SYS_gettid)==getpid()) return 0;
+#endif
+  return ++count;
+}
+
 uint32_t rai::Rnd::seed() {
-  return seed(rai::getParameter<uint32_t>("seed", 0));
+  return seed(rai::getParameter<uint32_t>("seed", 0) + rnd_threadIndex());
+}
+
+uint32_t rai::Rnd::seedThread(uint32_t index) {
+  return seed(rai::getParameter<uint32_t>("seed", 0) + index);
 }
 
 uint32_t rai::Rnd::clockSeed() {
@@ -18,6 +18,7 @@
 #include <memory>
 #include <climits>
 #include <mutex>
+#include <atomic>
 #include <functional>
 
 using std::cout;
@@ -304,24 +305,55 @@ template<class T> bool checkParameter(const char* tag);
 
 template<class T> void setParameter(const char* key, const T& x);
 
+/// the parameters were modified (other than by setParameter/initParameters): RAI_PARAMs re-read their keys
+void parametersChanged();
+extern std::atomic<uint64_t> parametersVersion;
+/// record a key read by getParameter (see getUsedParameters)
+void registerUsedParameter(const char* key);
+
+/** The value of a parameter key as resolved for one RAI_PARAM declaration. It is looked up (in params(), under its
+ *  lock) only on first use and after parametersChanged(); otherwise reading is lock-free. Resolved entries are
+ *  immutable and kept until exit, so concurrent readers never see a partial value. */
+template<class T> struct ParameterSlot {
+  struct Entry { uint64_t version; T value; Entry* prev; };
+  const char* key;
+  std::atomic<Entry*> entry;
+
+  ParameterSlot(const char* key) : key(key), entry(nullptr) {}
+  ~ParameterSlot() { for(Entry* e=entry.load(); e;) { Entry* p=e->prev; delete e; e=p; } }
+
+  T get(const T& Default) {
+    Entry* e = entry.load(std::memory_order_acquire);
+    uint64_t version = parametersVersion.load(std::memory_order_acquire);
+    if(e && e->version==version) return e->value;
+    Entry* n = new Entry{version, getParameter<T>(key, Default), e};
+    if(!entry.compare_exchange_strong(e, n, std::memory_order_acq_rel)) { T x = n->value; delete n; return x; }
+    return n->value;
+  }
+};
+
 template<class Tvar, class Tparam> struct ParameterInit {
   ParameterInit(Tvar& x, const char* tag, const Tparam& Default) { x = (Tvar) getParameter<Tparam>(tag, Default); }
+  ParameterInit(Tvar& x, ParameterSlot<Tparam>& slot, const Tparam& Default) { x = (Tvar) slot.get(Default); }
 };
 
+/// the (program-wide) slot of one declaration site
+#define RAI_PARAM_SLOT(type, key) \
+  []() -> rai::ParameterSlot<type>& { static rai::ParameterSlot<type> slot(key); return slot; }()
+
 #define RAI_PARAM(scope, type, name, Default) \
   type name; \
   auto& set_##name(type _##name){ name=_##name; return *this; } \
-  rai::ParameterInit<type, type> __init_##name = {name, scope #name, Default};
+  rai::ParameterInit<type, type> __init_##name = {name, RAI_PARAM_SLOT(type, scope #name), Default};
 
 #define RAI_PARAMt(scope, Tvar, name, Tparam, Default) \
   Tvar name; \
   auto& set_##name(Tvar _##name){ name=_##name; return *this; } \
-  rai::ParameterInit<Tvar, Tparam> __init_##name = {name, scope #name, Default};
+  rai::ParameterInit<Tvar, Tparam> __init_##name = {name, RAI_PARAM_SLOT(Tparam, scope #name), Default};
 
 template<class T> struct ParameterInitEnum {
-  ParameterInitEnum(T& x, const char* tag, const T& Default) {
-    String str;
-    getParameter<String>(str, tag, "");
+  ParameterInitEnum(T& x, ParameterSlot<String>& slot, const T& Default) {
+    String str = slot.get("");
     if(str.N) x = Enum<T>(str);
     else x = Default;
   }
@@ -329,7 +361,7 @@ template<class T> struct ParameterInitEnum {
 #define RAI_PARAM_ENUM(scope, type, name, Default) \
   type name; \
   auto& set_##name(type _##name){ name=_##name; return *this; } \
-  rai::ParameterInitEnum<type> __init_##name = {name, scope #name, Default};
+  rai::ParameterInitEnum<type> __init_##name = {name, RAI_PARAM_SLOT(rai::String, scope #name), Default};
 
 }
 
@@ -407,7 +439,12 @@ inline bool operator==(const FileToken&, const FileToken&) { return false; }
 namespace rai {
 /** @brief A random number generator. An global instantiation \c
   rai::rnd of a \c Rnd object is created. Use this one object to get
-  random numbers.*/
+  random numbers. The global object is thread_local: each thread
+  (lazily) seeds its own generator with Parameter<uint>("seed") plus a
+  thread index (0 for the main thread), so that threads draw different
+  streams. Lazy indices follow the order in which threads first draw;
+  for reproducible workers, call rnd.seedThread(i) at the start of
+  worker i (i>0), or rnd.seed(n) with an explicit seed.*/
 class Rnd {
  private:
   bool ready;
@@ -422,9 +459,12 @@ class Rnd {
   /// initialize with a specific seed
   uint32_t seed(uint32_t n);
 
-  /// use Parameter<uint>("seed") as seed
+  /// use Parameter<uint>("seed") plus the thread index as seed
   uint32_t seed();
 
+  /// use Parameter<uint>("seed") plus \c index as seed (for worker threads)
+  uint32_t seedThread(uint32_t index);
+
   /// uses the internal clock to generate a seed
   uint32_t clockSeed();
 
@@ -463,8 +503,8 @@ class Rnd {
 };
 
 }
-/// The global Rnd object
-extern rai::Rnd rnd;
+/// The global (per thread) Rnd object
+extern thread_local rai::Rnd rnd;
 
 //===========================================================================
 //
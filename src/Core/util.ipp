@@ -25,6 +25,7 @@ namespace rai {
 
 template<class T>
 bool getParameterBase(T& x, const char* key, bool hasDefault, const T* Default) {
+  registerUsedParameter(key);
   if(params()->get<T>(x, key)) {
     LOG(4) <<std::setw(20) <<key <<": " <<std::setw(5) <<x <<" # user [" <<typeid(x).name() <<"]";
     return true;
@@ -77,6 +78,7 @@ template<class T> void setParameter(const char* key, const T& x) {
   else {
     params()->add<T>(key, x);
   }
+  parametersChanged();
 }
 
 }//namespace
@@ -65,6 +65,7 @@ bool RndStableConfigs::getSample(rai::Configuration& C, const StringA& supports)
     }else{
       totalSucc ++;
       totalEvals += ret->evals;
+      C.setJointState(komo.getConfiguration_qOrg(0)); //return the stable config in C (not the random initialization)
       if(opt.verbose>0) komo.view(opt.verbose>1, STRING(supp <<"\n" <<*ret));
       if(savePngs){
         C.get_viewer()->savePng();
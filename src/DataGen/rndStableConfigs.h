@@ -12,6 +12,7 @@ struct RndStableConfigs {
   uint totalEvals=0, totalSucc=0;
   bool savePngs=false;
 
+  /// randomizes C and solves for a stable configuration with random supports; on success C holds that configuration
   bool getSample(rai::Configuration& C, const StringA& supports);
   void report();
 };
@@ -192,7 +192,8 @@ arr ShapenetGrasps::evaluateGrasp(){
   dirs.append(-v);
   dirs.reshape(-1,3);
 
-  //start a sim
+  //start a sim (PhysX is shared with other threads, e.g. ShardedGenerator workers)
+  auto physxLock = PhysX_mutex()(RAI_HERE);
   PhysXInterface physx(C, opt.simVerbose, &physxOpt);
   physx.disableGravity(obj, true);
 
@@ -297,27 +298,33 @@ arr ShapenetGrasps::getPointNormals(){
   return objPts->shape->mesh().Vn;
 }
 
-void ShapenetGrasps::getSamples(arr& X, uintA& shapes, arr& Scores, uint N){
+bool ShapenetGrasps::getSample(arr& x, uint& shape, arr& scores){
   if(opt.endShape<0) opt.endShape = files.N;
 
-  for(uint n=0;n<N;){
-    uint shape = opt.startShape + rnd(opt.endShape-opt.startShape);
-    if(opt.verbose>0){
-      cout <<"sample " <<n <<", shape " <<shape <<" (" <<files(shape) <<")" <<endl;
-    }
+  shape = opt.startShape + rnd(opt.endShape-opt.startShape);
+  if(opt.verbose>0){
+    cout <<"sample shape " <<shape <<" (" <<files(shape) <<")" <<endl;
+  }
 
-    //== CREATE SCENE
-    bool succ = loadObject(shape, true);
-    if(!succ) continue;
-    if(opt.verbose>0) C.view(opt.verbose>2, STRING(shape <<"\nrandom obj pose"));
-    //if(!n) C.view(true);
+  //== CREATE SCENE
+  bool succ = loadObject(shape, true);
+  if(!succ) return false;
+  if(opt.verbose>0) C.view(opt.verbose>2, STRING(shape <<"\nrandom obj pose"));
 
-    //== SAMPLE A RANDOM+REJECT+REFINE GRASP POSE
-    arr relGripperPose = sampleGraspPose();
-    if(!relGripperPose.N) continue;
+  //== SAMPLE A RANDOM+REJECT+REFINE GRASP POSE
+  x = sampleGraspPose();
+  if(!x.N) return false;
 
-    //== PHYSICAL SIMULATION
-    arr scores = evaluateGrasp();
+  //== PHYSICAL SIMULATION
+  scores = evaluateGrasp();
+  return true;
+}
+
+void ShapenetGrasps::getSamples(arr& X, uintA& shapes, arr& Scores, uint N){
+  arr relGripperPose, scores;
+  uint shape;
+  for(uint n=0;n<N;){
+    if(!getSample(relGripperPose, shape, scores)) continue;
 
     if(min(scores)>0.){ //success - store!
       X.append(relGripperPose);
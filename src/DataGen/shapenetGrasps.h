@@ -24,7 +24,8 @@ struct ShapenetGrasps{
   ShapenetGrasps();
 
   //-- batch interfaces
-  void getSamples(arr& X, uintA& shapes, arr& Scores, uint N);
+  bool getSample(arr& x, uint& shape, arr& scores); ///< one evaluated grasp candidate on a random shape (success or not); false if no candidate was found
+  void getSamples(arr& X, uintA& shapes, arr& Scores, uint N); ///< N successful grasps
   arr evaluateSample(const arr& x, uint shape);
   void displaySamples(const arr& X, const uintA& shapes, const arr& Scores={});
 
@@ -0,0 +1,170 @@
+#include "shardedGenerator.h"
+
+#include "shapenetGrasps.h"
+#include "rndStableConfigs.h"
+#include "../Core/thread.h"
+#include "../Core/binary.h"
+#include "../Kin/kin.h"
+
+#include <cstdio>
+#include <filesystem>
+
+rai::String ShardedGenerator::shardFile(uint k) { return STRING(opt.path <<"/shard" <<k <<".rbin"); }
+
+rai::Graph ShardedGenerator::readShard(const char* file) {
+  rai::BinaryReader R(file);
+  rai::Graph data;
+  for(uint i=0; i<R.records.N; i++) {
+    arr x = R.read<double>(i);
+    rai::Node* d = data.findNode(R.records(i).name);
+    if(!d) data.add<arr>(R.records(i).name, x);
+    else d->as<arr>().append(x);
+  }
+  return data;
+}
+
+rai::Graph ShardedGenerator::readShards() {
+  rai::Graph data;
+  for(uint k=0; k<(uint)opt.shards; k++) {
+    if(!rai::FileToken(shardFile(k)).exists()) continue;
+    rai::Graph shard = readShard(shardFile(k));
+    for(rai::Node* s:shard) {
+      rai::Node* d = data.findNode(s->key);
+      if(!d) data.add<arr>(s->key, s->as<arr>());
+      else d->as<arr>().append(s->as<arr>());
+    }
+  }
+  return data;
+}
+
+void ShardedGenerator::run() {
+  CHECK(opt.processes>=1 && opt.process>=0 && opt.process<opt.processes, "process index out of range");
+  std::filesystem::create_directories(opt.path.p);
+
+  //-- resume: only shards of this process that do not exist yet
+  uintA todo;
+  for(uint k=opt.process; k<(uint)opt.shards; k+=opt.processes) {
+    if(rai::FileToken(shardFile(k)).exists()) shardsSkipped++;
+    else todo.append(k);
+  }
+  if(opt.verbose>0) LOG(0) <<"generating " <<todo.N <<" shards into '" <<opt.path <<"' (" <<shardsSkipped <<" exist already)";
+  if(!todo.N) return;
+
+  workers = opt.threads>0 ? opt.threads : std::thread::hardware_concurrency();
+  if(!workers) workers=1;
+  if(workers>todo.N) workers=todo.N;
+
+  rai::Array<SampleFct> generators(workers); //each worker creates and owns its generator
+  Mutex progressMutex;
+  double startTime = rai::realTime();
+  rai::Rnd callerRnd = rnd; //with one worker, shards run on the caller's thread: restore its thread_local rnd afterwards
+
+  parallelFor(todo.N, [&](uint i, uint worker) {
+    uint k = todo(i);
+    if(!generators(worker)) generators(worker) = factory(worker);
+    rnd.seed(opt.seed+k); //thread_local rnd: shard k is reproducible, independent of the worker
+
+    //-- stream samples to the shard; each key of the sample becomes (chunk x dim) records
+    rai::String file = shardFile(k);
+    rai::String tmpFile = STRING(file <<".tmp");
+    uint n=0, tries=0, maxTries=opt.samplesPerShard*opt.maxAttemptsPerSample;
+    {
+      rai::BinaryWriter W(tmpFile);
+      rai::Graph chunk;
+      uint rows=0;
+      auto writeChunk = [&]() {
+        for(rai::Node* d:chunk) { W.add<double>(d->key, d->as<arr>()); d->as<arr>().resize(0, d->as<arr>().d1); }
+        rows=0;
+      };
+      while(n<(uint)opt.samplesPerShard && tries<maxTries) {
+        tries++;
+        rai::Graph sample;
+        if(!generators(worker)(sample)) continue;
+        for(rai::Node* s:sample) {
+          const arr& x = s->as<arr>();
+          rai::Node* d = chunk.findNode(s->key);
+          if(!d) { CHECK(!n, "sample '" <<s->key <<"' is new");  d = chunk.add<arr>(s->key);  d->as<arr>().resize(0, x.N); }
+          arr& X = d->as<arr>();
+          CHECK_EQ(X.d1, x.N, "sample '" <<s->key <<"' changed dimension");
+          X.append(x);
+          X.reshape(-1, x.N);
+        }
+        n++;
+        if(++rows==(uint)opt.chunkSamples) writeChunk();
+      }
+      if(rows) writeChunk();
+    }
+
+    //-- the shard file only exists when complete
+    bool complete = (n==(uint)opt.samplesPerShard);
+    if(complete) {
+      int r = std::rename(tmpFile, file);
+      CHECK(!r, "could not rename '" <<tmpFile <<"' to '" <<file <<"'");
+    } else {
+      std::remove(tmpFile);
+    }
+
+    //-- progress
+    auto lock = progressMutex(RAI_HERE);
+    samples += n;
+    attempts += tries;
+    if(!complete) {
+      shardsFailed++;
+      LOG(-1) <<"shard " <<k <<" given up: only " <<n <<" samples in " <<tries <<" attempts";
+      return;
+    }
+    shardsDone++;
+    time = rai::realTime()-startTime;
+    if(opt.verbose>0) {
+      LOG(0) <<"shard " <<k <<" done (" <<shardsDone <<'/' <<todo.N <<") -- "
+             <<samplesPerSecondPerCore() <<" samples/s per core, success rate " <<double(samples)/double(attempts);
+    }
+  }, workers);
+  rnd = callerRnd;
+
+  time = rai::realTime()-startTime;
+  if(opt.verbose>0) report(cout);
+}
+
+void ShardedGenerator::report(std::ostream& os) {
+  os <<"ShardedGenerator '" <<opt.path <<"': shards done: " <<shardsDone <<" skipped: " <<shardsSkipped <<" failed: " <<shardsFailed
+     <<" samples: " <<samples <<" attempts: " <<attempts <<" time: " <<time <<"sec workers: " <<workers
+     <<" samples/s/core: " <<samplesPerSecondPerCore() <<endl;
+}
+
+//===========================================================================
+
+ShardedGenerator::GeneratorFactory ShapenetGrasps_generator() {
+  return [](uint worker) -> ShardedGenerator::SampleFct {
+    auto SG = make_shared<ShapenetGrasps>();
+    SG->opt.verbose = 0; //no viewers within worker threads
+    return [SG](rai::Graph& sample) {
+      arr x, scores;
+      uint shape;
+      if(!SG->getSample(x, shape, scores)) return false;
+      sample.add<arr>("x", x);
+      sample.add<arr>("shape", arr{double(shape)});
+      sample.add<arr>("scores", scores.reshape(-1));
+      return true;
+    };
+  };
+}
+
+ShardedGenerator::GeneratorFactory RndStableConfigs_generator(const rai::Configuration& C, const StringA& supports) {
+  auto copyMutex = make_shared<Mutex>();
+  return [&C, supports, copyMutex](uint worker) -> ShardedGenerator::SampleFct {
+    auto C_worker = make_shared<rai::Configuration>();
+    {
+      auto lock = (*copyMutex)(RAI_HERE);
+      C_worker->copy(C);
+    }
+    auto RSC = make_shared<RndStableConfigs>();
+    RSC->opt.verbose = 0; //no viewers within worker threads
+    return [C_worker, RSC, supports](rai::Graph& sample) {
+      if(!RSC->getSample(*C_worker, supports)) return false;
+      sample.add<arr>("q", C_worker->getJointState());
+      sample.add<arr>("X", C_worker->getFrameState().reshape(-1));
+      return true;
+    };
+  };
+}
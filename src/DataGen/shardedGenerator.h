@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../Core/util.h"
+#include "../Core/graph.h"
+
+namespace rai { struct Configuration; }
+
+struct ShardedGenerator_Options {
+  RAI_PARAM("ShardedGenerator/", int, verbose, 1)
+  RAI_PARAM("ShardedGenerator/", rai::String, path, "z.shards")
+  RAI_PARAM("ShardedGenerator/", int, shards, 10)
+  RAI_PARAM("ShardedGenerator/", int, samplesPerShard, 100)
+  RAI_PARAM("ShardedGenerator/", int, chunkSamples, 100) //samples are written in chunks of that many rows
+  RAI_PARAM("ShardedGenerator/", int, maxAttemptsPerSample, 100) //a shard is given up after samplesPerShard*maxAttemptsPerSample attempts
+  RAI_PARAM("ShardedGenerator/", int, threads, 0) //0: all cores
+  RAI_PARAM("ShardedGenerator/", int, process, 0) //index of this process when several processes share the shards
+  RAI_PARAM("ShardedGenerator/", int, processes, 1)
+  RAI_PARAM("ShardedGenerator/", uint, seed, 0)
+};
+
+/** Generates a data set in parallel (threads within a process, and several processes) into shard files
+ *  '<path>/shard<k>.rbin'. Each worker thread owns its own generator (created by the factory within the
+ *  worker, e.g. with its own Configuration and simulator); each shard is generated by one worker with rnd
+ *  seeded by seed+k, so shards are reproducible. Samples are streamed to the shard in chunks of chunkSamples rows
+ *  (one binary record per key and chunk), so memory does not grow with the shard size; readShard concatenates
+ *  the chunks. A shard file only appears (by rename) when complete; existing shard files are skipped, so that a
+ *  killed run can be resumed by restarting it. A shard whose generator keeps failing is given up after
+ *  samplesPerShard*maxAttemptsPerSample attempts (counted in shardsFailed). Process i of n generates shards k
+ *  with k%n==i. Generators that simulate with PhysX have to lock PhysX_mutex() around it (as ShapenetGrasps does),
+ *  or run one process per shard set. */
+struct ShardedGenerator {
+  /// generates a single sample into named rows (e.g. "x", "shape", "scores"); returns false for a failed sample
+  typedef std::function<bool(rai::Graph& sample)> SampleFct;
+  typedef std::function<SampleFct(uint worker)> GeneratorFactory;
+
+  ShardedGenerator_Options opt;
+  GeneratorFactory factory;
+
+  //-- progress
+  uint samples=0, attempts=0, shardsDone=0, shardsSkipped=0, shardsFailed=0;
+  double time=0.;
+  uint workers=0;
+
+  ShardedGenerator(const GeneratorFactory& _factory) : factory(_factory) {}
+
+  void run();
+  void report(std::ostream& os);
+  double samplesPerSecondPerCore() { return double(samples)/time/double(workers); }
+
+  rai::String shardFile(uint k);
+  static rai::Graph readShard(const char* file); ///< each key as a (samples x dim) arr
+  rai::Graph readShards(); ///< all existing shards merged in shard order, each key as a (samples x dim) arr
+};
+
+//-- generator factories for the data generators in this folder
+
+ShardedGenerator::GeneratorFactory ShapenetGrasps_generator();
+ShardedGenerator::GeneratorFactory RndStableConfigs_generator(const rai::Configuration& C, const StringA& supports);
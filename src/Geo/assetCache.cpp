@@ -0,0 +1,287 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#include "assetCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <dirent.h>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+namespace rai {
+
+//===========================================================================
+
+uint64_t AssetCache::hashBytes(const void* p, size_t n, uint64_t h) {
+  const unsigned char* c = (const unsigned char*)p;
+  //8 bytes at a time, then the tail
+  for(; n>=8; n-=8, c+=8) {
+    uint64_t w;
+    memcpy(&w, c, 8);
+    h = (h ^ w) * 0x100000001b3ull;
+  }
+  for(; n; n--, c++) h = (h ^ *c) * 0x100000001b3ull;
+  return h;
+}
+
+AssetCache::Key& AssetCache::Key::add(const void* p, size_t n) {
+  h = hashBytes(p, n, h);
+  //the check: a multiply-xorshift mix per 8 bytes (independent of FNV-1a)
+  const unsigned char* c = (const unsigned char*)p;
+  bytes += n;
+  for(; n; ) {
+    uint64_t w=0;
+    size_t k = (n<8 ? n : 8);
+    memcpy(&w, c, k);
+    check ^= w + k;
+    check *= 0xff51afd7ed558ccdull;
+    check ^= check>>33;
+    c+=k; n-=k;
+  }
+  return *this;
+}
+
+/// approximate memory of a mesh
+static size_t meshBytes(const Mesh& m) {
+  return sizeof(Mesh) + (m.V.N+m.Vn.N+m.C.N+m.Tn.N+m.texCoords.N)*sizeof(double) + m.T.N*sizeof(uint);
+}
+
+uint64_t AssetCache::fileHash(const char* filename) {
+  struct stat st;
+  if(stat(filename, &st)) HALT("asset file '" <<filename <<"' does not exist");
+  int64_t mtime = (int64_t)st.st_mtim.tv_sec*1000000000ll + st.st_mtim.tv_nsec;
+  {
+    auto lock = mutex(RAI_HERE);
+    auto it = files.find(filename);
+    if(it!=files.end() && it->second.mtime==mtime && it->second.size==(int64_t)st.st_size) return it->second.hash;
+  }
+
+  std::ifstream fil(filename, std::ios::binary);
+  std::vector<char> buf(1<<20);
+  uint64_t h = hashInit;
+  while(fil) {
+    fil.read(buf.data(), buf.size());
+    h = hashBytes(buf.data(), fil.gcount(), h);
+  }
+
+  auto lock = mutex(RAI_HERE);
+  FileEntry& e = files[filename];
+  e.mtime=mtime; e.size=st.st_size; e.hash=h;
+  _stats.fileHashes++;
+  return h;
+}
+
+shared_ptr<Mesh> AssetCache::mesh(const char* filename, double scale, const std::function<void(Mesh&)>& load, const char* variant) {
+  String ext = String(filename).getLastN(3);
+  uint64_t key = fileHash(filename);
+  key = hashBytes(&scale, sizeof(scale), key);
+  key = hashBytes(ext.p, ext.N, key);
+  if(variant) key = hashBytes(variant, strlen(variant), key);
+  {
+    auto lock = mutex(RAI_HERE);
+    auto it = fileMeshes.find(key);
+    if(it!=fileMeshes.end()) { _stats.memHits++; it->second.lastUse=++useCount; return it->second.mesh; }
+  }
+
+  auto m = make_shared<Mesh>();
+  load(*m);
+
+  auto lock = mutex(RAI_HERE);
+  _stats.misses++;
+  MeshEntry& e = fileMeshes[key];
+  if(!e.mesh) { //another thread might have been faster
+    e.file = filename; e.variant = (variant!=0); e.order = fileMeshes.size(); e.mesh = m;
+    e.bytes = meshBytes(*m);
+    memBytes += e.bytes;
+  }
+  e.lastUse = ++useCount;
+  m = e.mesh;
+  evict();
+  return m;
+}
+
+shared_ptr<const Mesh> AssetCache::derived(const char* kind, const Key& key, const std::function<void(Mesh&)>& compute) {
+  char hex[17];
+  snprintf(hex, 17, "%016llx", (unsigned long long)key.h);
+  std::string id = STRING(kind <<'-' <<hex).p;
+  {
+    auto lock = mutex(RAI_HERE);
+    auto it = derivedMeshes.find(id);
+    if(it!=derivedMeshes.end()) { _stats.memHits++; it->second.lastUse=++useCount; return it->second.mesh; }
+  }
+
+  auto m = make_shared<Mesh>();
+  bool useDisk = opt.useDisk && opt.path.N;
+  String file;
+  if(useDisk) file <<opt.path <<'/' <<id <<".arr";
+  if(useDisk && readDisk(*m, file, key)) {
+    utime(file.p, 0); //marks the entry as recently used
+    auto lock = mutex(RAI_HERE);
+    _stats.diskHits++;
+  } else {
+    compute(*m);
+    if(useDisk) writeDisk(*m, file, key);
+    auto lock = mutex(RAI_HERE);
+    _stats.misses++;
+  }
+
+  auto lock = mutex(RAI_HERE);
+  DerivedEntry& e = derivedMeshes[id];
+  if(!e.mesh) { e.mesh = m;  e.bytes = meshBytes(*m);  memBytes += e.bytes; }
+  e.lastUse = ++useCount;
+  shared_ptr<const Mesh> r = e.mesh;
+  evict();
+  return r;
+}
+
+shared_ptr<const Mesh> AssetCache::convexHull(const arr& V) {
+  return derived("hull", Key().add(V), [&V](Mesh& m) {
+    m.V = V;
+    m.makeConvexHull();
+  });
+}
+
+void AssetCache::evict() {
+  if(opt.maxMegabytes<=0.) return;
+  size_t limit = size_t(opt.maxMegabytes*(1<<20));
+  while(memBytes>limit && (fileMeshes.size() || derivedMeshes.size())) {
+    //linear search for the least recently used entry -- only done when beyond the limit
+    auto f = fileMeshes.end();
+    for(auto it=fileMeshes.begin(); it!=fileMeshes.end(); ++it) if(f==fileMeshes.end() || it->second.lastUse<f->second.lastUse) f=it;
+    auto d = derivedMeshes.end();
+    for(auto it=derivedMeshes.begin(); it!=derivedMeshes.end(); ++it) if(d==derivedMeshes.end() || it->second.lastUse<d->second.lastUse) d=it;
+    if(d==derivedMeshes.end() || (f!=fileMeshes.end() && f->second.lastUse<d->second.lastUse)) {
+      memBytes -= f->second.bytes;
+      fileMeshes.erase(f);
+    } else {
+      memBytes -= d->second.bytes;
+      derivedMeshes.erase(d);
+    }
+    _stats.evictions++;
+  }
+}
+
+bool AssetCache::readDisk(Mesh& m, const String& file, const Key& key) {
+  std::ifstream fil(file.p, std::ios::binary);
+  if(!fil.good()) return false;
+  try {
+    Key k;
+    parse(fil, "key");
+    fil >>k.h >>k.check >>k.bytes;
+    if(!fil.good() || !(k==key)) {
+      LOG(-1) <<"asset cache entry '" <<file <<"' does not match its inputs (hash collision or old format) -- recomputing";
+      return false;
+    }
+    parse(fil, "V");
+    m.V.readJson(fil);
+    parse(fil, "T");
+    m.T.readJson(fil);
+  } catch(...) {
+    LOG(-1) <<"could not read asset cache entry '" <<file <<"' -- recomputing";
+    m.V.clear(); m.T.clear();
+    return false;
+  }
+  return true;
+}
+
+void AssetCache::writeDisk(const Mesh& m, const String& file, const Key& key) {
+  {
+    auto lock = mutex(RAI_HERE);
+    if(!diskReady) {
+      std::error_code err; //an uncreatable store only fails the write below
+      std::filesystem::create_directories(opt.path.p, err);
+      diskReady=true;
+    }
+  }
+  //write to a process-unique temporary file and rename, so that concurrent readers never see partial entries
+  String tmpFile = STRING(file <<'.' <<getpid() <<".tmp");
+  {
+    std::ofstream fil(tmpFile.p, std::ios::binary);
+    if(!fil.good()) return; //the store is not writable -- not an error
+    fil <<"key " <<key.h <<' ' <<key.check <<' ' <<key.bytes <<"\nV ";
+    m.V.writeJson(fil);
+    fil <<"\nT ";
+    m.T.writeJson(fil);
+    fil <<'\n';
+    if(!fil.good()) { fil.close(); std::remove(tmpFile.p); return; }
+  }
+  if(std::rename(tmpFile.p, file.p)) { std::remove(tmpFile.p); return; }
+  {
+    auto lock = mutex(RAI_HERE);
+    _stats.diskWrites++;
+  }
+  evictDisk(file);
+}
+
+void AssetCache::evictDisk(const String& keep) {
+  if(opt.maxDiskMegabytes<=0.) return;
+  DIR* dir = opendir(opt.path.p);
+  if(!dir) return;
+  //all entries, oldest (least recently written or read) first
+  std::vector<std::pair<int64_t, std::pair<String, size_t>>> entries;
+  size_t total=0;
+  while(dirent* d = readdir(dir)) {
+    String file = STRING(opt.path <<'/' <<d->d_name);
+    struct stat st;
+    if(!file.endsWith(".arr") || stat(file.p, &st)) continue;
+    entries.push_back({(int64_t)st.st_mtim.tv_sec*1000000000ll + st.st_mtim.tv_nsec, {file, (size_t)st.st_size}});
+    total += st.st_size;
+  }
+  closedir(dir);
+  size_t limit = size_t(opt.maxDiskMegabytes*(1<<20));
+  if(total<=limit) return;
+  std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) { return a.first<b.first; });
+  uint n=0;
+  for(auto& e:entries) {
+    if(total<=limit) break;
+    if(e.second.first==keep) continue;
+    if(!std::remove(e.second.first.p)) { total -= e.second.second; n++; } //(another process might have removed it)
+  }
+  auto lock = mutex(RAI_HERE);
+  _stats.diskEvictions += n;
+}
+
+std::vector<std::pair<String, shared_ptr<Mesh>>> AssetCache::meshes() {
+  auto lock = mutex(RAI_HERE);
+  std::vector<std::pair<String, shared_ptr<Mesh>>> M;
+  std::vector<const MeshEntry*> E;
+  for(auto& e:fileMeshes) if(!e.second.variant) E.push_back(&e.second);
+  std::sort(E.begin(), E.end(), [](const MeshEntry* a, const MeshEntry* b) { return a->order<b->order; });
+  for(const MeshEntry* e:E) M.emplace_back(e->file, e->mesh);
+  return M;
+}
+
+void AssetCache::clear() {
+  auto lock = mutex(RAI_HERE);
+  files.clear();
+  fileMeshes.clear();
+  derivedMeshes.clear();
+  memBytes=0;
+}
+
+AssetCache::Stats AssetCache::stats() {
+  auto lock = mutex(RAI_HERE);
+  return _stats;
+}
+
+void AssetCache::report(std::ostream& os) {
+  Stats s = stats();
+  os <<"AssetCache: memory hits: " <<s.memHits <<" disk hits: " <<s.diskHits <<" misses: " <<s.misses
+     <<" disk writes: " <<s.diskWrites <<" file hashes: " <<s.fileHashes
+     <<" evictions: " <<s.evictions <<" disk evictions: " <<s.diskEvictions <<endl;
+}
+
+AssetCache& assetCache() {
+  static AssetCache cache;
+  return cache;
+}
+
+} //namespace
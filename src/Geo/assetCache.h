@@ -0,0 +1,98 @@
+/*  ------------------------------------------------------------------
+    Copyright (c) 2011-2024 Marc Toussaint
+    email: toussaint@tu-berlin.de
+
+    This code is distributed under the MIT License.
+    Please see <root-path>/LICENSE for details.
+    --------------------------------------------------------------  */
+
+#pragma once
+
+#include "mesh.h"
+#include "../Core/util.h"
+
+#include <unordered_map>
+#include <functional>
+
+namespace rai {
+
+//===========================================================================
+
+struct AssetCache_Options {
+  RAI_PARAM("assetCache/", rai::String, path, "") //directory of the persistent store of derived geometry (shared by all processes); empty: in memory only
+  RAI_PARAM("assetCache/", bool, useDisk, true)
+  RAI_PARAM("assetCache/", double, maxMegabytes, 1000.) //in memory: least recently used entries are dropped beyond this (their users keep them alive); <=0: no limit
+  RAI_PARAM("assetCache/", double, maxDiskMegabytes, 1000.) //on disk: least recently used entries are deleted beyond this; <=0: no limit
+};
+
+/** A process-wide, thread safe cache of geometric assets, keyed by content hashes:
+ *  - meshes loaded from files are shared in memory, keyed by the file's content hash (recomputed only when the
+ *    file's mtime or size changes), its extension and the scale;
+ *  - derived geometry (convex hulls, implicit surfaces of sdf grids) is keyed by the hash of its input arrays, shared
+ *    in memory, and persisted in opt.path so that other processes on the same host load instead of recomputing it.
+ *  Disk entries are written atomically (via rename) and store their full Key, which is compared on disk hits; unreadable
+ *  or mismatching entries count as misses. Memory and disk are limited by size, dropping least recently used entries. */
+struct AssetCache {
+  AssetCache_Options opt;
+
+  struct Stats { uint memHits=0, diskHits=0, misses=0, diskWrites=0, fileHashes=0, evictions=0, diskEvictions=0; };
+
+  /// content key of derived geometry: the hash naming the entry, a second independent hash, and the number of hashed bytes
+  struct Key {
+    uint64_t h=hashInit, check=0x9e3779b97f4a7c15ull, bytes=0;
+    Key& add(const void* p, size_t n);
+    template<class T> Key& add(const Array<T>& x) {
+      for(uint i=0; i<x.nd; i++) { uint d=x.dim(i); add(&d, sizeof(d)); }
+      return add(x.p, x.N*sizeof(T));
+    }
+    bool operator==(const Key& k) const { return h==k.h && check==k.check && bytes==k.bytes; }
+  };
+
+  /// the mesh of a file (scaled), shared with all other users of the same file content and scale; load is called on a miss;
+  /// variant distinguishes different meshes read from the same file (e.g. "decomp" of an h5 file)
+  shared_ptr<Mesh> mesh(const char* filename, double scale, const std::function<void(Mesh&)>& load, const char* variant=0);
+  /// derived geometry of the given kind (e.g. "hull") for the content key of its inputs; compute is called on a miss
+  shared_ptr<const Mesh> derived(const char* kind, const Key& key, const std::function<void(Mesh&)>& compute);
+  /// convex hull (vertices and triangles) of the points V
+  shared_ptr<const Mesh> convexHull(const arr& V);
+
+  /// content hash of a file; rehashed only when its mtime or size changes; fails if the file does not exist
+  uint64_t fileHash(const char* filename);
+  /// FNV-1a hash of the data (and dimensions) of an array, chained with h
+  template<class T> static uint64_t hash(const Array<T>& x, uint64_t h=hashInit) {
+    for(uint i=0; i<x.nd; i++) { uint d=x.dim(i); h = hashBytes(&d, sizeof(d), h); }
+    return hashBytes(x.p, x.N*sizeof(T), h);
+  }
+  static uint64_t hashBytes(const void* p, size_t n, uint64_t h=hashInit);
+  static const uint64_t hashInit = 0xcbf29ce484222325ull;
+
+  /// all loaded meshes (without variants) with their file names, in loading order (e.g. to export assets)
+  std::vector<std::pair<String, shared_ptr<Mesh>>> meshes();
+  void clear(); ///< drop all in-memory entries (the disk store remains)
+
+  Stats stats();
+  void report(std::ostream& os);
+
+ private:
+  struct FileEntry { int64_t mtime=0, size=-1; uint64_t hash=0; };
+  struct MeshEntry { String file; bool variant=false; uint order=0; shared_ptr<Mesh> mesh; uint64_t lastUse=0; size_t bytes=0; };
+  struct DerivedEntry { shared_ptr<const Mesh> mesh; uint64_t lastUse=0; size_t bytes=0; };
+  Mutex mutex;
+  std::unordered_map<std::string, FileEntry> files;
+  std::unordered_map<uint64_t, MeshEntry> fileMeshes;
+  std::unordered_map<std::string, DerivedEntry> derivedMeshes;
+  Stats _stats;
+  uint64_t useCount=0; //clock of the LRU
+  size_t memBytes=0;
+  bool diskReady=false;
+
+  void evict(); ///< drops least recently used entries beyond opt.maxMegabytes (with mutex locked)
+  bool readDisk(Mesh& m, const String& file, const Key& key);
+  void writeDisk(const Mesh& m, const String& file, const Key& key);
+  void evictDisk(const String& keep);
+};
+
+/// the process-wide asset cache
+AssetCache& assetCache();
+
+} //namespace
@@ -10,12 +10,12 @@
 
 #include <math.h>
 
-Depth2PointCloud::Depth2PointCloud(Var<floatA>& _depth, float _fx, float _fy, float _px, float _py)
+Depth2PointCloud::Depth2PointCloud(Var<floatA>& _depth, float _fx, float _fy, float _cx, float _cy)
   : Thread("Depth2PointCloud"),
     depth(this, _depth, true),
-    fx(_fx), fy(_fy), px(_px), py(_py) {
+    stream(_fx, _fy, _cx, _cy) {
   pose.set()->setZero();
-  threadOpen();
+  threadOpen(true); //wait until idle: a depth update while still opening would be lost
 }
 
 Depth2PointCloud::Depth2PointCloud(Var<floatA>& _depth, const arr& fxycxy)
@@ -27,16 +27,169 @@ Depth2PointCloud::~Depth2PointCloud() {
 }
 
 void Depth2PointCloud::step() {
-  _depth = depth.get();
-
-  depthData2pointCloud(_points, _depth, fx, fy, px, py);
+  _depth = depth.get(); //same size each frame: no reallocation
 
   rai::Transformation _pose = pose.get(); //this is relative to "/base_link"
-  if(!_pose.isZero()) _pose.applyOnPointArray(_points);
 
-  points.set() = _points;
+  //copied out: the stream's ring buffers are only valid for ringSize frames and are not shared with consumers
+  const floatA& res = stream.process(_depth, _pose);
+  {
+    auto c = cloud.set();
+    floatA& C = c();
+    C.resizeMEM(res.N, false, rai::MAX(C.M, 3*stream.capacity())); //allocates once, at the full image size
+    C.reshape(res.d0, 3);
+    if(res.N) memmove(C.p, res.p, res.N*sizeof(float));
+  }
+
+  //the dense double cloud only for those who refer to it
+  if(points.data.use_count()>1) {
+    depthData2pointCloud(_points, _depth, stream.fx, stream.fy, stream.cx, stream.cy);
+    if(!_pose.isZero()) _pose.applyOnPointArray(_points);
+    points.set() = _points;
+  }
 }
 
+//===========================================================================
+
+void DepthStream::setup(uint _H, uint _W) {
+  H=_H; W=_W;
+  CHECK(fx>0, "need a focal length greater zero!(not implemented for ortho yet)");
+  if(std::isnan(fy)) fy = fx;
+  if(std::isnan(cx)) cx=.5*W;
+  if(std::isnan(cy)) cy=.5*H;
+  CHECK_GE(opt.stride, 1, "");
+  CHECK_GE(opt.ringSize, 1, "");
+
+  uint s=opt.stride, h=(H+s-1)/s, w=(W+s-1)/s;
+  colX.resize(w);
+  for(uint j=0; j<w; j++) colX.p[j] = (float(j*s) - cx) / fx;
+  rowY.resize(h);
+  for(uint i=0; i<h; i++) rowY.p[i] = (float(i*s) - cy) / fy;
+  rowBuf.resize(3, w);
+
+  ring.resize(opt.ringSize);
+  for(floatA& r:ring) r.resize(h*w, 3);
+  out.resize(opt.ringSize);
+
+  if(opt.voxelSize>0.) {
+    uint m=1;
+    while(m<2*h*w) m<<=1;
+    voxelKey.resize(m).setZero();
+    voxelSum.resize(m, 3);
+    voxelCount.resize(m);
+    voxelUsed.resize(h*w);
+  }
+}
+
+const floatA& DepthStream::process(const floatA& depth, const rai::Transformation& X) {
+  CHECK_EQ(depth.nd, 2, "depth image needs to be 2D");
+  if(depth.d0!=H || depth.d1!=W) setup(depth.d0, depth.d1);
+
+  //-- the pose as float rotation and translation
+  bool transform = !X.isZero();
+  float R[9], t[3];
+  if(transform) {
+    double m[16];
+    X.getMatrix(m);
+    for(uint k=0; k<3; k++) {
+      R[3*k+0]=m[4*k+0]; R[3*k+1]=m[4*k+1]; R[3*k+2]=m[4*k+2];
+      t[k]=m[4*k+3];
+    }
+  }
+
+  uint s=opt.stride, w=colX.N;
+  float minDepth=opt.minDepth, maxDepth=opt.maxDepth;
+  floatA& buf = ring(revision%ring.N);
+  float* __restrict__ pt = buf.p;
+  float* __restrict__ px = rowBuf.p;
+  float* __restrict__ py = rowBuf.p+w;
+  float* __restrict__ pz = rowBuf.p+2*w;
+  const float* __restrict__ cX = colX.p;
+  uint n=0;
+
+  for(uint i=0; i<rowY.N; i++) {
+    const float* __restrict__ de = depth.p + i*s*W;
+    float y = rowY.p[i];
+
+    //-- all pixels of the row (vectorized)
+    if(s==1) {
+      for(uint j=0; j<w; j++) { float d=de[j]; px[j]=d*cX[j]; py[j]=d*y; pz[j]=d; }
+    } else {
+      for(uint j=0; j<w; j++) { float d=de[j*s]; px[j]=d*cX[j]; py[j]=d*y; pz[j]=d; }
+    }
+    if(transform) {
+      for(uint j=0; j<w; j++) {
+        float a=px[j], b=py[j], c=pz[j];
+        px[j] = R[0]*a + R[1]*b + R[2]*c + t[0];
+        py[j] = R[3]*a + R[4]*b + R[5]*c + t[1];
+        pz[j] = R[6]*a + R[7]*b + R[8]*c + t[2];
+      }
+    }
+
+    //-- compact the valid ones into the output
+    for(uint j=0; j<w; j++) {
+      float d=de[j*s];
+      if(d>minDepth && d<maxDepth) {
+        pt[0]=px[j]; pt[1]=py[j]; pt[2]=pz[j];
+        pt+=3; n++;
+      }
+    }
+  }
+
+  if(opt.voxelSize>0.) n = voxelize(buf.p, n);
+
+  floatA& res = out(revision%ring.N);
+  res.referTo(buf.p, 3*n);
+  res.reshape(n, 3);
+  revision++;
+  return res;
+}
+
+uint DepthStream::voxelize(float* pts, uint n) {
+  float scale = 1./opt.voxelSize;
+  uint64_t mask = voxelKey.N-1;
+  uint m=0;
+
+  //-- accumulate points per voxel; keys are the 3 voxel indices (21 bits each), +1 so that 0 marks an empty slot
+  for(uint i=0; i<n; i++) {
+    float* p = pts+3*i;
+    uint64_t key = 1;
+    for(uint k=0; k<3; k++) key = (key<<21) | (uint64_t(int64_t(std::floor(p[k]*scale)) + (1<<20)) & 0x1fffff);
+    uint64_t h = (key * 0x9e3779b97f4a7c15ull) >> 20;
+    for(;; h++) {
+      uint64_t& slot = voxelKey.p[h&mask];
+      if(!slot) {
+        slot = key;
+        float* sum = voxelSum.p+3*(h&mask);
+        sum[0]=p[0]; sum[1]=p[1]; sum[2]=p[2];
+        voxelCount.p[h&mask] = 1;
+        voxelUsed.p[m++] = h&mask;
+        break;
+      }
+      if(slot==key) {
+        float* sum = voxelSum.p+3*(h&mask);
+        sum[0]+=p[0]; sum[1]+=p[1]; sum[2]+=p[2];
+        voxelCount.p[h&mask]++;
+        break;
+      }
+    }
+  }
+
+  //-- write the voxel means (in order of first occurrence) and clear the table
+  for(uint i=0; i<m; i++) {
+    uint slot = voxelUsed.p[i];
+    float* sum = voxelSum.p+3*slot;
+    float c = 1.f/float(voxelCount.p[slot]);
+    pts[3*i+0] = c*sum[0];
+    pts[3*i+1] = c*sum[1];
+    pts[3*i+2] = c*sum[2];
+    voxelKey.p[slot] = 0;
+  }
+  return m;
+}
+
+//===========================================================================
+
 void depthData2pointCloud(arr& pts, const floatA& depth, float fx, float fy, float cx, float cy) {
   uint H=depth.d0, W=depth.d1;
 
@@ -13,18 +13,67 @@
 
 #include <math.h>
 
+//===========================================================================
+
+struct DepthStream_Options {
+  RAI_PARAM("DepthStream/", int, stride, 1) //use only every stride-th row and column
+  RAI_PARAM("DepthStream/", double, voxelSize, 0.) //>0: replace all points within a voxel by their mean
+  RAI_PARAM("DepthStream/", double, minDepth, 0.) //pixels with depth outside (minDepth, maxDepth) are dropped
+  RAI_PARAM("DepthStream/", double, maxDepth, 10.)
+  RAI_PARAM("DepthStream/", int, ringSize, 3)
+};
+
+/** Streaming conversion of depth images to (n,3) float point clouds, optionally transformed to the world frame.
+ *  All buffers are allocated on the first frame (or when the image size changes) and reused thereafter. Results
+ *  are written round-robin into a ring of output buffers: the returned array refers into the ring and remains
+ *  valid for the next ringSize-1 calls -- copy it to keep it longer or to hand it to another thread. Unlike
+ *  depthData2pointCloud's (H,W,3) layout, only pixels with depth in (minDepth, maxDepth) are kept (e.g. no
+ *  zero-depth holes), so the number of points varies per frame. The inner loops are plain float loops over rows
+ *  that the compiler vectorizes. Options and intrinsics are read when the first frame (of a new image size) is
+ *  processed. */
+struct DepthStream {
+  DepthStream_Options opt;
+  float fx, fy, cx, cy;
+
+  DepthStream(float _fx, float _fy=NAN, float _cx=NAN, float _cy=NAN) : fx(_fx), fy(_fy), cx(_cx), cy(_cy) {}
+  DepthStream(const arr& fxycxy) : DepthStream(fxycxy.elem(0), fxycxy.elem(1), fxycxy.elem(2), fxycxy.elem(3)) {}
+
+  /// converts the depth image; X (if not zero) is the camera pose, so that points are returned in world coordinates
+  const floatA& process(const floatA& depth, const rai::Transformation& X=0);
+
+  uint revision=0; ///< number of processed frames
+  uint capacity() const { return ring.N ? ring(0).d0 : 0; } ///< maximal number of points per frame (0 before the first frame)
+
+ private:
+  uint H=0, W=0;
+  floatA colX, rowY;            ///< per column/row pixel-to-ray factors (j-cx)/fx and (i-cy)/fy
+  floatA rowBuf;                ///< (3,w) per row scratch: x,y,z of all pixels of a row (SoA, for vectorization)
+  rai::Array<floatA> ring, out; ///< output buffers (full size) and references into them
+  //-- voxel hash table (open addressing; all allocated once)
+  rai::Array<uint64_t> voxelKey;
+  floatA voxelSum;
+  uintA voxelCount, voxelUsed;
+  void setup(uint _H, uint _W);
+  uint voxelize(float* pts, uint n);
+};
+
+//===========================================================================
+
 struct Depth2PointCloud : Thread {
   //inputs
   Var<floatA> depth;
   Var<rai::Transformation> pose;
-  //outputs
-  Var<arr> points;
+  //outputs (in world coordinates if pose is set)
+  Var<arr> points;    ///< (H,W,3) point per pixel, as from depthData2pointCloud (zero for negative depth) -- only computed
+                      ///< while another Var refers to it, e.g. Var<arr> points(this, D.points)
+  Var<floatA> cloud;  ///< compact (n,3) cloud of the valid pixels only, downsampled by stream.opt -- n varies per frame; its
+                      ///< memory is kept at stream.capacity(), so publishing a frame is a copy without reallocation
 
-  float fx, fy, px, py;
+  DepthStream stream;
   floatA _depth;
   arr _points;
 
-  Depth2PointCloud(Var<floatA>& _depth, float _fx=NAN, float _fy=NAN, float _px=NAN, float _py=NAN);
+  Depth2PointCloud(Var<floatA>& _depth, float _fx=NAN, float _fy=NAN, float _cx=NAN, float _cy=NAN);
   Depth2PointCloud(Var<floatA>& _depth, const arr& fxycxy);
   virtual ~Depth2PointCloud();
 
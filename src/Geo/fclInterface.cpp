@@ -7,6 +7,7 @@
     --------------------------------------------------------------  */
 
 #include "fclInterface.h"
+#include "../Core/profiler.h"
 
 #ifdef RAI_FCL
 
@@ -59,7 +60,7 @@ struct FclInterface_self {
   static bool BroadphaseCallback(CollObject* o1, CollObject* o2, void* cdata_);
 };
 
-FclInterface::FclInterface(const Array<Shape*>& geometries, const uintAA& _excludes, QueryMode _mode)
+FclInterface::FclInterface(const Array<Shape*>& geometries, const shared_ptr<CollisionMatrix>& _excludes, QueryMode _mode)
   : mode(_mode), excludes(_excludes) {
   self = new FclInterface_self;
 
@@ -145,6 +146,7 @@ void FclInterface::setActiveColliders(uintA geom_ids){
 }
 
 void FclInterface::step(const arr& X) {
+  RAI_PROFILE("FclInterface::step");
   CHECK_EQ(X.nd, 2, "");
   CHECK_GE(X.d0, self->convexGeometryData.N, "");
   CHECK_EQ(X.d1, 7, "");
@@ -186,13 +188,7 @@ bool FclInterface_self::BroadphaseCallback(CollObject* o1, CollObject* o2, void*
   uint b = (long int)o2->getUserData();
   if(a==b) return false;
 
-  if(fcl->excludes.N) {
-    if(a<b) {
-      if(fcl->excludes(a).containsInSorted(b)) return false;
-    } else {
-      if(fcl->excludes(b).containsInSorted(a)) return false;
-    }
-  }
+  if(fcl->excludes && (*fcl->excludes)(a, b)) return false;
 
   if(fcl->mode==fcl->_broadPhaseOnly) {
     fcl->addCollision(a, b);
@@ -220,11 +216,101 @@ bool FclInterface_self::BroadphaseCallback(CollObject* o1, CollObject* o2, void*
 
 #else //RAI_FCL
 typedef int QueryMode;
-rai::FclInterface::FclInterface(const Array<Shape*>& geometries, const uintAA& _excludes, QueryMode _mode){ NICO }
+rai::FclInterface::FclInterface(const Array<Shape*>& geometries, const shared_ptr<CollisionMatrix>& _excludes, QueryMode _mode){ NICO }
 rai::FclInterface::~FclInterface() { NICO }
 void rai::FclInterface::step(const arr& X) { NICO }
 #endif
 
+//===========================================================================
+
+rai::CollisionMatrix::CollisionMatrix(uint _n, const uintAA& excludes) {
+  resize(_n);
+  for(uint a=0; a<excludes.N; a++) for(uint b:excludes(a)) set(a, b);
+}
+
+void rai::CollisionMatrix::resize(uint _n) {
+  if(_n==n) return;
+  if(_n<n) { //rebuild from the pairs within the new range, dropping the rows beyond
+    uintAA pairs = getPairs();
+    rows.clear(); IDs.clear(); bits.clear(); words=0;
+    n=_n;
+    rows.resize(n) = -1;
+    for(uint a=0; a<n; a++) for(uint b:pairs(a)) if(b<n) set(a, b);
+    return;
+  }
+  rows.resizeCopy(_n);
+  for(uint a=n; a<_n; a++) rows.p[a] = -1;
+  n=_n;
+}
+
+uint rai::CollisionMatrix::row(uint a) {
+  if(rows.p[a]>=0) return rows.p[a];
+  uint i = IDs.N;
+  IDs.append(a);
+  rows.p[a] = i;
+  if(IDs.N>64*words) { //widen all rows
+    uint _words = words ? 2*words : 1;
+    std::vector<uint64_t> _bits(IDs.N*_words, 0);
+    for(uint r=0; r<i; r++) for(uint w=0; w<words; w++) _bits[r*_words+w] = bits[r*words+w];
+    words=_words;
+    bits.swap(_bits);
+  } else {
+    bits.resize(IDs.N*words, 0);
+  }
+  return i;
+}
+
+void rai::CollisionMatrix::set(uint a, uint b, bool excluded) {
+  CHECK(a<n && b<n, "pair (" <<a <<',' <<b <<") out of range " <<n);
+  if(excluded) {
+    uint i=row(a), j=row(b);
+    bits[i*words + (j>>6)] |= uint64_t(1)<<(j&63);
+    bits[j*words + (i>>6)] |= uint64_t(1)<<(i&63);
+  } else {
+    int i=rows.p[a], j=rows.p[b];
+    if(i<0 || j<0) return;
+    bits[i*words + (j>>6)] &= ~(uint64_t(1)<<(j&63));
+    bits[j*words + (i>>6)] &= ~(uint64_t(1)<<(i&63));
+  }
+}
+
+void rai::CollisionMatrix::clearRow(uint a) {
+  if(a>=n || rows.p[a]<0) return;
+  uint i = rows.p[a];
+  for(uint w=0; w<words; w++) {
+    uint64_t x = bits[i*words+w];
+    while(x) { //clear the transposed entries of all set bits
+      uint j = w*64 + __builtin_ctzll(x);
+      bits[j*words + (i>>6)] &= ~(uint64_t(1)<<(i&63));
+      x &= x-1;
+    }
+    bits[i*words+w] = 0;
+  }
+}
+
+uint rai::CollisionMatrix::count() const {
+  uint c=0, diag=0;
+  for(uint64_t x:bits) c += __builtin_popcountll(x);
+  for(uint i=0; i<IDs.N; i++) if((bits[i*words + (i>>6)] >> (i&63)) & 1) diag++;
+  return (c+diag)/2;
+}
+
+uintAA rai::CollisionMatrix::getPairs() const {
+  uintAA ex(n);
+  for(uint i=0; i<IDs.N; i++) {
+    uint a = IDs(i);
+    for(uint w=0; w<words; w++) {
+      uint64_t x = bits[i*words+w];
+      while(x) {
+        uint b = IDs(w*64 + __builtin_ctzll(x));
+        if(b>a) ex(a).append(b);
+        x &= x-1;
+      }
+    }
+  }
+  for(uintA& e:ex) e.sort();
+  return ex;
+}
 
 RUN_ON_INIT_BEGIN(fclInterface)
 rai::Array<CollObject*>::memMove=true;
@@ -12,16 +12,51 @@
 
 namespace rai {
 
+/// symmetric bit matrix of excluded (never colliding) pairs, indexed by frame ID; O(1) queries. Only IDs that are part of
+/// an excluded pair get a row (in practice the collidable shapes), so its size is quadratic in those, not in all IDs
+struct CollisionMatrix {
+  uint n=0; ///< the range of IDs
+  intA rows; ///< ID -> row, -1 for IDs without row (never excluded)
+  uintA IDs; ///< row -> ID
+  uint words=0; ///< 64-bit words per row
+  std::vector<uint64_t> bits;
+
+  CollisionMatrix(uint _n=0) { resize(_n); }
+  CollisionMatrix(uint _n, const uintAA& excludes);
+
+  void resize(uint _n); ///< keeps the entries of IDs below _n
+  void clear() { std::fill(bits.begin(), bits.end(), 0); }
+
+  /// true if the pair (a,b) is excluded; IDs beyond n are never excluded
+  bool operator()(uint a, uint b) const {
+    if(a>=n || b>=n) return false;
+    int i=rows.p[a], j=rows.p[b];
+    if(i<0 || j<0) return false;
+    return (bits[i*words + (j>>6)] >> (j&63)) & 1;
+  }
+  void set(uint a, uint b, bool excluded=true); ///< sets both (a,b) and (b,a)
+  void clearRow(uint a); ///< clears row and column a
+  uint count() const; ///< number of excluded pairs
+  uintAA getPairs() const; ///< in the format of Configuration::getCollisionExcludePairIDs: a list of larger IDs for each ID
+
+ private:
+  uint row(uint a); ///< the row of ID a, added if it has none
+};
+
+//===========================================================================
+
 struct FclInterface {
   struct FclInterface_self* self=0;
   enum QueryMode { _broadPhaseOnly, _binaryCollisionSingle, _binaryCollisionAll, _distanceCutoff, _fine } mode;
 
   double cutoff=.01;
-  uintAA excludes;
+  shared_ptr<CollisionMatrix> excludes; ///< shared with the Configuration, which updates it incrementally
   uintA collisions; //return values!
   arr X_lastQuery;  //memory to check whether an object has moved in consecutive queries
 
-  FclInterface(const Array<Shape*>& geometries, const uintAA& _excludes, QueryMode _mode);
+  FclInterface(const Array<Shape*>& geometries, const shared_ptr<CollisionMatrix>& _excludes, QueryMode _mode);
+  FclInterface(const Array<Shape*>& geometries, const uintAA& _excludes, QueryMode _mode)
+    : FclInterface(geometries, make_shared<CollisionMatrix>(geometries.N, _excludes), _mode) {}
   ~FclInterface();
 
   void setActiveColliders(uintA geom_ids);
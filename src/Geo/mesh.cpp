@@ -10,6 +10,7 @@
 #include "qhull.h"
 #include "assimpInterface.h"
 #include "stbImage.h"
+#include "assetCache.h"
 
 #include "../Algo/ann.h"
 #include "../Optim/newton.h"
@@ -67,8 +68,7 @@ SharedTextureImage& Mesh::texImg(const char* file){
 }
 
 void clearAssetMeshesTextures(){
-  NodeL M = params()->findNodesOfType(typeid(shared_ptr<rai::Mesh>));
-  for(Node *n:M) delete n;
+  rai::assetCache().clear();
   NodeL T = params()->findNodesOfType(typeid(shared_ptr<SharedTextureImage>));
   for(Node *n:T) delete n;
 }
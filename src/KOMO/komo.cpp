@@ -17,6 +17,7 @@
 //#include "../KOMO/switch.h"
 #include "../Kin/proxy.h"
 #include "../Kin/dof_forceExchange.h"
+#include "../Kin/dof_direction.h"
 //#include "../Kin/kin_swift.h"
 //#include "../Kin/kin_physx.h"
 #include "../Kin/F_qFeatures.h"
@@ -36,6 +37,7 @@
 #include "../Optim/NLP_Solver.h"
 
 #include "../Core/util.ipp"
+#include "../Core/profiler.h"
 
 #include "pathTools.h"
 
@@ -144,6 +146,8 @@ void KOMO::clone(const KOMO& komo, bool deepCopyFeatures) {
     std::shared_ptr<Feature> f = o->feat;
     if(deepCopyFeatures) f = f->deepCopy();
     objectives.append(make_shared<Objective>(f, o->type, o->name, o->times));
+    objectives.last()->deltaFromStep = o->deltaFromStep;
+    objectives.last()->deltaToStep = o->deltaToStep;
   }
 
   //copy grounded objectives
@@ -153,7 +157,71 @@ void KOMO::clone(const KOMO& komo, bool deepCopyFeatures) {
     objs.append(make_shared<GroundedObjective>(f, o->type, o->timeSlices));
     objs(-1)->frames = pathConfig.getFrames(framesToIndices(o->frames));
     objs(-1)->objId = o->objId;
+    if(o->objId>=0) objectives(o->objId)->groundings.append(objs(-1).get());
+  }
+}
+
+bool KOMO::hasForceExchanges() const {
+  for(rai::Frame* f:pathConfig.frames) if(f->forces.N) return true;
+  return false;
+}
+
+void KOMO::addPhases(uint phases) {
+  CHECK_EQ(timeSlices.d0, k_order+T, "path config is not setup");
+  CHECK_EQ(timeSlices.N, pathConfig.frames.N, "pathConfig contains frames beyond the timeSlices");
+  CHECK(!hasForceExchanges(), "new slices would not copy force exchange dofs -- set up the problem from scratch");
+  if(!phases) return;
+
+  //-- append slices, each a copy of the previous one (with all switches applied so far, and its joint state)
+  uint T0 = T;
+  uint n = phases*stepsPerPhase;
+  uint d1 = timeSlices.d1;
+  pathConfig.setFrameOrder(timeSlices);
+  FrameL newSlices(n, d1);
+  for(uint t=0; t<n; t++) {
+    FrameL prev = (t ? newSlices[t-1] : timeSlices[timeSlices.d0-1]);
+    uint prevStart = prev(0)->ID;
+    for(uint i=0; i<d1; i++) newSlices(t, i) = new Frame(pathConfig, prev(i));
+    for(uint i=0; i<d1; i++) {
+      Frame* f = newSlices(t, i);
+      Frame* p = prev(i);
+      f->prev = p;
+      f->time = p->time + f->tau;
+      if(p->parent) {
+        CHECK(p->parent->ID>=prevStart && p->parent->ID<prevStart+d1, "frame '" <<p->name <<"' has a parent outside its slice");
+        f->setParent(newSlices(t, p->parent->ID-prevStart), false);
+      }
+      //mimics within the slice refer to the new slice; stable dofs mimic the first application of their mode
+      if(p->joint) {
+        Dof* m = p->joint->mimic;
+        if(m && m->frame->ID>=prevStart && m->frame->ID<prevStart+d1) f->joint->setMimic(newSlices(t, m->frame->ID-prevStart)->joint, true);
+        else if(m) f->joint->setMimic(m, true);
+        else if(p->joint->isStable && opt.mimicStable) f->joint->setMimic(p->joint, true);
+        else f->joint->setMimic(0);
+      }
+      if(p->dirDof && p->dirDof->isStable) f->dirDof->setMimic(p->dirDof->mimic ? p->dirDof->mimic : p->dirDof, true);
+    }
+  }
+  timeSlices = pathConfig.frames;
+  timeSlices.reshape(-1, d1);
+  pathConfig.frames.reshape(-1, d1);
+  T += n;
+  pathConfig.calc_indexedActiveJoints();
+
+  //-- ground objectives on the tuples the longer horizon adds: open-ended ones are extended, and those clipped at the old end
+  //   appear (objectives relative to the end, with negative times, stay where they are)
+  for(uint i=0; i<objectives.N; i++) {
+    std::shared_ptr<Objective>& ob = objectives(i);
+    if(ob->times.N && ob->times(0)<0.) continue;
+    intA tuples = conv_times2tuples(ob->times, ob->feat->order, stepsPerPhase, T, ob->deltaFromStep, ob->deltaToStep);
+    intA old = conv_times2tuples(ob->times, ob->feat->order, stepsPerPhase, T0, ob->deltaFromStep, ob->deltaToStep);
+    int last = old.d0 ? old(-1, -1) : -1;
+    for(uint c=tuples.d0; c--;) if(tuples(c, -1)<=last) tuples.delRows(c);
+    if(tuples.d0) _addGroundings(ob, i, tuples);
   }
+
+  x = pathConfig.getJointState();
+  reset();
 }
 
 void KOMO::addTimeOptimization() {
@@ -213,14 +281,17 @@ void KOMO::copyObjectives(KOMO& komoB, bool deepCopyFeatures) {
 
 void KOMO::_addObjective(const std::shared_ptr<Objective>& ob, const intA& timeSlices) {
   objectives.append(ob);
+  _addGroundings(ob, objectives.N-1, timeSlices);
+}
 
+void KOMO::_addGroundings(const std::shared_ptr<Objective>& ob, uint objId, const intA& timeSlices) {
   CHECK_EQ(timeSlices.nd, 2, "");
   CHECK_EQ(timeSlices.d1, ob->feat->order+1, "");
   for(uint c=0; c<timeSlices.d0; c++) {
     shared_ptr<GroundedObjective> o = make_shared<GroundedObjective>(ob->feat, ob->type, timeSlices[c]);
     objs.append(o);
     ob->groundings.append(o.get());
-    o->objId = objectives.N-1;
+    o->objId = objId;
     o->frames.resize(timeSlices.d1, o->feat->frameIDs.N);
     for(uint i=0; i<timeSlices.d1; i++) {
       int s = timeSlices(c, i) + k_order;
@@ -252,6 +323,8 @@ shared_ptr<Objective> KOMO::addObjective(const arr& times,
   //-- create a (non-grounded) objective
   CHECK_GE(k_order, f->order, "task requires larger k-order: " <<f->shortTag(world));
   std::shared_ptr<Objective> o = make_shared<Objective>(f, type, f->shortTag(world), times);
+  o->deltaFromStep = deltaFromStep;
+  o->deltaToStep = deltaToStep;
 
   //-- create the grounded objectives
   _addObjective(o, timeSlices);
@@ -1230,6 +1303,7 @@ void KOMO::reset() {
   featureJacobians.clear();
   featureTypes.clear();
   timeTotal=timeCollisions=timeKinematics=timeNewton=timeFeatures=0.;
+  evalAllocs = rai::ArrayAllocStats();
 }
 
 std::shared_ptr<SolverReturn> KOMO::solve(double addInitializationNoise, int splineKnots, const OptOptions& options) {
@@ -1251,14 +1325,15 @@ std::shared_ptr<SolverReturn> KOMO::solve(double addInitializationNoise, int spl
   // sol.setSolver(NLPS_Ipopt);
   sol.opt.set_verbose(rai::MAX(opt.verbose-2, 0));
 
-  timeTotal -= rai::cpuTime();
+  rai::ProfileZone zoneTotal("KOMO optimization", timeTotal);
   std::shared_ptr<SolverReturn> ret = sol.solve();
-  timeTotal += rai::cpuTime();
+  zoneTotal.end();
 
   if(opt.verbose>0) {
     cout <<"=== KOMO optimization time:" <<timeTotal
          <<" (kin:" <<timeKinematics <<" coll:" <<timeCollisions <<" feat:" <<timeFeatures <<" newton: " <<timeNewton <<")"
          <<" setJointStateCount:" <<Configuration::setJointStateCount
+         <<"\n  evaluation " <<evalAllocs
          <<"\n  solver return: " <<*ret <<endl;
   }
   if(opt.verbose>1) cout <<report(false, opt.verbose>2, opt.verbose>2) <<endl;
@@ -1720,11 +1795,7 @@ rai::Frame* KOMO::addFrameDof(const char* name, const char* parent,
     for(uint s=0; s<timeSlices.d0; s++) { timeSlices(s, -2) = F(s);  timeSlices(s, -1) = O(s); }
   }
   CHECK_EQ(timeSlices.d1, world.frames.N, "");
-  if(timeSlices.N==pathConfig.frames.N) {
-    pathConfig.frames = timeSlices;
-    uint i=0;
-    for(Frame* f: pathConfig.frames) f->ID = i++;
-  }
+  if(timeSlices.N==pathConfig.frames.N) pathConfig.setFrameOrder(timeSlices);
   return f0;
 }
 
@@ -1866,7 +1937,7 @@ void KOMO::setupPathConfig() {
 void KOMO::set_x(const arr& x, const uintA& selectedConfigurationsOnly) {
   CHECK_EQ(timeSlices.d0, k_order+T, "configurations are not setup yet");
 
-  timeKinematics -= rai::cpuTime();
+  rai::ProfileZone zone("KOMO kinematics", timeKinematics);
 
   if(!selectedConfigurationsOnly.N) {
     pathConfig.setJointState(x);
@@ -1875,29 +1946,34 @@ void KOMO::set_x(const arr& x, const uintA& selectedConfigurationsOnly) {
     HALT("this is untested...");
   }
 
-  timeKinematics += rai::cpuTime();
+  zone.end();
 
   if(computeCollisions) {
     if(!fcl) {
-      fcl = world.coll_fcl();
-      fcl->mode = fcl->_broadPhaseOnly;
+      //a broadphase over the world's shapes without the world's filter: switches change the excluded pairs of each slice,
+      //which the filter of pathConfig decides (and updates with each switch)
+      fcl = make_shared<rai::FclInterface>(world.coll_shapes(), shared_ptr<rai::CollisionMatrix>(), rai::FclInterface::_broadPhaseOnly);
     }
-    timeCollisions -= rai::cpuTime();
+    rai::ProfileZone zoneCollisions("KOMO collisions", timeCollisions);
+    const rai::CollisionMatrix& excludes = *pathConfig.coll_filter();
     pathConfig.proxies.clear();
     arr X;
     uintA collisionPairs;
     for(uint s=k_order; s<timeSlices.d0; s++) {
       X = pathConfig.getFrameState(timeSlices[s]);
-      {
-        fcl->step(X);
-        collisionPairs = fcl->collisions;
+      fcl->step(X);
+      //fcl returns frame IDs related to 'world' -> map them into frameIDs within that time slice
+      uint offset = timeSlices.d1 * s;
+      collisionPairs.clear();
+      for(uint i=0; i<fcl->collisions.d0; i++) {
+        uint a = fcl->collisions(i, 0)+offset, b = fcl->collisions(i, 1)+offset;
+        if(!excludes(a, b)) collisionPairs.append({a, b});
       }
-      collisionPairs += timeSlices.d1 * s; //fcl returns frame IDs related to 'world' -> map them into frameIDs within that time slice
+      collisionPairs.reshape(-1, 2);
       pathConfig.addProxies(collisionPairs);
     }
     pathConfig._state_proxies_isGood=true;
     pathConfig.ensure_proxies(); //expensive!!
-    timeCollisions += rai::cpuTime();
   }
 }
 
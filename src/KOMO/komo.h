@@ -10,6 +10,7 @@
 
 #include "objective.h"
 #include "../Kin/kin.h"
+#include "../Kin/feature.h"
 #include "../Optim/options.h"
 
 //===========================================================================
@@ -35,6 +36,8 @@ struct KOMO_Options {
   RAI_PARAM("KOMO/", bool, mimicStable, true)
   RAI_PARAM("KOMO/", double, sampleRate_stable, .0)
   RAI_PARAM("KOMO/", bool, sparse, true)
+  RAI_PARAM("KOMO/", bool, memoFeatures, true) //compute each feature value only once per evaluation (see FeatureMemo; test/KOMO/komo FeatureMemo)
+  RAI_PARAM("KOMO/", bool, arrayArena, false) //allocate array temporaries of evaluations from a rai::ArrayArena
 };
 }//namespace
 
@@ -56,6 +59,7 @@ struct KOMO : NonCopyable {
   FrameL timeSlices;              ///< the original timeSlices of the pathConfig (when switches add frames, pathConfig.frames might differ from timeSlices - otherwise not)
   bool computeCollisions=true;    ///< whether swift or fcl (collisions/proxies) is evaluated whenever new configurations are set (needed if features read proxy list)
   shared_ptr<rai::FclInterface> fcl;
+  FeatureMemo featureMemo;        ///< feature values of the current evaluation, shared by finite difference and duplicate objectives
 
   //-- optimizer
   arr x, dual;                    ///< the primal and dual solution
@@ -69,6 +73,7 @@ struct KOMO : NonCopyable {
   ObjectiveTypeA featureTypes; ///< storage of all feature-types in all time slices
   StringA featureNames;
   double timeTotal=0., timeCollisions=0., timeKinematics=0., timeNewton=0., timeFeatures=0.; ///< measured run times
+  rai::ArrayAllocStats evalAllocs; ///< array memory operations during evaluations
   uint evalCount=0;
 
   KOMO();
@@ -80,6 +85,8 @@ struct KOMO : NonCopyable {
   void setTiming(double _phases, uint _stepsPerPhase, double durationPerPhase=5., uint _k_order=2);
 
   void clone(const KOMO& komo, bool deepCopyFeatures=true);
+  void addPhases(uint phases); ///< extend the horizon; new slices copy the last slice (incl. switches, warm start); objectives are grounded also on the tuples the longer horizon adds (open-ended ones, and those clipped at the old end); not with force exchanges
+  bool hasForceExchanges() const;
 
   //-- higher-level default setups
   void setIKOpt(); ///< setTiming(1., 1, 1., 1); and velocity objective
@@ -239,6 +246,7 @@ public:
 
 //private:
   void _addObjective(const std::shared_ptr<Objective>& ob, const intA& timeSlices);
+  void _addGroundings(const std::shared_ptr<Objective>& ob, uint objId, const intA& timeSlices);
 };
 
 int conv_time2step(double time, uint stepsPerPhase);
@@ -12,6 +12,7 @@
 #include "../Kin/proxy.h"
 #include "../Kin/dof_forceExchange.h"
 #include "../Algo/spline.h"
+#include "../Core/profiler.h"
 
 namespace rai {
 
@@ -60,6 +61,9 @@ KOMO_NLP::KOMO_NLP(KOMO& _komo) : komo(_komo) {
 }
 
 void KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
+  RAI_PROFILE("KOMO_NLP::evaluate");
+  rai::ArrayArena::Scope arena(komo.opt.arrayArena);
+  rai::ArrayAllocCounter allocs;
   komo.evalCount++;
 
   //-- set the trajectory
@@ -79,7 +83,10 @@ void KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
     }
   }
 
-  komo.timeFeatures -= cpuTime();
+  rai::ProfileZone zoneFeatures("KOMO features", komo.timeFeatures);
+
+  komo.featureMemo.clear();
+  FeatureMemo::Scope memoScope(komo.opt.memoFeatures ? &komo.featureMemo : 0);
 
   uint M=0;
   for(shared_ptr<GroundedObjective>& ob : komo.objs) {
@@ -113,8 +120,9 @@ void KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
     //counter for features phi
     M += y.N;
   }
+  komo.featureMemo.clear(); //don't keep Jacobians beyond the evaluation
 
-  komo.timeFeatures += cpuTime();
+  zoneFeatures.end();
 
   CHECK_EQ(M, phi.N, "");
   komo.featureValues = phi;
@@ -126,6 +134,7 @@ void KOMO_NLP::evaluate(arr& phi, arr& J, const arr& x) {
     phi.append((~x * quadraticPotentialHessian * x).scalar() + scalarProduct(quadraticPotentialLinear, x));
     J.append(quadraticPotentialLinear);
   }
+  komo.evalAllocs += allocs();
 }
 
 void KOMO_NLP::getFHessian(arr& H, const arr& x) {
@@ -182,18 +191,21 @@ arr KOMO_SubNLP::getInitializationSample() {
 }
 
 void KOMO_SubNLP::evaluate(arr& phi, arr& J, const arr& x) {
+  RAI_PROFILE("KOMO_SubNLP::evaluate");
+  rai::ArrayArena::Scope arena(komo.opt.arrayArena);
+  rai::ArrayAllocCounter allocs;
   evalCount++;
 
   //-- set the trajectory
-  komo.timeKinematics -= rai::cpuTime();
+  rai::ProfileZone zone("KOMO kinematics", komo.timeKinematics);
 
   komo.pathConfig.setJointState(x);
   komo.pathConfig.jacMode = Configuration::JM_sparse;
 
-  komo.timeKinematics += rai::cpuTime();
+  zone.end();
 
   //-- compute features
-  komo.timeFeatures -= cpuTime();
+  rai::ProfileZone zoneFeatures("KOMO features", komo.timeFeatures);
 
   phi.resize(featureTypes.N);
   if(!!J) J.sparse().resize(phi.N, x.N, 0);
@@ -225,11 +237,12 @@ void KOMO_SubNLP::evaluate(arr& phi, arr& J, const arr& x) {
   }
   CHECK_EQ(M, phi.N, "");
 
-  komo.timeFeatures += cpuTime();
+  zoneFeatures.end();
 
 //  komo.featureValues = phi;
 //  if(!!J) komo.featureJacobians.resize(1).scalar() = J;
 //  reportAfterPhiComputation(komo);
+  komo.evalAllocs += allocs();
 }
 
 void KOMO_SubNLP::getFHessian(arr& H, const arr& x) {
@@ -28,6 +28,7 @@ struct Objective {
   ObjectiveType type;  ///< element of {f, sumOfSqr, inequality, equality}
   rai::String name;
   arr times;
+  int deltaFromStep=0, deltaToStep=0; ///< step offsets of the interval given by times (kept to reground, e.g. in addPhases)
   rai::Array<struct GroundedObjective*> groundings;
 
   Objective(const shared_ptr<Feature>& _feat, const ObjectiveType& _type, const rai::String& _name, const arr& _times)
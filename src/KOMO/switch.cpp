@@ -119,6 +119,7 @@ rai::Frame* rai::KinematicSwitch::apply(FrameL& frames) const {
     to->_state_updateAfterTouchingQ();
 
     to->joint->isStable = isStable;
+    to->C.coll_updateFilter(to);
 
     //K.reset_q();
     //K.calc_q(); K.checkConsistency();
@@ -134,6 +135,7 @@ rai::Frame* rai::KinematicSwitch::apply(FrameL& frames) const {
 
     if(to->parent) to->unLink();
     to->setParent(from, true);
+    to->C.coll_updateFilter(to);
     return to;
   }
 
@@ -192,7 +192,7 @@ void F_AccumulatedCollisions::phi2(arr& y, arr& J, const FrameL& F) {
   for(rai::Proxy& p: C.proxies) {
     bool isSelected = (p.a->ID>=firstID && p.a->ID<=lastID)
                    || (p.b->ID>=firstID && p.b->ID<=lastID);
-    if(isSelected) {
+    if(isSelected && !C.coll_isExcluded(p.a->ID, p.b->ID)) {
       CHECK(p.a->shape, "");
       CHECK(p.b->shape, "");
 
@@ -11,6 +11,7 @@
 #include "F_pose.h"
 #include "frame.h"
 #include "dof_forceExchange.h"
+#include "kin_feather.h"
 #include "F_collisions.h"
 #include "../Geo/pairCollision.h"
 
@@ -454,6 +455,70 @@ void F_Energy::phi2(arr& y, arr& J, const FrameL& F) {
 
 //===========================================================================
 
+uint F_JointTorques::dim_phi(const FrameL& F) {
+  CHECK_EQ(F.d0, 3, "");
+  return FeatherstoneInterface::dim(F[1]);
+}
+
+FeatherstoneInterface& F_JointTorques::getTree(rai::Configuration& C, const FrameL& frames) {
+  if(&C!=treesC) { trees.clear(); treesC=&C; }
+  std::shared_ptr<FeatherstoneInterface>& fs = trees[frames.elem(0)];
+  if(!fs || !(fs->sortedFrames==frames)) { //new slice, or frames changed
+    fs = make_shared<FeatherstoneInterface>(C, frames);
+  }
+  return *fs;
+}
+
+void F_JointTorques::phi2(arr& y, arr& J, const FrameL& F) {
+  CHECK_EQ(order, 2, "");
+  CHECK_EQ(F.d0, 3, "");
+  rai::Configuration& C = F.last()->C;
+  CHECK(C._state_q_isGood, "");
+
+  //-- the tree of the mid slice
+  FeatherstoneInterface& fs = getTree(C, F[1]);
+  fs.update();
+  fs.setGravity(-gravity);
+  uint n = dim_phi(F);
+
+  //-- joint states of all three slices (and their indices in C.q; -1 if inactive), in the dof order of the tree
+  arr q(3, n);
+  intA qIndex(3, n);
+  for(uint s=0; s<3; s++) for(uint i=0; i<F.d1; i++) {
+      int d = fs.tree(i).qIndex;
+      if(d==-1) continue;
+      rai::Joint* j = F(s, i)->joint;
+      CHECK(j && j->type==fs.tree(i).type, "joint of frame '" <<F(1, i)->name <<"' differs over time slices");
+      if(j->active) { q(s, d) = C.q(j->qIndex);  qIndex(s, d) = j->qIndex; }
+      else { q(s, d) = C.qInactive(j->qIndex);  qIndex(s, d) = -1; }
+    }
+
+  double tau; arr Jtau;
+  C.kinematicsTau(tau, Jtau, F.elem(-1));
+  CHECK_GE(tau, 1e-10, "");
+  arr qd = (q[1]-q[0])/tau;
+  arr qdd = (q[2]-2.*q[1]+q[0])/(tau*tau);
+
+  if(!J) { fs.invDynamics(y, qd, qdd);  return; }
+
+  //-- torques and their derivatives w.r.t. q, qd, qdd (=M) of the mid slice, chained through the finite differences
+  arr tau_q, tau_qd, M;
+  fs.invDynamics(y, qd, qdd, tau_q, tau_qd, M);
+  arr J_slice[3] = { M/(tau*tau) - tau_qd/tau, tau_q + tau_qd/tau - M*(2./(tau*tau)), M/(tau*tau) };
+
+  C.jacobian_zero(J, n);
+  for(uint s=0; s<3; s++) for(uint c=0; c<n; c++) {
+      if(qIndex(s, c)==-1) continue;
+      for(uint r=0; r<n; r++) {
+        double Jrc = J_slice[s](r, c);
+        if(Jrc) J.elem(r, qIndex(s, c)) += Jrc;
+      }
+    }
+  if(Jtau.N) J += (-1./tau)*(tau_qd*qd + 2.*M*qdd)*Jtau;
+}
+
+//===========================================================================
+
 FrameL getShapesAbove(rai::Frame* a) {
   FrameL aboves;
   if(a->shape) aboves.append(a);
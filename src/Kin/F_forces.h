@@ -10,6 +10,8 @@
 
 #include "feature.h"
 
+struct FeatherstoneInterface;
+
 //===========================================================================
 // trivial read out of forces
 
@@ -88,6 +90,25 @@ struct F_Energy : Feature {
   virtual uint dim_phi(const FrameL& F) {  return 1;  }
 };
 
+/// the joint torques (recursive Newton-Euler, gravity only) of the given frames (e.g. all frames of a robot, parents before
+/// children, see FeatherstoneInterface), for velocities and accelerations from finite differences of (q_{t-1}, q_t, q_{t+1});
+/// with exact Jacobians, e.g. for torque limit constraints along a path
+struct F_JointTorques : Feature {
+  double gravity=9.81;
+  F_JointTorques() {
+    order=2;
+    gravity = rai::getParameter<double>("gravity", 9.81);
+  }
+  F_JointTorques(const F_JointTorques& f) : Feature(f), gravity(f.gravity) {} //copies build their own trees
+  virtual void phi2(arr& y, arr& J, const FrameL& F);
+  virtual uint dim_phi(const FrameL& F);
+
+ private:
+  rai::Configuration* treesC=0;
+  std::map<rai::Frame*, std::shared_ptr<FeatherstoneInterface>> trees; //per time slice (keyed by its first frame), built once
+  FeatherstoneInterface& getTree(rai::Configuration& C, const FrameL& frames);
+};
+
 //===========================================================================
 // force geometry, complementarity, velocities
 
@@ -26,16 +26,19 @@ struct F_Position : Feature {
   F_Position(const rai::Vector& _relPos=0) : relPos(_relPos) {}
   virtual arr phi(const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 3; }
+  virtual uint64_t signature() { return typeSignature({relPos.x, relPos.y, relPos.z}); }
 };
 
 struct F_PositionDiff : Feature {
   virtual arr phi(const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 3; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 struct F_PositionRel : Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 3; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 //===========================================================================
@@ -52,6 +55,7 @@ struct F_Vector : Feature {
   F_Vector(const rai::Vector& _vec) : vec(_vec) {}
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 3; }
+  virtual uint64_t signature() { return typeSignature({vec.x, vec.y, vec.z}); }
 };
 
 struct F_VectorDiff : Feature {
@@ -95,17 +99,20 @@ struct F_Quaternion : Feature {
   F_Quaternion() { flipTargetSignOnNegScalarProduct = true; }
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 4; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 struct F_QuaternionDiff : Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 4; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 struct F_QuaternionRel: Feature {
   F_QuaternionRel() { flipTargetSignOnNegScalarProduct = true; }
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 4; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 //===========================================================================
@@ -113,16 +120,19 @@ struct F_QuaternionRel: Feature {
 struct F_Pose : Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 7; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 struct F_PoseDiff : Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 7; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 struct F_PoseRel : Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
   virtual uint dim_phi(const FrameL& F) { return 7; }
+  virtual uint64_t signature() { return typeSignature(); }
 };
 
 //===========================================================================
@@ -20,6 +20,7 @@ struct F_qItself : Feature {
 
   virtual arr phi(const FrameL& F);
   virtual uint dim_phi(const FrameL& F);
+  virtual uint64_t signature() { return typeSignature({double(relative_q0)}); }
  private:
   std::map<rai::Configuration*, uint> dimPhi;
 };
@@ -7,6 +7,7 @@
     --------------------------------------------------------------  */
 
 #include "feature.h"
+#include "../Core/profiler.h"
 
 //===========================================================================
 
@@ -18,15 +19,16 @@ arr Feature::phi_finiteDifferenceReduce(const FrameL& F) {
   order--;
   // arr y0 = phi(F({0, -2}));
   // arr y1 = phi(F({1, -1}));
-  arr y0 = phi(F({0, 0+order+1}));
-  arr y1 = phi(F({1, 1+order+1}));
+  arr buf0, buf1;
+  const arr& y0 = phi_memo(F({0, 0+order+1}), buf0); //memo values are used in place: no copies of values and Jacobians
+  const arr& y1 = phi_memo(F({1, 1+order+1}), buf1);
   order++;
   timeIntegral++;
 
-  if(flipTargetSignOnNegScalarProduct) if(scalarProduct(y0, y1)<-.0) { y0 *= -1.; }
-
   CHECK_EQ(y0.N, y1.N, "feature dim differs over time slices -- that's unusual. Possible case: qZeroVel across a switch, which happens in walker skeleton if the last entry does not indicate switch of robot");
-  arr y = y1-y0;
+  arr y;
+  if(flipTargetSignOnNegScalarProduct && scalarProduct(y0, y1)<-.0) y = y1+y0; //flip the sign of y0
+  else y = y1-y0;
 
   if(!y.N) return y;
 
@@ -105,6 +107,7 @@ FrameL Feature::getFrames(const rai::Configuration& C, uint s) {
 }
 
 arr Feature::phi(const FrameL& F) {
+  RAI_PROFILE("Feature::phi");
   arr y, J;
   phi2(y, J, F);
   if(!!J) {
@@ -115,6 +118,39 @@ arr Feature::phi(const FrameL& F) {
   return y;
 }
 
+thread_local FeatureMemo* FeatureMemo::active = 0;
+
+const arr& Feature::phi_memo(const FrameL& F, arr& buffer) {
+  FeatureMemo* memo = FeatureMemo::active;
+  if(!memo || !F.N) { buffer = phi(F); return buffer; }
+
+  //-- key: signature, everything else of this feature that phi depends on, and the frames
+  std::string key;
+  auto add = [&key](uint64_t x) { key.append((const char*)&x, sizeof(x)); };
+  add(signature());
+  add(order);
+  add((uint64_t)timeIntegral);
+  add(diffInsteadOfVel + 2*flipTargetSignOnNegScalarProduct);
+  add((uint64_t)&F.elem(0)->C);
+  add(F.d0); add(F.d1); add(F.d2);
+  for(rai::Frame* f:F) { uint32_t id = f ? f->ID : -1; key.append((const char*)&id, sizeof(id)); }
+
+  auto it = memo->values.find(key);
+  if(it!=memo->values.end()) { memo->hits++; return it->second; }
+  memo->misses++;
+  return memo->values.emplace(std::move(key), phi(F)).first->second; //element references are stable in an unordered_map
+}
+
+uint64_t Feature::typeSignature(const arr& params) {
+  uint64_t h = typeid(*this).hash_code();
+  for(double x:params) {
+    uint64_t b;
+    memcpy(&b, &x, sizeof(b));
+    h = (h ^ b) * 0x100000001b3ull;
+  }
+  return h;
+}
+
 void grabJ(arr& y, arr& J) {
   CHECK(&J != y.jac.get(), "");
   if(!!J) {
@@ -12,8 +12,27 @@
 #include "frame.h"
 #include "featureSymbols.h"
 
+#include <unordered_map>
+
 void grabJ(arr& y, arr& J);
 
+/// memo of feature values (with Jacobians) for a fixed configuration state, keyed by feature signature, order and frames:
+/// while a memo is active (within a FeatureMemo::Scope, e.g. one KOMO_NLP::evaluate), each value is computed only once
+/// and reused by higher-order (finite difference) features and duplicate features
+struct FeatureMemo {
+  std::unordered_map<std::string, arr> values;
+  uint hits=0, misses=0;
+
+  void clear() { values.clear(); }
+
+  static thread_local FeatureMemo* active;
+  struct Scope {
+    FeatureMemo* prev;
+    Scope(FeatureMemo* memo) : prev(active) { active=memo; } ///< nullptr: no memo within this scope
+    ~Scope() { active=prev; }
+  };
+};
+
 /// defines only a map (task space), not yet the costs or constraints in this space
 struct Feature {
   uint order = 0;          ///< 0=position, 1=vel, etc
@@ -45,7 +64,7 @@ struct Feature {
   virtual void phi2(arr& y, arr& J, const FrameL& F);
 
  public:
-  arr eval(const FrameL& F) { arr y = phi(F); applyLinearTrans(y); return y; }
+  arr eval(const FrameL& F) { arr y; const arr& v = phi_memo(F, y); if(&v!=&y) y = v; applyLinearTrans(y); return y; }
 //  Value eval(const FrameL& F) { arr y, J; eval(y, J, F); return Value(y, J); }
   arr eval(const rai::Configuration& C) { return eval(getFrames(C)); }
   uint dim(const FrameL& F) { uint d=dim_phi(F); return applyLinearTrans_dim(d); }
@@ -55,10 +74,16 @@ struct Feature {
   virtual rai::String shortTag(const rai::Configuration& C);
   virtual rai::Graph getSpec(const rai::Configuration& C) { return rai::Graph({{"description", shortTag(C)}}); }
   virtual std::shared_ptr<Feature> deepCopy();
+  /// features of equal signature have equal phi on equal frames (see FeatureMemo); default: only this feature itself
+  virtual uint64_t signature() { return (uint64_t)this; }
 
   //automatic finite difference definition of higher order features
   arr phi_finiteDifferenceReduce(const FrameL& F);
 
+ protected:
+  uint64_t typeSignature(const arr& params={}); ///< a signature from the type and parameters, for features that are otherwise parameter free
+  const arr& phi_memo(const FrameL& F, arr& buffer); ///< phi, looked up in (or stored to) the active FeatureMemo and returned in place; without memo computed into buffer
+
  private:
   void applyLinearTrans(arr& y);
   uint applyLinearTrans_dim(uint d);
@@ -65,6 +65,7 @@ template<> const char* rai::Enum<FeatureSymbol>::names []= {
   "physics",
   "contactConstraints",
   "energy",
+  "jointTorques",
 
   "transAccelerations",
   "transVelocities",
@@ -114,6 +115,7 @@ std::shared_ptr<Feature> Feature::deepCopy() {
   _cpy(F_AccumulatedCollisions);
   _cpy(F_NewtonEuler);
   _cpy(F_NewtonEuler_DampedVelocities);
+  _cpy(F_JointTorques);
   _cpy(F_fex_POASurfaceDistance);
   _cpy(F_fex_ForceIsNormal);
   _cpy(F_fex_ForceIsPositive);
@@ -123,6 +125,26 @@ std::shared_ptr<Feature> Feature::deepCopy() {
   _cpy(F_AboveBox);
   _cpy(F_PushRadiusPrior);
   _cpy(F_qZeroVel);
+  _cpy(F_qTime);
+  _cpy(F_Vector);
+  _cpy(F_VectorDiff);
+  _cpy(F_VectorRel);
+  _cpy(F_Quaternion);
+  _cpy(F_QuaternionDiff);
+  _cpy(F_QuaternionRel);
+  _cpy(F_AngVel);
+  _cpy(F_Energy);
+  _cpy(F_AlignWithDiff);
+  _cpy(F_GraspOppose);
+  _cpy(F_PairNormalAlign);
+  _cpy(F_fex_POAAtFrame);
+  _cpy(F_fex_ForceInFrameCone);
+  _cpy(F_fex_ForceInFrictionCone);
+  _cpy(F_fex_ForceIsComplementary);
+  _cpy(F_fex_POAzeroRelVel);
+  _cpy(F_fex_ElasticVel);
+  _cpy(F_fex_NormalVelIsComplementary);
+  _cpy(F_fex_POAContactDistances);
 #undef _cpy
   HALT("deepCopy not registered for this type: " <<rai::niceTypeidName(typeid(*this)));
   return make_shared<Feature>();
@@ -221,6 +243,7 @@ shared_ptr<Feature> symbols2feature(FeatureSymbol feat, const StringA& frames, c
   else if(feat==FS_physics) { f=make_shared<F_NewtonEuler>(); }
   else if(feat==FS_contactConstraints) { f=make_shared<F_fex_ForceIsNormal>(); }
   else if(feat==FS_energy) { f=make_shared<F_Energy>(); }
+  else if(feat==FS_jointTorques) { f=make_shared<F_JointTorques>(); }
 
   else if(feat==FS_transAccelerations) { HALT("obsolete"); /*f=make_shared<TM_Transition>(world);*/ }
   else if(feat==FS_transVelocities) {
@@ -63,6 +63,7 @@ enum FeatureSymbol : int {
   FS_physics,
   FS_contactConstraints,
   FS_energy,
+  FS_jointTorques,
 
   FS_transAccelerations,
   FS_transVelocities,
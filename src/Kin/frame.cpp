@@ -14,6 +14,7 @@
 #include "dof_direction.h"
 #include "../Geo/signedDistanceFunctions.h"
 #include "../Geo/stbImage.h"
+#include "../Geo/assetCache.h"
 
 #include <climits>
 
@@ -38,6 +39,86 @@ rai::Transformation& rai::Transformation_Qtoken::operator*() { return f.Q; }
 void rai::Transformation_Xtoken::operator=(const rai::Transformation& _X) { f.X=_X; }
 void rai::Transformation_Qtoken::operator=(const rai::Transformation& _Q) { f.Q=_Q; }
 
+//===========================================================================
+//
+// FrameArena
+//
+
+thread_local rai::FrameArena* rai::FrameArena::active = 0;
+
+//each allocation is preceded by a header that points to its arena (or 0 if on the heap) and its block
+struct FrameArena_Header { rai::FrameArena* arena; uint block; };
+static const size_t frameArena_header = alignof(std::max_align_t);
+static_assert(sizeof(FrameArena_Header)<=frameArena_header, "");
+static const size_t frameArena_minBlock = 1<<16;
+
+rai::FrameArena::~FrameArena() {
+  for(Block& b:blocks) ::operator delete(b.p);
+}
+
+size_t rai::FrameArena::footprint(size_t objectSize) {
+  return (objectSize+frameArena_header+frameArena_header-1) & ~(frameArena_header-1);
+}
+
+void rai::FrameArena::reserve(size_t bytes) {
+  if(current<blocks.size() && used+bytes<=blocks[current].size) return;
+  //use a recycled block (without live objects) that is large enough, or append a new one
+  uint i=0;
+  for(; i<blocks.size(); i++) if(i!=current && !blocks[i].live && blocks[i].size>=bytes) break;
+  if(i==blocks.size()) {
+    size_t size = (bytes>frameArena_minBlock ? bytes : frameArena_minBlock);
+    blocks.push_back({(char*)::operator new(size), size, 0});
+  }
+  current=i;
+  used=0;
+}
+
+void* rai::FrameArena::alloc(size_t bytes, uint& block) {
+  bytes = (bytes+frameArena_header-1) & ~(frameArena_header-1);
+  reserve(bytes);
+  void* p = blocks[current].p+used;
+  used += bytes;
+  blocks[current].live++;
+  block = current;
+  refs++;
+  return p;
+}
+
+void rai::FrameArena::free(uint block) {
+  CHECK(refs>1 && blocks[block].live, "");
+  if(!--blocks[block].live && block==current) used=0; //the current block is empty: restart it
+  refs--;
+  if(!refs) delete this; //(not reached while the owner holds its reference)
+}
+
+void rai::FrameArena::unref() {
+  CHECK(refs, "");
+  refs--;
+  if(!refs) delete this;
+}
+
+size_t rai::FrameArena::capacity() const {
+  size_t n=0;
+  for(const Block& b:blocks) n += b.size;
+  return n;
+}
+
+void* rai::FrameArenaAllocated::operator new(size_t size) {
+  FrameArena* arena = FrameArena::active;
+  uint block=0;
+  char* p = (char*)(arena ? arena->alloc(size+frameArena_header, block) : ::operator new(size+frameArena_header));
+  *(FrameArena_Header*)p = {arena, block};
+  return p+frameArena_header;
+}
+
+void rai::FrameArenaAllocated::operator delete(void* p) {
+  if(!p) return;
+  char* q = (char*)p-frameArena_header;
+  FrameArena_Header h = *(FrameArena_Header*)q;
+  if(h.arena) h.arena->free(h.block);
+  else ::operator delete(q);
+}
+
 //===========================================================================
 //
 // Frame
@@ -80,6 +161,7 @@ rai::Frame::~Frame() {
   if(inertia) delete inertia;
   if(parent) unLink();
   while(children.N) children.last()->unLink();
+  C.resetNameIndex();
   if(this==C.frames.last()) { //great: this is very efficient to remove without breaking indexing
     CHECK_EQ(ID, C.frames.N-1, "");
     C.frames.resizeCopy(C.frames.N-1);
@@ -88,6 +170,7 @@ rai::Frame::~Frame() {
     C.frames.remove(ID);
     for(uint i=0; i<C.frames.N; i++) C.frames.elem(i)->ID=i;
   }
+  C.coll_eraseFrameID(ID);
   C.reset_q();
 }
 
@@ -286,6 +369,7 @@ void rai::Frame::prefixSubtree(const char* prefix) {
   FrameL F = {this};
   getSubtree(F);
   for(auto* f:F) f->name.prepend(prefix);
+  C.resetNameIndex();
 }
 
 rai::Frame& rai::Frame::computeCompoundInertia() {
@@ -621,17 +705,12 @@ rai::Frame& rai::Frame::setMeshFile(str file, double scale){
   bool cd_into_mesh_files = rai::getParameter<bool>("cd_into_mesh_files", true);
 
   FileToken fil(file);
-  auto p = params()->find<shared_ptr<rai::Mesh>>(file);
-  if(p){
-    getShape()._mesh = *p;
-  }else{
-    rai::Mesh& mesh = getShape().mesh();
-    params()->add<shared_ptr<rai::Mesh>>(file, getShape()._mesh);
+  getShape()._mesh = assetCache().mesh(fil.fullPath(), scale, [&](rai::Mesh& mesh) {
     if(cd_into_mesh_files) fil.cd_file();
     mesh.read(fil, file.getLastN(3).p, fil.name.p);
     if(cd_into_mesh_files) fil.cd_base();
-  if(scale!=1.) mesh.scale(scale);
-  }
+    if(scale!=1.) mesh.scale(scale);
+  });
   getAts().set<FileToken>("mesh", FileToken(file));
   if(scale!=1.) getAts().set<double>("meshscale", scale);
   C.view_unlock();
@@ -1996,11 +2075,14 @@ void rai::Shape::read(const Graph& ats) {
   // fil.cd_start();
   // }
 
-  if(ats.get(str, "mesh_decomp")) { mesh().readH5(str, "decomp"); }
-  else if(ats.get(fil, "mesh_decomp")) { fil.cd_file(); mesh().readH5(fil.name, "decomp"); fil.cd_base(); }
+  auto readH5 = [this](const char* file, const char* group) { //a copy, as these meshes are modified per shape
+    mesh() = *assetCache().mesh(FileToken(file).fullPath(), 1., [file, group](rai::Mesh& m) { m.readH5(file, group); }, group);
+  };
+  if(ats.get(str, "mesh_decomp")) { readH5(str, "decomp"); }
+  else if(ats.get(fil, "mesh_decomp")) { fil.cd_file(); readH5(fil.name, "decomp"); fil.cd_base(); }
 
-  if(ats.get(str, "mesh_points")) { mesh().readH5(str, "points"); }
-  else if(ats.get(fil, "mesh_points")) { fil.cd_file(); mesh().readH5(fil.name, "points"); fil.cd_base(); }
+  if(ats.get(str, "mesh_points")) { readH5(str, "points"); }
+  else if(ats.get(fil, "mesh_points")) { fil.cd_file(); readH5(fil.name, "points"); fil.cd_base(); }
 
   if(type()==rai::ST_mesh && !mesh().T.N) type()=rai::ST_pointCloud;
 
@@ -2154,7 +2236,13 @@ void rai::Shape::createMeshes() {
       if(!mesh().V.N) {
         auto gridSdf = std::dynamic_pointer_cast<TensorShape>(_sdf);
         if(gridSdf && gridSdf->gridData.N) {
-          mesh().setImplicitSurface(gridSdf->gridData, sdf().lo, sdf().up);
+          AssetCache::Key key = AssetCache::Key().add(gridSdf->gridData).add(sdf().lo).add(sdf().up);
+          auto surface = assetCache().derived("sdfSurface", key, [&](rai::Mesh& m) {
+            m.setImplicitSurface(gridSdf->gridData, sdf().lo, sdf().up);
+          });
+          mesh().clear();
+          mesh().V = surface->V;
+          mesh().T = surface->T;
         } else {
           mesh().setImplicitSurface(sdf().evalGrid(30), sdf().lo, sdf().up);
         }
@@ -2227,9 +2315,8 @@ void rai::Shape::createMeshes() {
   }
 
   if(!sscCore().N){
-    rai::Mesh m;
-    m.V = mesh().V;
-    m.makeConvexHull();
+    auto hull = assetCache().convexHull(mesh().V);
+    const rai::Mesh& m = *hull;
     if(!m.T.N){ //empty mesh -> remove
       LOG(-1) <<"shape " <<frame.name <<" coll_core is trivial -> removing contact flag";
       cont=0;
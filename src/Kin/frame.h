@@ -70,8 +70,47 @@ struct Transformation_Qtoken {
 
 //===========================================================================
 
+/** A memory pool for the Frames of a Configuration and their Joints, Shapes and Inertias. Within a Scope, these are
+ *  allocated by a pointer bump into large blocks, so that copied configurations lie contiguously in memory. Ownership
+ *  is unchanged: objects are still deleted individually, which only decrements the live count of their block; a block
+ *  without live objects is recycled, also while other blocks are still in use. The owner holds one reference as well,
+ *  so the pool is deleted with whatever goes last. Not thread safe. */
+struct FrameArena : NonCopyable {
+  /// while alive, FrameArenaAllocated objects (on this thread) are allocated from arena
+  struct Scope {
+    FrameArena* prev;
+    Scope(FrameArena* arena) : prev(active) { active=arena; }
+    ~Scope() { active=prev; }
+  };
+  static thread_local FrameArena* active;
+
+  FrameArena() {}
+  ~FrameArena();
+
+  static size_t footprint(size_t objectSize); ///< the bytes an object of that size takes in the arena (header and alignment)
+  void reserve(size_t bytes); ///< the next bytes (a sum of footprints) will be allocated contiguously
+  void* alloc(size_t bytes, uint& block);
+  void free(uint block);      ///< an object of that block was deleted
+  void unref();               ///< drop the owner's reference; deletes this if no object is alive anymore
+  uint live() const { return refs-1; }
+  size_t capacity() const;
+
+ private:
+  struct Block { char* p; size_t size; uint live; };
+  std::vector<Block> blocks;
+  uint current=0;
+  size_t used=0;
+  uint refs=1; //the owner, and all live objects
+};
+
+/// base for the objects allocated from FrameArena::active if set (otherwise from the heap)
+struct FrameArenaAllocated {
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
+};
+
 /// a Frame can have a link (also joint), shape (visual or coll), and/or intertia (mass) attached to it
-struct Frame : NonCopyable {
+struct Frame : NonCopyable, FrameArenaAllocated {
   Configuration& C;        ///< a Frame is uniquely associated with a Configuration
   uint ID;                 ///< unique identifier (index in Configuration.frames)
   String name;             ///< name
@@ -256,7 +295,7 @@ struct Dof {
 //===========================================================================
 
 /// for a Frame with Joint-Link, the relative transformation 'Q' is articulated
-struct Joint : Dof, NonCopyable {
+struct Joint : Dof, NonCopyable, FrameArenaAllocated {
   // joint information
   //  byte generator;    ///< (7bits), h in Featherstone's code (indicates basis vectors of the Lie algebra, but including the middle quaternion w)
   String code;       ///< for JT_generic: code "txyzwabc" to indicate transformations; dim==code.N
@@ -303,7 +342,7 @@ struct Joint : Dof, NonCopyable {
 //===========================================================================
 
 /// a Frame with Inertia has mass and, in physical simulation, has forces associated with it
-struct Inertia : NonCopyable {
+struct Inertia : NonCopyable, FrameArenaAllocated {
   Frame& frame;
   double mass=0.;
   Matrix matrix=0;
@@ -328,7 +367,7 @@ stdOutPipe(Inertia)
 //===========================================================================
 
 /// a Frame with Shape is a collision or visual object
-struct Shape : NonCopyable {
+struct Shape : NonCopyable, FrameArenaAllocated {
   Frame& frame;
   Enum<ShapeType> _type;
   arr size;
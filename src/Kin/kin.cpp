@@ -25,14 +25,23 @@
 #include "../Geo/fclInterface.h"
 #include "../Geo/qhull.h"
 #include "../Geo/assimpInterface.h"
+#include "../Geo/assetCache.h"
 #include "../Gui/opengl.h"
 #include "../Algo/rungeKutta.h"
 #include "../Algo/spline.h"
 #include "../Core/h5.h"
+#include "../Core/profiler.h"
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
 #include <climits>
+#include <unordered_map>
+#include <mutex>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef RAI_ASSIMP
 #  include <assimp/Exporter.hpp>
@@ -129,9 +138,62 @@ struct sConfiguration {
   shared_ptr<ConfigurationViewer> viewer;
   //shared_ptr<SwiftInterface> swift;
   shared_ptr<FclInterface> fcl;
+  shared_ptr<CollisionMatrix> collFilter;
+  uintA collExcludePairs; //explicit pairs added with coll_addExcludePair
+
+  //name -> frame IDs (ascending) for the frames [0,nameIndexN)
+  std::unordered_map<std::string, uintA> nameIndex;
+  uint nameIndexN=0;
+  std::mutex nameMutex; //getFrame is const and may be called concurrently
+
+  void resetNameIndex() {
+    std::lock_guard<std::mutex> lock(nameMutex);
+    if(nameIndexN) std::unordered_map<std::string, uintA>().swap(nameIndex);
+    nameIndexN=0;
+  }
+
+  /// IDs of all frames with this name; catches up with appended frames, and rebuilds when an entry turns out inconsistent
+  uintA findFrames(const FrameL& frames, const char* name) {
+    if(!name) return uintA();
+    std::lock_guard<std::mutex> lock(nameMutex);
+    for(uint k=0; k<2; k++) {
+      if(nameIndexN>frames.N) { std::unordered_map<std::string, uintA>().swap(nameIndex); nameIndexN=0; }
+      for(; nameIndexN<frames.N; nameIndexN++) {
+        const String& n = frames.elem(nameIndexN)->name;
+        nameIndex[n.N ? std::string(n.p, n.N) : std::string()].append(nameIndexN);
+      }
+      auto it = nameIndex.find(name);
+      if(it==nameIndex.end()) return uintA();
+      bool consistent=true;
+      for(uint id:it->second) if(frames.elem(id)->name!=name) { consistent=false; break; }
+      if(consistent) return it->second;
+      std::unordered_map<std::string, uintA>().swap(nameIndex); //rebuild
+      nameIndexN=0;
+    }
+    HALT("inconsistent frame name index");
+    return uintA();
+  }
   unique_ptr<PhysXInterface> physx;
   unique_ptr<OdeInterface> ode;
   unique_ptr<FeatherstoneInterface> fs;
+
+  FrameArena* arena=nullptr; //pool for copied frames; we hold one reference
+
+  ~sConfiguration() { if(arena) arena->unref(); }
+
+  /// the arena, with enough contiguous space reserved for copies of the frames F
+  FrameArena* frameArena(const FrameL& F) {
+    if(!arena) arena = new FrameArena;
+    size_t bytes=0;
+    for(Frame* f:F) {
+      bytes += FrameArena::footprint(sizeof(Frame));
+      if(f->joint) bytes += FrameArena::footprint(sizeof(Joint));
+      if(f->shape) bytes += FrameArena::footprint(sizeof(Shape));
+      if(f->inertia) bytes += FrameArena::footprint(sizeof(Inertia));
+    }
+    arena->reserve(bytes);
+    return arena;
+  }
 };
 
 Configuration::Configuration() {
@@ -143,6 +205,7 @@ Configuration::~Configuration() {
   self->viewer.reset();
   //self->swift.reset();
   self->fcl.reset();
+  self->collFilter.reset();
   clear();
   self.reset();
 }
@@ -155,7 +218,10 @@ void Configuration::copy(const Configuration& C, bool referenceFclOnCopy) {
   jacMode = C.jacMode;
 
   //copy frames; first each Frame/Link/Joint directly, where all links go to the origin K (!!!); then relink to itself
-  for(Frame* f:C.frames) new Frame(*this, f);
+  {
+    FrameArena::Scope arena(self->frameArena(C.frames));
+    for(Frame* f:C.frames) new Frame(*this, f);
+  }
   for(Frame* f:C.frames) {
     if(f->parent) frames.elem(f->ID)->setParent(frames.elem(f->parent->ID));
     if(f->prev) frames.elem(f->ID)->prev = frames.elem(f->prev->ID);
@@ -180,7 +246,9 @@ void Configuration::copy(const Configuration& C, bool referenceFclOnCopy) {
   if(referenceFclOnCopy) {
     //self->swift = C.self->swift;
     self->fcl = C.self->fcl;
+    self->collFilter = C.self->collFilter;
   }
+  self->collExcludePairs = C.self->collExcludePairs;
 
   //copy vector state
   calc_indexedActiveJoints(true);
@@ -223,6 +291,7 @@ Frame* Configuration::addFrame(const char* name, const char* parent, const char*
 }
 
 Frame* Configuration::addFile(const char* filename, const char* namePrefix) {
+  if(rai::String(filename).endsWith(".gbin")) return addBinaryFile(filename, namePrefix);
   uint n=frames.N;
   FileToken file(filename);
   file.cd_file();
@@ -234,6 +303,7 @@ Frame* Configuration::addFile(const char* filename, const char* namePrefix) {
       if(n->is<Graph>()) tmp=n->graph().find<rai::String>("mimic");
       if(tmp) tmp->prepend(namePrefix);
     }
+    G.resetKeyIndex();
   }
   addDict(G);
   file.cd_base();
@@ -429,6 +499,7 @@ Frame* Configuration::addCopy(const FrameL& F, const DofL& _dofs, const str& pre
   FId2thisId = -1;
 
   //create new copied frames
+  FrameArena::Scope arena(self->frameArena(F));
   for(Frame* f:F) {
     Frame* f_new = new Frame(*this, f);
     FId2thisId(f->ID) = f_new->ID;
@@ -483,6 +554,7 @@ Frame* Configuration::addCopy(const FrameL& F, const DofL& _dofs, const str& pre
   uint startId = FId2thisId(F.first()->ID);
   if(prefix.N) {
     for(uint i=startId; i<frames.N; i++) frames.elem(i)->name.prepend(prefix);
+    resetNameIndex();
   }
 
   return frames.elem(startId);
@@ -509,11 +581,8 @@ void Configuration::delSubtree(const char* name){
 
 /// get first frame with given name
 Frame* Configuration::getFrame(const char* name, bool warnIfNotExist, bool reverse) const {
-  if(!reverse) {
-    for(Frame* b: frames) if(b->name==name) return b;
-  } else {
-    for(uint i=frames.N; i--;) if(frames.elem(i)->name==name) return frames.elem(i);
-  }
+  uintA ids = self->findFrames(frames, name);
+  if(ids.N) return frames.elem(reverse ? ids.last() : ids.first());
   if(warnIfNotExist) RAI_MSG("cannot find frame named '" <<name <<"'");
   return 0;
 }
@@ -777,6 +846,7 @@ arr Configuration::getFrameState(const FrameL& F) const {
 
 /// set the q-vector (all joint and force DOFs)
 void Configuration::setJointState(const arr& _q) {
+  RAI_PROFILE("Configuration::setJointState");
   setJointStateCount++; //global counter
 
 #ifndef RAI_NOCHECK
@@ -1075,6 +1145,7 @@ Graph Configuration::reportForces() {
 
 /// checks if all names of the bodies are disjoint
 bool Configuration::checkUniqueNames(bool makeUnique) {
+  if(makeUnique) resetNameIndex();
   for(Frame* a: frames) for(Frame* b: frames) {
       if(a==b) break;
       if(a->name==b->name) {
@@ -1124,6 +1195,7 @@ void Configuration::clear() {
 //  swiftDelete();
 //  if(self && self->viewer) self->viewer.reset();
   if(self && self->fcl) self->fcl.reset();
+  if(self) { self->collFilter.reset(); self->collExcludePairs.clear(); }
 
   reset_q();
   proxies.clear(); //while(proxies.N){ delete proxies.last(); /*checkConsistency();*/ }
@@ -1254,10 +1326,43 @@ void Configuration::processInertias(bool recomputeInertias, bool transformToDiag
   for(rai::Frame *link : F) link->standardizeInertias(recomputeInertias, transformToDiagInertia);
 }
 
+/// drops the collision filter (rebuilt on demand) after frame IDs changed, together with an FCL interface that uses it
+static void dropCollFilter(sConfiguration& self) {
+  if(self.fcl && self.collFilter && self.fcl->excludes==self.collFilter) self.fcl.reset();
+  self.collFilter.reset();
+}
+
+/// maps the explicit exclude pairs to new IDs (newID(ID)==-1: the frame is gone, its pairs are dropped)
+static void remapCollExcludePairs(sConfiguration& self, const intA& newID) {
+  uintA pairs;
+  for(uint i=0; i+1<self.collExcludePairs.N; i+=2) {
+    int a=newID(self.collExcludePairs(i)), b=newID(self.collExcludePairs(i+1));
+    if(a!=-1 && b!=-1) pairs.append({uint(a), uint(b)});
+  }
+  self.collExcludePairs = pairs;
+}
+
 void Configuration::sortFrames() {
-  frames = calc_topSort();
+  setFrameOrder(calc_topSort());
+}
+
+void Configuration::setFrameOrder(const FrameL& order) {
+  CHECK_EQ(order.N, frames.N, "order needs to be a permutation of all frames");
+  intA newID(frames.N);
   uint i=0;
-  for(Frame* f: frames) f->ID = i++;
+  for(Frame* f: order) newID(f->ID) = i++;
+  frames = order;
+  frames.reshape(-1);
+  for(Frame* f: frames) f->ID = newID(f->ID);
+  if(self && (self->collFilter || self->collExcludePairs.N)) {
+    remapCollExcludePairs(*self, newID);
+    dropCollFilter(*self);
+  }
+  resetNameIndex();
+}
+
+void Configuration::resetNameIndex() {
+  if(self) self->resetNameIndex();
 }
 
 void Configuration::makeObjectsFree(const StringA& objects, double H_cost) {
@@ -1444,29 +1549,7 @@ Joint* Configuration::attach(const char* _a, const char* _b) {
 }
 
 uintAA Configuration::getCollisionExcludePairIDs(int verbose) {
-  uintAA ex(frames.N);
-
-  //go through all parts, within each part, check pair-wise
-  FrameL parts = getParts();
-  for(Frame* f: parts) {
-    FrameL F = {f};
-    f->getPartSubFrames(F);
-    if(f->parent) { //add also parent link frames as potential excludes
-      rai::Frame* p = f->parent->getUpwardLink();
-      F.append(p);
-      p->getPartSubFrames(F);
-    }
-    for(Frame* f1: F) if(f1->shape && f1->shape->cont) {
-        for(Frame* f2: F) if(f2->ID>f1->ID && f2->shape && f2->shape->cont) {
-            bool canCollide = f1->shape->canCollideWith(f2);
-            if(!canCollide) {
-              if(verbose) LOG(0) <<"excluding: "  <<f1->ID <<'.' <<f1->name  <<' ' <<f2->ID <<'.' <<f2->name;
-              ex(f1->ID).setAppendInSorted(f2->ID);
-            }
-          }
-      }
-  }
-  return ex;
+  return coll_filter(verbose)->getPairs();
 }
 
 FrameL Configuration::getCollidableShapes(){
@@ -1492,6 +1575,7 @@ FrameL Configuration::getCollidablePairs() {
 void Configuration::prefixNames(bool clear) {
   if(!clear) for(Frame* a: frames) a->name=STRING('_' <<a->ID <<'_' <<a->name);
   else       for(Frame* a: frames) a->name.clear() <<a->ID;
+  resetNameIndex();
 }
 
 void Configuration::calc_indexedActiveJoints(bool resetActiveJointSet) {
@@ -2218,29 +2302,34 @@ std::shared_ptr<SwiftInterface> Configuration::swift() {
 
 //===========================================================================
 
+Array<Shape*> Configuration::coll_shapes(int verbose) {
+  Array<Shape*>::memMove=1;
+  Array<Shape*> geometries(frames.N);
+  geometries.setZero();
+  for(Frame* f:frames) {
+    if(f->shape && f->shape->cont) {
+      CHECK(f->shape->type()!=rai::ST_marker, "collision object can't be a marker");
+      if(!f->shape->mesh().V.N) f->shape->createMeshes();
+      CHECK(f->shape->mesh().V.N, "collision object with no vertices");
+      geometries(f->ID) = f->shape;
+      if(verbose>0) LOG(0) <<"  adding to FCL interface: " <<f->name;
+    } else {
+      if(verbose>0) LOG(0) <<"  SKIPPING from FCL interface: " <<f->name;
+    }
+  }
+  return geometries;
+}
+
 std::shared_ptr<FclInterface> Configuration::coll_fcl(int verbose) {
   if(!self->fcl) {
-    Array<Shape*>::memMove=1;
-    Array<Shape*> geometries(frames.N);
-    geometries.setZero();
-    for(Frame* f:frames) {
-      if(f->shape && f->shape->cont) {
-        CHECK(f->shape->type()!=rai::ST_marker, "collision object can't be a marker");
-        if(!f->shape->mesh().V.N) f->shape->createMeshes();
-        CHECK(f->shape->mesh().V.N, "collision object with no vertices");
-        geometries(f->ID) = f->shape;
-        if(verbose>0) LOG(0) <<"  adding to FCL interface: " <<f->name;
-      } else {
-        if(verbose>0) LOG(0) <<"  SKIPPING from FCL interface: " <<f->name;
-      }
-    }
-    self->fcl = make_shared<FclInterface>(geometries, getCollisionExcludePairIDs(), FclInterface::_broadPhaseOnly); //broadphase only -> many proxies, binary, exact margin (slow)
+    self->fcl = make_shared<FclInterface>(coll_shapes(verbose), coll_filter(verbose), FclInterface::_broadPhaseOnly); //broadphase only -> many proxies, binary, exact margin (slow)
   }
   return self->fcl;
 }
 
 void Configuration::coll_fclReset() {
   if(self && self->fcl) self->fcl.reset();
+  if(self) self->collFilter.reset();
 }
 
 void Configuration::addProxies(const uintA& collisionPairs) {
@@ -2289,8 +2378,8 @@ void Configuration::coll_stepFcl() {
 #if 0
   arr X = getFrameState();
 #else
-  static arr X;
-  X.resize(frames.N, 7).setZero();
+  arr X(frames.N, 7);
+  X.setZero();
   for(uint i=0; i<X.d0; i++) {
     rai::Frame* f = frames.elem(i);
     if(f->shape && f->shape->cont) X[i] = f->ensure_X().getArr7d();
@@ -2316,12 +2405,130 @@ void Configuration::coll_setActiveColliders(const FrameL& colliders){
   coll_fcl()->setActiveColliders(rai::framesToIndices(colliders));
 }
 
+/// the filter for writing: copied first if other configurations (directly or via a referenced FCL interface) share it
+static CollisionMatrix& writableCollFilter(sConfiguration& self) {
+  bool fclHolds = self.fcl && self.fcl->excludes==self.collFilter;
+  bool shared = self.collFilter.use_count() > (fclHolds ? 2 : 1) || (fclHolds && self.fcl.use_count()>1);
+  if(shared) {
+    auto M = make_shared<CollisionMatrix>(*self.collFilter);
+    if(fclHolds) {
+      if(self.fcl.use_count()>1) self.fcl.reset(); //another configuration's FCL: ours is rebuilt on demand
+      else self.fcl->excludes = M;
+    }
+    self.collFilter = M;
+  }
+  return *self.collFilter;
+}
+
 void Configuration::coll_addExcludePair(uint aID, uint bID){
-  if(aID<bID){
-    coll_fcl()->excludes(aID).setAppendInSorted(bID);
-  }else{
-    coll_fcl()->excludes(bID).setAppendInSorted(aID);
+  self->collExcludePairs.append({aID, bID});
+  if(self->collFilter) {
+    CollisionMatrix& M = writableCollFilter(*self);
+    M.resize(frames.N);
+    M.set(aID, bID);
+  }
+}
+
+void Configuration::coll_eraseFrameID(uint ID){
+  if(!self || (!self->collFilter && !self->collExcludePairs.N)) return;
+  intA newID(frames.N+1); //(called after the frame was removed from frames)
+  for(uint i=0; i<newID.N; i++) newID(i) = (i<ID ? int(i) : i==ID ? -1 : int(i)-1);
+  remapCollExcludePairs(*self, newID);
+  if(!self->collFilter) return;
+  if(ID==frames.N) { //the last frame: no other ID changed
+    CollisionMatrix& M = writableCollFilter(*self);
+    M.clearRow(ID);
+    M.resize(frames.N);
+  } else {
+    dropCollFilter(*self);
+  }
+}
+
+/// for each part: its frames together with those of the links above it that a negative contact reaches (see Frame::isChildOf)
+static FrameL getPartScope(Frame* part) {
+  FrameL F = {part};
+  part->getPartSubFrames(F);
+  if(part->parent) { //add also parent link frames as potential excludes
+    int order=1;
+    for(Frame* f:F) if(f->shape && f->shape->cont<0) order = std::max(order, -f->shape->cont);
+    FrameL links;
+    for(Frame* p=part->parent; p; p=p->parent) {
+      if(p->joint) order--;
+      if(order<0) break;
+      if(!p->parent || p->joint) links.setAppend(p);
+    }
+    for(Frame* p:links) {
+      FrameL S = {p};
+      p->getPartSubFrames(S);
+      F.setAppend(S);
+    }
+  }
+  return F;
+}
+
+/// excludes the pairs within the scope of a part that Shape::canCollideWith rejects; with inSub, only pairs touching inSub
+static void excludeWithinPart(CollisionMatrix& M, Frame* part, const boolA* inSub, int verbose) {
+  FrameL F = getPartScope(part);
+  FrameL coll, links;
+  for(Frame* f:F) if(f->shape && f->shape->cont) { coll.append(f); links.append(f->getUpwardLink()); }
+  if(inSub) {
+    bool touches=false;
+    for(Frame* f:coll) if((*inSub)(f->ID)) { touches=true; break; }
+    if(!touches) return;
+  }
+  for(uint i=0; i<coll.N; i++) for(uint j=i+1; j<coll.N; j++) {
+      Frame* f1=coll(i), *f2=coll(j);
+      if(inSub && !(*inSub)(f1->ID) && !(*inSub)(f2->ID)) continue;
+      //same as Shape::canCollideWith, with precomputed links
+      bool canCollide = (links(i)!=links(j));
+      if(canCollide && f1->shape->cont<0 && links(i)->isChildOf(links(j), -f1->shape->cont)) canCollide=false;
+      if(canCollide && f2->shape->cont<0 && links(j)->isChildOf(links(i), -f2->shape->cont)) canCollide=false;
+      if(!canCollide) {
+        if(verbose) LOG(0) <<"excluding: "  <<f1->ID <<'.' <<f1->name  <<' ' <<f2->ID <<'.' <<f2->name;
+        M.set(f1->ID, f2->ID);
+      }
+    }
+}
+
+/// recomputes the filter rows of the frames flagged in inSub and of frames added since -- only pairs involving them
+static void updateCollFilterRows(Configuration& C, sConfiguration& self, boolA& inSub) {
+  CollisionMatrix& M = writableCollFilter(self);
+  for(uint i=M.n; i<C.frames.N; i++) inSub(i)=true;
+  M.resize(C.frames.N);
+  for(uint i=0; i<inSub.N; i++) if(inSub(i)) M.clearRow(i);
+  for(Frame* part:C.getParts()) excludeWithinPart(M, part, &inSub, 0);
+  for(uint i=0; i+1<self.collExcludePairs.N; i+=2) {
+    uint a=self.collExcludePairs(i), b=self.collExcludePairs(i+1);
+    if(inSub(a) || inSub(b)) M.set(a, b);
+  }
+}
+
+std::shared_ptr<CollisionMatrix> Configuration::coll_filter(int verbose) {
+  if(!self->collFilter) {
+    auto M = make_shared<CollisionMatrix>(frames.N);
+    for(Frame* part:getParts()) excludeWithinPart(*M, part, 0, verbose);
+    for(uint i=0; i+1<self->collExcludePairs.N; i+=2) M->set(self->collExcludePairs(i), self->collExcludePairs(i+1));
+    self->collFilter = M;
+  } else if(self->collFilter->n<frames.N) { //frames were added since (e.g. KOMO::addPhases)
+    boolA inNew(frames.N);
+    inNew.setZero();
+    updateCollFilterRows(*this, *self, inNew);
   }
+  return self->collFilter;
+}
+
+void Configuration::coll_updateFilter(Frame* subtree) {
+  if(!self->collFilter) return; //will be built from scratch on demand
+  FrameL sub = {subtree};
+  subtree->getSubtree(sub);
+  boolA inSub(frames.N);
+  inSub.setZero();
+  for(Frame* f:sub) inSub(f->ID)=true;
+  updateCollFilterRows(*this, *self, inSub);
+}
+
+bool Configuration::coll_isExcluded(uint aID, uint bID) const {
+  return self->collFilter && (*self->collFilter)(aID, bID);
 }
 
 /// get the sum of all shape penetrations -- PRECONDITION: proxies have been computed (with stepFcl())
@@ -2623,7 +2830,7 @@ void Configuration::write(std::ostream& os, bool explicitlySorted) const {
 }
 
 void Configuration::write(Graph& G) const {
-  for(Frame* f: frames) if(!f->name.N) f->name <<'_' <<f->ID;
+  for(Frame* f: frames) if(!f->name.N) { f->name <<'_' <<f->ID; self->resetNameIndex(); }
   for(Frame* f: frames) f->write(G.addSubgraph(f->name));
   for(uint i=0; i<frames.N; i++) if(frames.elem(i)->parent) {
       G.elem(i)->addParent(G.elem(frames.elem(i)->parent->ID));
@@ -2825,12 +3032,10 @@ void Configuration::writeMeshes(str pathPrefix, bool copyTextures, bool enumerat
     }
   }
   if(true){
-    auto P =params();
-    NodeL meshes = P->findNodesOfType(typeid(shared_ptr<rai::Mesh>));
     uint meshCount=0;
-    for(Node* n:meshes) {
-      shared_ptr<rai::Mesh> m = n->as<shared_ptr<rai::Mesh>>();
-      rai::FileToken fil(n->key);
+    for(auto& asset:assetCache().meshes()) {
+      shared_ptr<rai::Mesh> m = asset.second;
+      rai::FileToken fil(asset.first);
       fil.name.resize(fil.name.find('.',true), true);
       fil.decomposeFilename();
       str newfilename = pathPrefix;
@@ -2886,6 +3091,241 @@ void Configuration::writeMesh(const char* filename) const {
 //  writeAssimp(all, filename, "ply");
 }
 
+//===========================================================================
+//
+// binary scene files: the .g text of the configuration, plus all shape geometry (meshes, convex cores and
+// decompositions) as raw arrays at aligned offsets, so that the file can be memory-mapped and loaded without
+// parsing or recomputing any geometry
+//
+
+namespace {
+
+const char binaryScene_magic[8] = {'R', 'A', 'I', 'S', 'C', 'N', '\0', '\1'};
+const uint32_t binaryScene_version = 1;
+const uint32_t binaryScene_endian = 0x01020304;
+
+struct BinaryArray { uint64_t offset=0; uint32_t elemSize=0, nd=0, d0=0, d1=0, d2=0, _pad=0; };
+struct BinaryMesh { BinaryArray V, Vn, C, T, Tn, texCoords, cvxParts, texImg, texFile; };
+struct BinaryShape { uint32_t frame=0; int32_t mesh=-1, type=0, cont=0; double cvxRadius=0.; BinaryArray size, sscCore; };
+struct BinarySceneHeader {
+  char magic[8];
+  uint32_t version, endian;
+  uint64_t fileSize, textOffset, textSize, meshOffset, meshCount, shapeOffset, shapeCount;
+};
+
+struct BinarySceneWriter {
+  std::string data;
+
+  uint64_t append(const void* p, size_t n) {
+    data.resize((data.size()+15)&~size_t(15), '\0'); //16-byte alignment of all blocks
+    uint64_t offset = data.size();
+    data.append((const char*)p, n);
+    return offset;
+  }
+  template<class T> BinaryArray add(const rai::Array<T>& x) {
+    BinaryArray a;
+    if(!x.N) return a;
+    a.offset = append(x.p, x.N*sizeof(T));
+    a.elemSize=sizeof(T); a.nd=x.nd; a.d0=x.d0; a.d1=x.d1; a.d2=x.d2;
+    return a;
+  }
+};
+
+struct BinarySceneReader {
+  const char* p=0;
+  size_t size=0;
+
+  BinarySceneReader(const char* filename) {
+    int fd = ::open(filename, O_RDONLY);
+    CHECK(fd>=0, "could not open binary scene file '" <<filename <<"'");
+    struct stat st;
+    if(!fstat(fd, &st)) size = st.st_size;
+    void* m = size ? mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    CHECK(m!=MAP_FAILED, "could not map binary scene file '" <<filename <<"'");
+    p = (const char*)m;
+  }
+  ~BinarySceneReader() { if(p) munmap((void*)p, size); }
+
+  const char* at(uint64_t offset, uint64_t bytes) const {
+    CHECK(offset<=size && bytes<=size-offset, "binary scene file is corrupt (block beyond end of file)");
+    return p+offset;
+  }
+  template<class T> void get(rai::Array<T>& x, const BinaryArray& a) const {
+    x.clear();
+    if(!a.nd) return;
+    CHECK_EQ(a.elemSize, sizeof(T), "binary scene file is corrupt (wrong element type)");
+    if(a.nd==1) x.resize(a.d0);
+    else if(a.nd==2) x.resize(a.d0, a.d1);
+    else x.resize(a.d0, a.d1, a.d2);
+    memcpy(x.p, at(a.offset, x.N*sizeof(T)), x.N*sizeof(T));
+  }
+};
+
+bool binaryScene_embedsShape(const Shape* s) {
+  return s->_type!=ST_sdf && s->_type!=ST_tensor; //sdf-based shapes are loaded from their files as usual
+}
+
+} //namespace
+
+/// compile the configuration into a binary scene file (see addBinaryFile())
+void Configuration::writeBinaryFile(const char* filename) const {
+  BinarySceneWriter W;
+  BinarySceneHeader H;
+  memset(&H, 0, sizeof(H));
+  W.append(&H, sizeof(H));
+
+  //-- the frame tree, joints and all other attributes as .g text
+  {
+    std::ostringstream os;
+    write(os);
+    std::string text = os.str();
+    H.textOffset = W.append(text.data(), text.size());
+    H.textSize = text.size();
+  }
+
+  //-- each mesh once, and each shape referring to it
+  std::map<const Mesh*, int> meshIndex;
+  std::vector<BinaryMesh> meshes;
+  std::vector<BinaryShape> shapes;
+  for(Frame* f:frames) {
+    Shape* s = f->shape;
+    if(!s || !binaryScene_embedsShape(s)) continue;
+    BinaryShape b;
+    b.frame = f->ID;
+    b.type = s->_type;
+    b.cont = s->cont;
+    b.cvxRadius = s->coll_cvxRadius;
+    b.size = W.add(s->size);
+    if(s->_sscCore) b.sscCore = W.add(*s->_sscCore);
+    if(s->_mesh) {
+      const Mesh& m = *s->_mesh;
+      auto it = meshIndex.find(&m);
+      if(it!=meshIndex.end()) b.mesh = it->second;
+      else {
+        BinaryMesh bm;
+        bm.V = W.add(m.V);  bm.Vn = W.add(m.Vn);  bm.C = W.add(m.C);
+        bm.T = W.add(m.T);  bm.Tn = W.add(m.Tn);
+        bm.texCoords = W.add(m.texCoords);
+        bm.cvxParts = W.add(m.cvxParts);
+        if(m._texImg) { bm.texImg = W.add(m._texImg->img);  bm.texFile = W.add(m._texImg->file); }
+        b.mesh = meshIndex[&m] = meshes.size();
+        meshes.push_back(bm);
+      }
+    }
+    shapes.push_back(b);
+  }
+  H.meshCount = meshes.size();
+  H.meshOffset = W.append(meshes.data(), meshes.size()*sizeof(BinaryMesh));
+  H.shapeCount = shapes.size();
+  H.shapeOffset = W.append(shapes.data(), shapes.size()*sizeof(BinaryShape));
+
+  //-- header
+  memcpy(H.magic, binaryScene_magic, 8);
+  H.version = binaryScene_version;
+  H.endian = binaryScene_endian;
+  H.fileSize = W.data.size();
+  memcpy(&W.data[0], &H, sizeof(H));
+
+  std::ofstream fil;
+  rai::open(fil, filename);
+  fil.write(W.data.data(), W.data.size());
+  CHECK(fil.good(), "could not write binary scene file '" <<filename <<"'");
+}
+
+/** load a binary scene file written by writeBinaryFile(): the frames are created from the embedded .g text as in
+ *  addFile(), but shapes get their meshes, convex cores and decompositions directly from the file */
+Frame* Configuration::addBinaryFile(const char* filename, const char* namePrefix) {
+  uint n_prev=frames.N;
+  FileToken file(filename);
+  file.cd_file();
+  BinarySceneReader R(file.name);
+
+  //-- check the header
+  CHECK_GE(R.size, sizeof(BinarySceneHeader), "'" <<filename <<"' is not a binary scene file");
+  BinarySceneHeader H;
+  memcpy(&H, R.p, sizeof(H));
+  CHECK(!memcmp(H.magic, binaryScene_magic, 8), "'" <<filename <<"' is not a binary scene file");
+  CHECK_EQ(H.version, binaryScene_version, "binary scene file '" <<filename <<"' has a different version -- recompile it");
+  CHECK_EQ(H.endian, binaryScene_endian, "binary scene file '" <<filename <<"' was written on a different architecture");
+  CHECK_EQ(H.fileSize, R.size, "binary scene file '" <<filename <<"' is truncated");
+
+  //-- parse the text
+  Graph G;
+  {
+    std::istringstream is(std::string(R.at(H.textOffset, H.textSize), H.textSize));
+    G.read(is);
+  }
+  if(namePrefix && namePrefix[0]) {
+    for(Node* n:G) {
+      n->key.prepend(namePrefix);
+      rai::String* tmp=0;
+      if(n->is<Graph>()) tmp=n->graph().find<rai::String>("mimic");
+      if(tmp) tmp->prepend(namePrefix);
+    }
+    G.resetKeyIndex();
+  }
+
+  //-- the shape attributes of embedded shapes are put aside, so that addDict does not load their geometry
+  rai::Array<BinaryShape> shapes(H.shapeCount);
+  memcpy(shapes.p, R.at(H.shapeOffset, shapes.N*sizeof(BinaryShape)), shapes.N*sizeof(BinaryShape));
+  rai::Array<shared_ptr<Graph>> shapeAts(shapes.N);
+  StringA shapeKeys = {"shape", "type", "mesh", "mesh_decomp", "mesh_points", "core", "sdf"};
+  for(uint i=0; i<shapes.N; i++) {
+    CHECK(shapes(i).frame<G.N, "binary scene file is corrupt (shape of unknown frame)");
+    Graph& ats = G.elem(shapes(i).frame)->graph();
+    shapeAts(i) = make_shared<Graph>();
+    shapeAts(i)->copy(ats, false, true);
+    NodeL del;
+    for(Node* a:ats) if(shapeKeys.contains(a->key)) del.append(a);
+    for(Node* a:del) delete a;
+    ats.index();
+  }
+
+  addDict(G);
+
+  //-- meshes
+  rai::Array<shared_ptr<Mesh>> meshes(H.meshCount);
+  const BinaryMesh* bm = (const BinaryMesh*)R.at(H.meshOffset, meshes.N*sizeof(BinaryMesh));
+  for(uint i=0; i<meshes.N; i++) {
+    BinaryMesh b;
+    memcpy(&b, bm+i, sizeof(b));
+    auto m = meshes(i) = make_shared<Mesh>();
+    R.get(m->V, b.V);  R.get(m->Vn, b.Vn);  R.get(m->C, b.C);
+    R.get(m->T, b.T);  R.get(m->Tn, b.Tn);
+    R.get(m->texCoords, b.texCoords);
+    R.get(m->cvxParts, b.cvxParts);
+    if(b.texImg.nd || b.texFile.nd) {
+      m->_texImg = make_shared<SharedTextureImage>();
+      R.get(m->_texImg->img, b.texImg);
+      R.get(m->_texImg->file, b.texFile);
+    }
+  }
+
+  //-- shapes
+  for(uint i=0; i<shapes.N; i++) {
+    const BinaryShape& b = shapes(i);
+    Frame* f = frames.elem(n_prev+b.frame);
+    Shape* s = new Shape(*f);
+    s->_type = (ShapeType)b.type;
+    s->cont = (char)b.cont;
+    s->coll_cvxRadius = b.cvxRadius;
+    R.get(s->size, b.size);
+    if(b.sscCore.nd) { s->_sscCore = make_shared<arr>(); R.get(*s->_sscCore, b.sscCore); }
+    if(b.mesh>=0) {
+      CHECK(b.mesh<(int)meshes.N, "binary scene file is corrupt (unknown mesh)");
+      s->_mesh = meshes(b.mesh);
+    }
+    f->ats->copy(*shapeAts(i), false, true); //restore the original attributes (except the resolved mimic, as in addDict)
+    if(f->joint && f->joint->mimic) { Node* mim = f->ats->findNode("mimic"); if(mim) { delete mim; f->ats->index(); } }
+    if(f->inertia) f->inertia->read(*f->ats); //default inertias depend on the shape
+  }
+
+  file.cd_base();
+  if(frames.N==n_prev) return 0;
+  return frames.elem(n_prev);
+}
+
 /// prototype for \c operator>>
 void Configuration::read(std::istream& is) {
   Graph G(is);
@@ -2917,6 +3357,7 @@ Graph Configuration::getGraph() const {
       n->key = (STRING("inertia m=" <<f->inertia->mass));
     }
   }
+  G.resetKeyIndex();
 #else
   Graph G;
   //first just create nodes
@@ -35,6 +35,7 @@ struct Configuration;
 struct KinematicSwitch;
 
 struct FclInterface;
+struct CollisionMatrix;
 struct ConfigurationViewer;
 
 } // namespace rai
@@ -95,6 +96,7 @@ struct Configuration {
   /// @name initializations, building configurations
   Frame* addFrame(const char* name, const char* parent=nullptr, const char* args=nullptr, bool warnDuplicateName=true);
   Frame* addFile(const char* filename, const char* namePrefix=0);
+  Frame* addBinaryFile(const char* filename, const char* namePrefix=0);
   Frame& addDict(const Graph& G);
   Frame* addAssimp(const char* filename);
   Frame* addH5Object(const char* framename, const char* filename, int verbose);
@@ -107,6 +109,7 @@ struct Configuration {
   Frame* operator[](const char* name) const { return getFrame(name, true); }  ///< same as getFrame()
   Frame* operator()(int i) const { return frames(i); } ///< same as 'frames.elem(i)'  (the i-th frame)
   Frame* getFrame(const char* name, bool warnIfNotExist=true, bool reverse=false) const;
+  void resetNameIndex(); ///< getFrame uses a hash index that tracks added/deleted frames; call this after renaming frames directly
   FrameL getFrames(const uintA& ids) const;
   FrameL getFrames(const StringA& names) const;
   uintA getFrameIDs(const StringA& names) const;
@@ -184,6 +187,7 @@ struct Configuration {
   void processStructure(bool _pruneRigidJoints=false, bool reconnectToLinks=true, bool pruneNonContactShapes=false, bool pruneTransparent=false);        ///< call the three above methods in this order
   void processInertias(bool recomputeInertias=true, bool transformToDiagInertia=false);
   void sortFrames();
+  void setFrameOrder(const FrameL& order); ///< reorders and renumbers the frames (order: a permutation of frames, any shape)
   void makeObjectsFree(const StringA& objects, double H_cost=0.);
   void addTauJoint();
   bool hasTauJoint(Frame* a=0);
@@ -261,11 +265,18 @@ public:
   /// @name collisions & proxies
   void coll_setActiveColliders(const FrameL& colliders);
   void coll_addExcludePair(uint aID, uint bID);
+  /// excluded pairs, built on demand: within each part (together with the link it is attached to), the pairs rejected by
+  /// Shape::canCollideWith (same link, contact depth flags); plus explicit pairs (coll_addExcludePair); extended to frames added since
+  std::shared_ptr<CollisionMatrix> coll_filter(int verbose=0);
+  void coll_updateFilter(Frame* subtree); ///< recompute the filter rows of all frames below subtree, e.g. after a KinematicSwitch
+  bool coll_isExcluded(uint aID, uint bID) const; ///< O(1) lookup; false if no filter has been built
+  void coll_eraseFrameID(uint ID); ///< called by ~Frame: drops the explicit pairs of ID, shifts larger IDs, and updates the filter
 
   double coll_totalViolation(); ///< proxies are returns from a collision engine; contacts stable constraints
   bool coll_isCollisionFree();
   void coll_reportProxies(std::ostream& os=cout, double belowMargin=1., bool brief=true) const;
   StringA coll_getProxyPairs(double belowMargin, arr& distances=NoArr);
+  Array<Shape*> coll_shapes(int verbose=0); ///< the collision shapes indexed by frame ID (0 for frames without contact), with meshes
   std::shared_ptr<FclInterface> coll_fcl(int verbose=0);
   void coll_fclReset();
   void addProxies(const uintA& collisionPairs);
@@ -299,6 +310,7 @@ public:
   void writeCollada(const char* filename, const char* format="collada") const;
   void writeMeshes(str pathPrefix="meshes/", bool copyTextures=false, bool enumerateAssets=false) const;
   void writeMesh(const char* filename="z.ply") const;
+  void writeBinaryFile(const char* filename="z.gbin") const;
   void read(std::istream& is);
   Graph getGraph() const;
   void displayDot();
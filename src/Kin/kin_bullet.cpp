@@ -838,6 +838,58 @@ void BulletInterface::pushKinematicStates(const rai::Configuration& C) {
   }
 }
 
+void BulletInterface::getBodyStates(uintA& frameIDs, arr& states) {
+  CHECK(!self->multibodies.N, "body states of multibodies are not implemented");
+  frameIDs.clear();
+  for(uint i=0; i<self->actors.N; i++) {
+    if(self->actorTypes(i)==rai::BT_dynamic && dynamic_cast<btRigidBody*>(self->actors(i))) frameIDs.append(i);
+  }
+  states.resize(frameIDs.N, 13);
+  for(uint k=0; k<frameIDs.N; k++) {
+    btRigidBody* b = dynamic_cast<btRigidBody*>(self->actors(frameIDs(k)));
+    const btTransform& pose = b->getWorldTransform();
+    btQuaternion q = pose.getRotation();
+    const btVector3 &p = pose.getOrigin(), &v = b->getLinearVelocity(), &w = b->getAngularVelocity();
+    double s[13] = {p.x(), p.y(), p.z(), q.w(), q.x(), q.y(), q.z(), v.x(), v.y(), v.z(), w.x(), w.y(), w.z()};
+    memmove(&states(k, 0), s, sizeof(s));
+  }
+}
+
+void BulletInterface::getActiveBodies(uintA& frameIDs) {
+  frameIDs.clear();
+  for(uint i=0; i<self->actors.N; i++) {
+    if(self->actorTypes(i)!=rai::BT_dynamic) continue;
+    btRigidBody* b = dynamic_cast<btRigidBody*>(self->actors(i));
+    if(b && b->isActive()) frameIDs.append(i);
+  }
+}
+
+uint BulletInterface::setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states) {
+  CHECK_EQ(states.d0, frameIDs.N, "");
+  uint touched=0;
+  for(uint k=0; k<frameIDs.N; k++) {
+    btRigidBody* b = dynamic_cast<btRigidBody*>(self->actors(frameIDs(k)));
+    const btTransform& pose = b->getWorldTransform();
+    btQuaternion q = pose.getRotation();
+    const btVector3 &p = pose.getOrigin(), &v = b->getLinearVelocity(), &w = b->getAngularVelocity();
+    double cur[13] = {p.x(), p.y(), p.z(), q.w(), q.x(), q.y(), q.z(), v.x(), v.y(), v.z(), w.x(), w.y(), w.z()};
+    const double* s = &states(k, 0);
+    if(!memcmp(s, cur, sizeof(cur))) continue;
+    btTransform newPose(btQuaternion(s[4], s[5], s[6], s[3]), btVector3(s[0], s[1], s[2]));
+    b->setWorldTransform(newPose);
+    if(b->getMotionState()) b->getMotionState()->setWorldTransform(newPose);
+    b->setLinearVelocity(btVector3(s[7], s[8], s[9]));
+    b->setAngularVelocity(btVector3(s[10], s[11], s[12]));
+    b->clearForces();
+    b->setActivationState(ACTIVE_TAG);
+    rai::Transformation X;
+    btTrans2raiTrans(X, newPose);
+    C.frames.elem(frameIDs(k))->set_X() = X;
+    touched++;
+  }
+  return touched;
+}
+
 void BulletInterface::pushFullState(const rai::Configuration& C, const arr& frameVelocities) {
   for(rai::Frame* f : C.frames) {
     if(self->actors.N <= f->ID) continue;
@@ -1008,6 +1060,9 @@ void BulletInterface::step(double tau) { NICO }
 void BulletInterface::pushFullState(const rai::Configuration& C, const arr& vel) { NICO }
 void BulletInterface::pushKinematicStates(const rai::Configuration& C) { NICO }
 void BulletInterface::pullDynamicStates(rai::Configuration& C, arr& vel) { NICO }
+void BulletInterface::getBodyStates(uintA& frameIDs, arr& states) { NICO }
+void BulletInterface::getActiveBodies(uintA& frameIDs) { NICO }
+uint BulletInterface::setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states) { NICO }
 void BulletInterface::setMotorQ(const arr& q_ref, const arr& qDot_ref) { NICO }
 void BulletInterface::saveBulletFile(const char* filename) { NICO }
 void BulletInterface::changeObjectType(rai::Frame* f, int _type, const arr& withVelocity) { NICO }
@@ -39,6 +39,14 @@ struct BulletInterface {
   void pushFullState(const rai::Configuration& C, const arr& frameVelocities=NoArr);
   void pullDynamicStates(rai::Configuration& C, arr& frameVelocities=NoArr);
 
+  /// engine-native states of all dynamic rigid bodies: frame IDs, and per body [pos, quat, linVel, angVel]
+  void getBodyStates(uintA& frameIDs, arr& states);
+  /// frame IDs of the dynamic bodies the last step has moved (sleeping bodies are skipped)
+  void getActiveBodies(uintA& frameIDs);
+  /// restores body states from getBodyStates, touching only bodies whose state differs (and setting their frame poses in C);
+  /// returns the number of touched bodies
+  uint setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states);
+
   void changeObjectType(rai::Frame* f, int _type, const arr& withVelocity= {});
 
   void motorizeMultiBody(rai::Frame* base);
@@ -10,6 +10,8 @@
 #include "frame.h"
 #include "kin.h"
 
+#include <unordered_map>
+
 /** interface and implementation to Featherstone's Articulated Body Algorithm
 
   See resources from http://users.rsise.anu.edu.au/~roy/spatial/index.html
@@ -240,93 +242,178 @@ void FrameToMatrix(arr& X, const rai::Transformation& f) {
   X.setMatrixBlock(R, 3, 3);
 }
 
+//===========================================================================
+
+void Featherstone::Matrix6::setTransform(const rai::Transformation& f) {
+  //[R 0; R*~skew(p) R], with R the transposed rotation matrix of f
+  double R[9];
+  f.rot.getMatrix(R);
+  const rai::Vector& p = f.pos;
+  setZero();
+  for(uint i=0; i<3; i++) for(uint j=0; j<3; j++) m[6*i+j] = m[6*(i+3)+j+3] = R[3*j+i];
+  for(uint i=0; i<3; i++) {
+    double r0=R[i], r1=R[3+i], r2=R[6+i]; //row i of the transposed R
+    m[6*(i+3)+0] = r2*p.y - r1*p.z;
+    m[6*(i+3)+1] = r0*p.z - r2*p.x;
+    m[6*(i+3)+2] = r1*p.x - r0*p.y;
+  }
+}
+
+void Featherstone::Matrix6::setRBI(double mass, const rai::Vector& c, const rai::Matrix& I) {
+  //[ I + m*C*C', m*C; m*C', m*eye(3) ] with C=skew(c)
+  double C[9] = {0., -c.z, c.y,  c.z, 0., -c.x,  -c.y, c.x, 0.};
+  const double* In = &I.m00;
+  setZero();
+  for(uint i=0; i<3; i++) for(uint j=0; j<3; j++) {
+      double CCt=0.;
+      for(uint k=0; k<3; k++) CCt += C[3*i+k]*C[3*j+k];
+      m[6*i+j] = In[3*i+j] + mass*CCt;
+      m[6*i+j+3] = mass*C[3*i+j];
+      m[6*(i+3)+j] = mass*C[3*j+i];
+    }
+  for(uint i=3; i<6; i++) m[6*i+i] = mass;
+}
+
+void Featherstone::addCongruence(Matrix6& A, const Matrix6& X, const Matrix6& I) {
+  double IX[36];
+  for(uint i=0; i<6; i++) for(uint j=0; j<6; j++) {
+      double s=0.;
+      for(uint k=0; k<6; k++) s += I.m[6*i+k]*X.m[6*k+j];
+      IX[6*i+j] = s;
+    }
+  for(uint i=0; i<6; i++) for(uint j=0; j<6; j++) {
+      double s=0.;
+      for(uint k=0; k<6; k++) s += X.m[6*k+i]*IX[6*k+j];
+      A.m[6*i+j] += s;
+    }
+}
+
+//===========================================================================
+
 uint F_Link::dof() { if(type>=rai::JT_hingeX && type<=rai::JT_transZ) return 1; else return 0; }
 
 void F_Link::setFeatherstones() {
+  _h.setZero();
   switch(type) {
-    case -1:     CHECK_EQ(parent, -1, ""); _h.clear();  break;
+    case -1:     CHECK_EQ(parent, -1, ""); break;
     case rai::JT_rigid:
     case rai::JT_transXYPhi:
       qIndex=-1;
-      _h=zeros(6);
       break;
-    case rai::JT_hingeX: _h.resize(6).setZero(); _h(0)=1.; break;
-    case rai::JT_hingeY: _h.resize(6).setZero(); _h(1)=1.; break;
-    case rai::JT_hingeZ: _h.resize(6).setZero(); _h(2)=1.; break;
-    case rai::JT_transX: _h.resize(6).setZero(); _h(3)=1.; break;
-    case rai::JT_transY: _h.resize(6).setZero(); _h(4)=1.; break;
-    case rai::JT_transZ: _h.resize(6).setZero(); _h(5)=1.; break;
+    case rai::JT_hingeX: _h[0]=1.; break;
+    case rai::JT_hingeY: _h[1]=1.; break;
+    case rai::JT_hingeZ: _h[2]=1.; break;
+    case rai::JT_transX: _h[3]=1.; break;
+    case rai::JT_transY: _h[4]=1.; break;
+    case rai::JT_transZ: _h[5]=1.; break;
     default: NIY;
   }
-  Featherstone::RBmci(_I, mass, com.p(), inertia);
+  _I.setRBI(mass, com, inertia);
 
   updateFeatherstones();
 }
 
 void F_Link::updateFeatherstones() {
-  FrameToMatrix(_Q, Q);
+  _Q.setTransform(Q);
 
 //  rai::Transformation XQ;
 //  XQ=X;
 //  XQ.appendTransformation(Q);
   rai::Vector fo = -X.rot * force;
   rai::Vector to = -X.rot * (torque + ((X.rot*com)^force));
-  _f.resize(6);
-  _f(0)=to.x;  _f(1)=to.y;  _f(2)=to.z;
-  _f(3)=fo.x;  _f(4)=fo.y;  _f(5)=fo.z;
+  _f[0]=to.x;  _f[1]=to.y;  _f[2]=to.z;
+  _f[3]=fo.x;  _f[4]=fo.y;  _f[5]=fo.z;
+}
+
+/// for each of the frames, the index of its parent within frames, or -1
+static intA parentIndices(const FrameL& frames) {
+  std::unordered_map<rai::Frame*, int> index;
+  index.reserve(frames.N);
+  intA parents(frames.N);
+  for(uint i=0; i<frames.N; i++) {
+    rai::Frame* f = frames.elem(i);
+    auto it = f->parent ? index.find(f->parent) : index.end();
+    parents(i) = (it==index.end()) ? -1 : it->second;
+    index[f] = i;
+  }
+  return parents;
+}
+
+FeatherstoneInterface::FeatherstoneInterface(rai::Configuration& C, const FrameL& frames) : C(C), sortedFrames(frames), subTree(true) {
+  subTreeParents = parentIndices(frames);
+  std::unordered_map<rai::Frame*, uint> index;
+  for(uint i=0; i<frames.N; i++) index[frames.elem(i)] = i;
+  for(uint i=0; i<frames.N; i++) {
+    rai::Frame* p = frames.elem(i)->parent;
+    if(p && subTreeParents(i)==-1) CHECK(!index.count(p), "frame '" <<frames.elem(i)->name <<"' is listed before its parent");
+  }
+}
+
+uint FeatherstoneInterface::dim(const FrameL& frames) {
+  intA parents = parentIndices(frames);
+  uint n=0;
+  for(uint i=0; i<frames.N; i++) {
+    rai::Joint* j = frames.elem(i)->joint;
+    if(j && !j->mimic && j->type>=rai::JT_hingeX && j->type<=rai::JT_transZ && parents(i)!=-1) n++;
+  }
+  return n;
 }
 
 void FeatherstoneInterface::setGravity(double g) {
   rai::Vector grav(0, 0, g);
-  for(rai::Frame* f: C.frames) {
-    F_Link& link=tree(f->ID);
-    link.force = link.mass * grav;
-  }
+  for(F_Link& link:tree) link.force = link.mass * grav;
 }
 
 void FeatherstoneInterface::update() {
-  if(tree.N != C.frames.N) { //new instance -> create the tree
-    CHECK_EQ(C.frames, sortedFrames, "Featherstone requires a sorted optimized frame tree (call simplify and fwdIndexIDs)");
+  uint N = subTree ? sortedFrames.N : C.frames.N;
+  bool created = (tree.N != N);
+  if(created) { //new instance -> create the tree
+    if(!subTree) CHECK_EQ(C.frames, sortedFrames, "Featherstone requires a sorted optimized frame tree (call simplify and fwdIndexIDs)");
     tree.clear();
-    tree.resize(C.frames.N);
-
-    for(F_Link& link:tree) { link.parent=-1; link.qIndex=-1; link.com.setZero(); } //TODO: remove
-
-    uint n=0;
-    for(rai::Frame* f : C.frames) {
-      F_Link& link=tree(f->ID);
-      link.ID = f->ID;
-      link.X = f->ensure_X();
-      if(f->parent) { //is not a root
-        link.parent = f->parent->ID;
-        link.Q = f->get_Q();
-        rai::Joint* j=f->joint;
-        if(j && !j->mimic) {
-          link.type   = j->type;
-          link.qIndex = j->qIndex;
-        } else {
-          if(j && j->mimic) LOG(0) <<"Featherstone cannot handle mimic joint ('" <<f->name <<"') properly - assuming rigid";
-          link.type   = rai::JT_rigid;
-        }
-//        if(j) CHECK_EQ(j->dim, link.dof(), "");
-      }
-      if(f->inertia) {
-        link.com = f->inertia->com;
-        link.mass=f->inertia->mass; CHECK(link.mass>0. || link.qIndex==-1, "a moving link without mass -> this will diverge");
-        link.inertia=f->inertia->matrix;
+    tree.resize(N);
+  }
+  if(subTree) { //a frame reparented within the list changes the tree
+    for(uint i=0; i<N; i++) {
+      int p = subTreeParents(i);
+      if(p!=-1 && sortedFrames.elem(p)!=sortedFrames.elem(i)->parent) { subTreeParents = parentIndices(sortedFrames); break; }
+    }
+  }
+
+  //-- joint types and inertias are read anew in each update, as they may have been edited since the last
+  uint n=0;
+  for(uint i=0; i<N; i++) {
+    rai::Frame* f = subTree ? sortedFrames.elem(i) : C.frames.elem(i);
+    F_Link& link=tree(subTree ? i : f->ID);
+    link.ID = f->ID;
+    link.X = f->ensure_X();
+    link.parent=-1;
+    link.type=-1;
+    link.qIndex=-1;
+    int parent = -1;
+    if(f->parent) parent = subTree ? subTreeParents(i) : (int)f->parent->ID;
+    if(parent!=-1) { //is not a root
+      link.parent = parent;
+      link.Q = f->get_Q();
+      rai::Joint* j=f->joint;
+      if(j && !j->mimic) {
+        link.type   = j->type;
+        link.qIndex = j->qIndex;
       } else {
-//        CHECK_EQ(link.type, rai::JT_rigid, "frame '" <<f->name <<"' has zero mass but joint");
-//        link.mass=1e-4;
+        if(j && j->mimic && created) LOG(0) <<"Featherstone cannot handle mimic joint ('" <<f->name <<"') properly - assuming rigid";
+        link.type   = rai::JT_rigid;
       }
-      n += link.dof();
+      if(subTree) link.qIndex = link.dof() ? n : -1;
     }
-//    CHECK_EQ(n, C.getJointStateDimension(), "");
-  } else { //just update an existing structure
-    for(rai::Frame* f: C.frames) {
-      F_Link& link=tree(f->ID);
-      link.X = f->ensure_X();
-      if(f->parent) link.Q = f->get_Q();
+    if(f->inertia) {
+      link.com = f->inertia->com;
+      link.mass=f->inertia->mass; CHECK(link.mass>0. || link.qIndex==-1, "a moving link without mass -> this will diverge");
+      link.inertia=f->inertia->matrix;
+    } else {
+      link.com.setZero();
+      link.mass=0.;
+      link.inertia.setZero();
     }
+    n += link.dof();
   }
 
   for(F_Link& link:tree) link.setFeatherstones();
@@ -630,9 +717,9 @@ void FeatherstoneInterface::fwdDynamics_aba_nD(arr& qdd,
       tau_i(i).clear(); tau_i(i).resize(0);
     }
     n += d_i;
-    h(i) = tree(i)._h;
-    h(i).reshape(6, d_i);
-    Xup[i] = tree(i)._Q; //the transformation from the i-th to the j-th
+    h(i) = tree(i)._h.asArr();
+    if(d_i) h(i).reshape(6, d_i); else h(i).resize(6, (uint)0);
+    Xup[i] = tree(i)._Q.asArr(); //the transformation from the i-th to the j-th
   }
   CHECK(n==qd.N && n==qdd.N && n==tau.N, "")
 
@@ -645,8 +732,9 @@ void FeatherstoneInterface::fwdDynamics_aba_nD(arr& qdd,
       v[i] = Xup[i] * v[par] + h(i) * qd_i(i);
       dh_dq[i] = Featherstone::crossM(v[i]) * h(i) * qd_i(i);
     }
-    IA[i] = tree(i)._I;
-    fA[i] = Featherstone::crossF(v[i]) * tree(i)._I * v[i] - tree(i)._f;
+    arr I = tree(i)._I.asArr();
+    IA[i] = I;
+    fA[i] = Featherstone::crossF(v[i]) * I * v[i] - tree(i)._f.asArr();
   }
 
   for(i=N; i--;) {
@@ -684,62 +772,60 @@ void FeatherstoneInterface::fwdDynamics_aba_nD(arr& qdd,
 void FeatherstoneInterface::fwdDynamics_aba_1D(arr& qdd,
     const arr& qd,
     const arr& tau) {
+  using namespace Featherstone;
   uint N=tree.N;
-  arr I_h(N, 6), inv_h_I_h(N), tau__h_fA(N);
-  arr dh_dq(N, 6);
-  arr vJ, Ia, fa;
-
-  qdd.resizeAs(tau);
-  dh_dq.setZero();
+  qdd.resizeAs(tau).setZero();
 
-  //fwd: compute the velocities v[i] and external + Coriolis forces fA[i] of all bodies
+  //fwd: compute the velocities v[i] and external + Coriolis forces (stored in F) of all bodies
   // v[i] = total velocity, but in joint coordinates
   for(uint i=0; i<N; i++) {
     F_Link& b = tree(i);
+    b.c.setZero();
     if(b.parent!=-1) {
+      b.v = b._Q * tree(b.parent).v; //eq (27)
       if(b.qIndex!=-1) {//is not a fixed joint
-        vJ = b._h * qd(b.qIndex); //equation (2), vJ = relative vel across joint i
-        b.v = b._Q * tree(b.parent).v + vJ; //eq (27)
-        dh_dq[i] = Featherstone::crossM(b.v) * vJ;  //WHY??
-      } else {
-        b.v = b._Q * tree(b.parent).v; //eq (27)
+        Vector6 vJ = qd(b.qIndex) * b._h; //equation (2), vJ = relative vel across joint i
+        b.v += vJ;
+        b.c = crossM(b.v, vJ);
       }
-    }else{
-      b.v.resize(6).setZero();
+    } else {
+      b.v.setZero();
     }
-    b.F = Featherstone::crossF(b.v) * (b._I * b.v) - b._f;  //first part of eq (29)
+    b.IA = b._I;
+    b.F = crossF(b.v, b._I * b.v) - b._f;  //first part of eq (29)
   }
 
-  //bwd: propagate tree inertia
-  for(int i=N; i--;) {
+  //bwd: propagate articulated inertias and bias forces
+  for(uint i=N; i--;) {
     F_Link& b = tree(i);
-    //eq (28)
-    if(b.parent!=-1) {
-      if(b.qIndex!=-1) {
-        I_h[i]       = b._I * b._h;
-        inv_h_I_h(i) = 1./scalarProduct(b._h, I_h[i]);
-        tau__h_fA(i) = tau(b.qIndex) - scalarProduct(b._h, b.F); //[change from above] last term in (13), 2nd equation below (13)
-        Ia = b._I - I_h[i]*(inv_h_I_h(i)*~I_h[i]);
-        fa = b.F + Ia*dh_dq[i] + I_h[i]*(inv_h_I_h(i)*tau__h_fA(i));
-        tree(b.parent)._I = tree(b.parent)._I + ~b._Q * Ia * b._Q;         //equation (12)
-        tree(b.parent).F = tree(b.parent).F + ~b._Q * fa;                  //equation (13)
-      } else {
-        tree(b.parent)._I = tree(b.parent)._I + ~b._Q * b._I * b._Q;         //equation (12)
-        tree(b.parent).F = tree(b.parent).F + ~b._Q * b.F;                  //equation (13)
-      }
+    if(b.parent==-1) continue;
+    F_Link& p = tree(b.parent);
+    if(b.qIndex!=-1) {
+      b.U = b.IA * b._h;
+      b.D = dot(b._h, b.U);
+      b.u = tau(b.qIndex) - dot(b._h, b.F);
+      //Ia = IA - U U'/D; pa = F + Ia c + U u/D
+      Matrix6& Ia = b.IA;
+      for(uint k=0; k<6; k++) for(uint l=0; l<6; l++) Ia(k, l) -= b.U[k]*b.U[l]/b.D;
+      Vector6 pa = b.F + Ia * b.c + (b.u/b.D) * b.U;
+      addCongruence(p.IA, b._Q, Ia); //equation (12)
+      p.F += mulT(b._Q, pa);           //equation (13)
+    } else {
+      addCongruence(p.IA, b._Q, b.IA);
+      p.F += mulT(b._Q, b.F);
     }
   }
 
-  for(uint i=0; i<tree.N; i++) {
+  for(uint i=0; i<N; i++) {
     F_Link& b = tree(i);
     if(b.parent != -1) {
-      b.a = b._Q * tree(b.parent).a + dh_dq[i]; //[change from above]
+      b.a = b._Q * tree(b.parent).a + b.c;
       if(b.qIndex!=-1) {
-        qdd(b.qIndex) = inv_h_I_h(i)*(tau__h_fA(i) - scalarProduct(I_h[i], b.a)); //equation (14)
-        b.a = b.a + b._h*qdd(b.qIndex); //equation above (14)
+        qdd(b.qIndex) = (b.u - dot(b.U, b.a))/b.D; //equation (14)
+        b.a += qdd(b.qIndex) * b._h; //equation above (14)
       }
     } else {
-      b.a = dh_dq[i]; //[change from above]
+      b.a.setZero();
     }
   }
 }
@@ -748,34 +834,107 @@ void FeatherstoneInterface::fwdDynamics_aba_1D(arr& qdd,
 
 void FeatherstoneInterface::invDynamics(arr& tau,
                                         const arr& qd,
-                                        const arr& qdd) {
-  tau.resizeAs(qdd);
+                                        const arr& qdd,
+                                        arr& tau_q,
+                                        arr& tau_qd,
+                                        arr& tau_qdd) {
+  using namespace Featherstone;
+  uint N=tree.N;
+  tau.resizeAs(qdd).setZero();
 
-  arr vJ;
-  for(uint i=0; i<tree.N; i++) {
+  //-- recursive Newton-Euler
+  for(uint i=0; i<N; i++) {
     F_Link& b = tree(i); //ith body
     if(b.parent!=-1) {
+      F_Link& p = tree(b.parent);
+      b.v = b._Q * p.v;
+      b.a = b._Q * p.a;
       if(b.qIndex!=-1) {//is not a fixed joint
-        vJ = b._h * qd(b.qIndex);
-        b.v = b._Q * tree(b.parent).v + vJ;
-        b.a = b._Q * tree(b.parent).a + b._h * qdd(b.qIndex) + Featherstone::crossM(b.v) * vJ;
-      } else {
-        b.v = b._Q * tree(b.parent).v;
-        b.a = b._Q * tree(b.parent).a;
+        Vector6 vJ = qd(b.qIndex) * b._h;
+        b.v += vJ;
+        b.a += qdd(b.qIndex) * b._h;
+        b.a += crossM(b.v, vJ);
       }
-    }else{
-      b.v.resize(6).setZero();
-      b.a.resize(6).setZero();
+    } else {
+      b.v.setZero();
+      b.a.setZero();
     }
-    b.F = b._I*b.a + Featherstone::crossF(b.v) * b._I * b.v - b._f;
+    b.F = b._I*b.a + crossF(b.v, b._I * b.v) - b._f;
   }
 
-  for(uint i=tree.N; i--;) {
+  for(uint i=N; i--;) {
     F_Link& b = tree(i);
-    if(b.qIndex != -1) {
-      tau(b.qIndex) = scalarProduct(b._h, b.F);
+    if(b.qIndex != -1) tau(b.qIndex) = dot(b._h, b.F);
+    if(b.parent != -1) tree(b.parent).F += mulT(b._Q, b.F);
+  }
+
+  //-- derivatives: forward-mode differentiation of the above, one dof at a time
+  // (with dX/dq = -crossM(h) X for the transform across the differentiated joint,
+  //  and the external forces rotating with the subtree of a hinge);
+  // a column only touches the subtree of its joint and the path to the root
+  arr* dtaus[3] = { &tau_q, &tau_qd, &tau_qdd }; //w.r.t. q, qd, qdd
+  bool any=false;
+  for(arr* dtau:dtaus) if(!!*dtau) { dtau->resize(tau.N, tau.N).setZero(); any=true; }
+  if(!any) return;
+
+  for(uint k=0; k<N; k++) {
+    F_Link& K = tree(k);
+    if(K.parent==-1 || K.qIndex==-1) continue;
+    bool isHinge = (K.type>=rai::JT_hingeX && K.type<=rai::JT_hingeZ);
+    rai::Vector w = K.X.rot * rai::Vector(K._h[0], K._h[1], K._h[2]); //hinge axis in world coordinates
+
+    for(uint wrt=0; wrt<3; wrt++) {
+      arr& dtau = *dtaus[wrt];
+      if(!dtau) continue;
+
+      for(int a=K.parent; a!=-1; a=tree(a).parent) { tree(a).moved=false; tree(a).dF.setZero(); }
+      for(uint i=k; i<N; i++) {
+        F_Link& b = tree(i);
+        b.moved = (i==k) || (b.parent>=(int)k && tree(b.parent).moved); //(links before k may hold stale flags)
+        if(!b.moved) continue;
+        F_Link& p = tree(b.parent);
+        if(i==k) {
+          if(wrt==0) {
+            b.dv = crossM(b._Q * p.v, b._h);
+            b.da = crossM(b._Q * p.a, b._h);
+          } else if(wrt==1) {
+            b.dv = b._h;
+            b.da = crossM(b.v, b._h);
+          } else {
+            b.dv.setZero();
+            b.da = b._h;
+          }
+        } else {
+          b.dv = b._Q * p.dv;
+          b.da = b._Q * p.da;
+        }
+        if(wrt==2) { b.dF = b._I * b.da; continue; }
+        if(b.qIndex!=-1) b.da += crossM(b.dv, qd(b.qIndex) * b._h);
+        b.dF = b._I * b.da + crossF(b.dv, b._I * b.v) + crossF(b.v, b._I * b.dv);
+        if(wrt==0 && isHinge) {
+          //the world-fixed external force (see updateFeatherstones) rotates relative to the subtree links
+          rai::Quaternion rotInv = -b.X.rot;
+          rai::Vector c = b.X.rot*b.com;
+          rai::Vector dto = rotInv * (((w ^ c) ^ b.force) - (w ^ (b.torque + (c ^ b.force))));
+          rai::Vector dfo = rotInv * (b.force ^ w);
+          b.dF[0] -= dto.x;  b.dF[1] -= dto.y;  b.dF[2] -= dto.z;
+          b.dF[3] -= dfo.x;  b.dF[4] -= dfo.y;  b.dF[5] -= dfo.z;
+        }
+      }
+
+      for(uint i=N; i-->k;) {
+        F_Link& b = tree(i);
+        if(!b.moved) continue;
+        if(b.qIndex != -1) dtau(b.qIndex, K.qIndex) = dot(b._h, b.dF);
+        if(i==k && wrt==0) b.dF += crossF(b._h, b.F); //(dX/dq)^T F
+        tree(b.parent).dF += mulT(b._Q, b.dF);
+      }
+      for(int a=K.parent; a!=-1; a=tree(a).parent) {
+        F_Link& b = tree(a);
+        if(b.qIndex != -1) dtau(b.qIndex, K.qIndex) = dot(b._h, b.dF);
+        if(b.parent != -1) tree(b.parent).dF += mulT(b._Q, b.dF);
+      }
     }
-    if(b.parent != -1) tree(b.parent).F += ~b._Q * b.F;
   }
 }
 
@@ -819,9 +978,9 @@ void FeatherstoneInterface::equationOfMotion(arr& H, arr& C,
   for(i=0; i<N; i++) {
     iq  = tree(i).qIndex;
     par = tree(i).parent;
-    Xup[i] = tree(i)._Q; //the transformation from the i-th to the j-th
+    Xup[i] = tree(i)._Q.asArr(); //the transformation from the i-th to the j-th
     if(par!=-1) {
-      h[i] = tree(i)._h;
+      h[i] = tree(i)._h.asArr();
       if(iq!=-1) {//is not a fixed joint
         vJ = h[i] * qd(iq); //equation (2), vJ = relative vel across joint i
         v[i] = Xup[i]*v[par] + vJ;
@@ -832,8 +991,9 @@ void FeatherstoneInterface::equationOfMotion(arr& H, arr& C,
         avp[i] = Xup[i] * avp[par];
       }
     }
-    IC[i] = tree(i)._I;
-    fvp[i] = tree(i)._I*avp[i] + Featherstone::crossF(v[i])*(tree(i)._I*v[i]) - tree(i)._f;
+    arr I = tree(i)._I.asArr();
+    IC[i] = I;
+    fvp[i] = I*avp[i] + Featherstone::crossF(v[i])*(I*v[i]) - tree(i)._f.asArr();
   }
 
   C.resize(qd.N).setZero();
@@ -11,6 +11,88 @@
 #include "kin.h"
 #include "../Geo/geo.h"
 
+//===========================================================================
+//
+// fixed-size spatial algebra: 6D motion and force vectors [angular; linear], 6x6 matrices (row-major)
+// -- all on the stack, no allocations
+//
+
+namespace Featherstone {
+
+struct Vector6 {
+  double v[6] = {0., 0., 0., 0., 0., 0.};
+
+  double& operator[](uint i) { return v[i]; }
+  double operator[](uint i) const { return v[i]; }
+  Vector6& setZero() { for(uint i=0; i<6; i++) v[i]=0.; return *this; }
+  Vector6& operator+=(const Vector6& x) { for(uint i=0; i<6; i++) v[i]+=x.v[i]; return *this; }
+  Vector6& operator-=(const Vector6& x) { for(uint i=0; i<6; i++) v[i]-=x.v[i]; return *this; }
+  Vector6& operator*=(double s) { for(uint i=0; i<6; i++) v[i]*=s; return *this; }
+  arr asArr() const { return arr(v, 6, false); }
+};
+
+struct Matrix6 {
+  double m[36];
+
+  Matrix6() { setZero(); }
+  double& operator()(uint i, uint j) { return m[6*i+j]; }
+  double operator()(uint i, uint j) const { return m[6*i+j]; }
+  Matrix6& setZero() { for(uint i=0; i<36; i++) m[i]=0.; return *this; }
+  Matrix6& operator+=(const Matrix6& x) { for(uint i=0; i<36; i++) m[i]+=x.m[i]; return *this; }
+  arr asArr() const { return arr(m, 36, false).reshape(6, 6); }
+
+  void setTransform(const rai::Transformation& f); ///< motion transform from parent to a frame with relative pose f (as FrameToMatrix)
+  void setRBI(double mass, const rai::Vector& com, const rai::Matrix& I); ///< rigid-body inertia (as RBmci)
+};
+
+inline Vector6 operator+(const Vector6& a, const Vector6& b) { Vector6 y=a; y+=b; return y; }
+inline Vector6 operator-(const Vector6& a, const Vector6& b) { Vector6 y=a; y-=b; return y; }
+inline Vector6 operator*(double s, const Vector6& a) { Vector6 y=a; y*=s; return y; }
+inline double dot(const Vector6& a, const Vector6& b) { double s=0.; for(uint i=0; i<6; i++) s+=a.v[i]*b.v[i]; return s; }
+
+/// y = A x
+inline Vector6 operator*(const Matrix6& A, const Vector6& x) {
+  Vector6 y;
+  for(uint i=0; i<6; i++) { const double* a=A.m+6*i; y.v[i] = a[0]*x.v[0]+a[1]*x.v[1]+a[2]*x.v[2]+a[3]*x.v[3]+a[4]*x.v[4]+a[5]*x.v[5]; }
+  return y;
+}
+
+/// y = A^T x (e.g. force transform child->parent, for a motion transform A parent->child)
+inline Vector6 mulT(const Matrix6& A, const Vector6& x) {
+  Vector6 y;
+  for(uint j=0; j<6; j++) { double xj=x.v[j]; if(!xj) continue; const double* a=A.m+6*j; for(uint i=0; i<6; i++) y.v[i] += a[i]*xj; }
+  return y;
+}
+
+/// motion cross product v x m
+inline Vector6 crossM(const Vector6& v, const Vector6& m) {
+  const double* w=v.v, *l=v.v+3, *mw=m.v, *ml=m.v+3;
+  Vector6 y;
+  y.v[0] = w[1]*mw[2]-w[2]*mw[1];  y.v[1] = w[2]*mw[0]-w[0]*mw[2];  y.v[2] = w[0]*mw[1]-w[1]*mw[0];
+  y.v[3] = w[1]*ml[2]-w[2]*ml[1] + l[1]*mw[2]-l[2]*mw[1];
+  y.v[4] = w[2]*ml[0]-w[0]*ml[2] + l[2]*mw[0]-l[0]*mw[2];
+  y.v[5] = w[0]*ml[1]-w[1]*ml[0] + l[0]*mw[1]-l[1]*mw[0];
+  return y;
+}
+
+/// force cross product v x* f
+inline Vector6 crossF(const Vector6& v, const Vector6& f) {
+  const double* w=v.v, *l=v.v+3, *fw=f.v, *fl=f.v+3;
+  Vector6 y;
+  y.v[0] = w[1]*fw[2]-w[2]*fw[1] + l[1]*fl[2]-l[2]*fl[1];
+  y.v[1] = w[2]*fw[0]-w[0]*fw[2] + l[2]*fl[0]-l[0]*fl[2];
+  y.v[2] = w[0]*fw[1]-w[1]*fw[0] + l[0]*fl[1]-l[1]*fl[0];
+  y.v[3] = w[1]*fl[2]-w[2]*fl[1];  y.v[4] = w[2]*fl[0]-w[0]*fl[2];  y.v[5] = w[0]*fl[1]-w[1]*fl[0];
+  return y;
+}
+
+/// A += X^T I X (transforming an inertia from child to parent coordinates)
+void addCongruence(Matrix6& A, const Matrix6& X, const Matrix6& I);
+
+} //namespace Featherstone
+
+//===========================================================================
+
 struct F_Link {
   int ID=-1;
   int type=-1;
@@ -22,8 +104,14 @@ struct F_Link {
   rai::Matrix inertia=0;
   uint dof();
 
-  arr _h, _Q, _I, _f; //featherstone types
-  arr v, a, F; //compute variables
+  Featherstone::Vector6 _h, _f; //featherstone types: joint axis, external force
+  Featherstone::Matrix6 _Q, _I; //featherstone types: transform from parent, inertia
+  Featherstone::Vector6 v, a, F; //compute variables
+  Featherstone::Matrix6 IA; //articulated inertia (ABA)
+  Featherstone::Vector6 c, U; //velocity product acceleration, IA*h (ABA)
+  double D=0., u=0.; //h'*IA*h, and joint force minus bias (ABA)
+  Featherstone::Vector6 dv, da, dF; //derivatives w.r.t. one q or qd (inverse dynamics derivatives)
+  bool moved=false; //whether the link is in the subtree of the differentiated joint
 
   F_Link() {}
   void setFeatherstones();
@@ -46,7 +134,14 @@ struct FeatherstoneInterface {
 
   rai::Array<F_Link> tree;
 
+  bool subTree=false; ///< whether the tree is over a subset of frames (see 2nd constructor)
+  intA subTreeParents; ///< for a subTree: the index of each frame's parent within sortedFrames, -1 for bases
+
   FeatherstoneInterface(rai::Configuration& C):C(C) { sortedFrames = C.calc_topSort(); }
+  /// a tree over only the given frames (parents before children), e.g. one time slice of a KOMO path configuration:
+  /// frames whose parent is not in the list are fixed bases; the dofs are indexed 0..n-1 in the order of the frames
+  FeatherstoneInterface(rai::Configuration& C, const FrameL& frames);
+  static uint dim(const FrameL& frames); ///< the number of dofs of the tree over these frames
 
   void setGravity(double g=-9.81);
   void update();
@@ -55,5 +150,7 @@ struct FeatherstoneInterface {
   void fwdDynamics_MF(arr& qdd, const arr& qd, const arr& u);
   void fwdDynamics_aba_nD(arr& qdd, const arr& qd, const arr& tau);
   void fwdDynamics_aba_1D(arr& qdd, const arr& qd, const arr& tau);
-  void invDynamics(arr& tau, const arr& qd, const arr& qdd);
+  /// optionally with derivatives w.r.t. q, qd, and qdd (=mass matrix); these are dense n-by-n, computed column by column
+  /// in forward mode, each in O(subtree + depth) of its joint
+  void invDynamics(arr& tau, const arr& qd, const arr& qdd, arr& tau_q=NoArr, arr& tau_qd=NoArr, arr& tau_qdd=NoArr);
 };
@@ -238,6 +238,7 @@ void PhysXInterface_self::initPhysics() {
   sceneDesc.bounceThresholdVelocity = .1;
   //sceneDesc.flags |= PxSceneFlag::eENABLE_GPU_DYNAMICS;
   sceneDesc.flags |= PxSceneFlag::eENABLE_PCM;
+  sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS; //for getActiveBodies
   // sceneDesc.flags |= PxSceneFlag::eENABLE_CCD; //continuous collision detection (requires more enables for each body.. https://docs.nvidia.com/gameworks/content/gameworkslibrary/physx/guide/Manual/AdvancedCollisionDetection.html )
   //sceneDesc.broadPhaseType = PxBroadPhaseType::eGPU;
   sceneDesc.gpuMaxNumPartitions = 8;
@@ -1090,6 +1091,52 @@ void PhysXInterface::pullDynamicStates(rai::Configuration& C, arr& frameVelociti
   }
 }
 
+void PhysXInterface::getBodyStates(uintA& frameIDs, arr& states) {
+  frameIDs.clear();
+  for(uint i=0; i<self->actors.N; i++) {
+    PxRigidActor* a = self->actors(i);
+    if(a && self->actorTypes(i)==rai::BT_dynamic && a->getType()==PxActorType::eRIGID_DYNAMIC) frameIDs.append(i);
+  }
+  states.resize(frameIDs.N, 13);
+  for(uint k=0; k<frameIDs.N; k++) {
+    PxRigidDynamic* b = (PxRigidDynamic*)self->actors(frameIDs(k));
+    PxTransform pose = b->getGlobalPose();
+    PxVec3 v = b->getLinearVelocity(), w = b->getAngularVelocity();
+    float s[13] = {pose.p.x, pose.p.y, pose.p.z, pose.q.w, pose.q.x, pose.q.y, pose.q.z, v.x, v.y, v.z, w.x, w.y, w.z};
+    for(uint j=0; j<13; j++) states(k, j) = s[j];
+  }
+}
+
+void PhysXInterface::getActiveBodies(uintA& frameIDs) {
+  frameIDs.clear();
+  PxU32 n=0;
+  PxActor** active = self->gScene->getActiveActors(n);
+  for(PxU32 i=0; i<n; i++) {
+    rai::Frame* f = (rai::Frame*)active[i]->userData;
+    if(f && active[i]->getType()==PxActorType::eRIGID_DYNAMIC && self->actorTypes(f->ID)==rai::BT_dynamic) frameIDs.append(f->ID);
+  }
+}
+
+uint PhysXInterface::setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states) {
+  CHECK_EQ(states.d0, frameIDs.N, "");
+  uint touched=0;
+  for(uint k=0; k<frameIDs.N; k++) {
+    PxRigidDynamic* b = (PxRigidDynamic*)self->actors(frameIDs(k));
+    PxTransform pose = b->getGlobalPose();
+    PxVec3 v = b->getLinearVelocity(), w = b->getAngularVelocity();
+    float s[13], cur[13] = {pose.p.x, pose.p.y, pose.p.z, pose.q.w, pose.q.x, pose.q.y, pose.q.z, v.x, v.y, v.z, w.x, w.y, w.z};
+    for(uint j=0; j<13; j++) s[j] = states(k, j); //exact: the states were floats
+    if(!memcmp(s, cur, sizeof(s))) continue;
+    pose = PxTransform(PxVec3(s[0], s[1], s[2]), PxQuat(s[4], s[5], s[6], s[3]));
+    b->setGlobalPose(pose);
+    b->setLinearVelocity(PxVec3(s[7], s[8], s[9]));
+    b->setAngularVelocity(PxVec3(s[10], s[11], s[12]));
+    C.frames.elem(frameIDs(k))->set_X() = conv_PxTrans2Transformation(pose);
+    touched++;
+  }
+  return touched;
+}
+
 void PhysXInterface::changeObjectType(rai::Frame* f, int _type) {
   rai::Enum<rai::BodyType> type((rai::BodyType)_type);
   if(self->actorTypes(f->ID) == type) {
@@ -1326,6 +1373,9 @@ void PhysXInterface::pushFrameStates(const rai::Configuration& C, const arr& fra
 void PhysXInterface::pullDynamicStates(rai::Configuration& C, arr& vels) { NICO }
 void PhysXInterface::pushMotorTargets(const rai::Configuration& C, const arr& qDot_ref, bool setStatesInstantly) { NICO }
 void PhysXInterface::pullMotorStates(rai::Configuration& C, arr& qDot) { NICO }
+void PhysXInterface::getBodyStates(uintA& frameIDs, arr& states) { NICO }
+void PhysXInterface::getActiveBodies(uintA& frameIDs) { NICO }
+uint PhysXInterface::setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states) { NICO }
 void PhysXInterface::postAddObject(rai::Frame* f) { NICO }
 
 void PhysXInterface::changeObjectType(rai::Frame* f, int _type) { NICO }
@@ -1344,6 +1394,11 @@ rai::PhysX_Options& PhysXInterface::opt() { NICO }
 
 #endif
 
+Mutex& PhysX_mutex() {
+  static Mutex mutex;
+  return mutex;
+}
+
 #ifdef RAI_PHYSX
 RUN_ON_INIT_BEGIN(kin_physx)
 rai::Array<PxGeometry*>::memMove=true;
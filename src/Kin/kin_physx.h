@@ -37,6 +37,14 @@ struct PhysXInterface {
   void pushMotorTargets(const rai::Configuration& C, const arr& qDot_ref=NoArr, bool setStatesInstantly=false);
   void pullMotorStates(rai::Configuration& C, arr& qDot);
 
+  /// engine-native states of all dynamic rigid bodies (not articulation links): frame IDs, and per body [pos, quat, linVel, angVel]
+  void getBodyStates(uintA& frameIDs, arr& states);
+  /// frame IDs of the dynamic bodies (not articulation links) the last step has moved (sleeping bodies are skipped)
+  void getActiveBodies(uintA& frameIDs);
+  /// restores body states from getBodyStates, touching only bodies whose state differs (and setting their frame poses in C);
+  /// returns the number of touched bodies
+  uint setBodyStates(rai::Configuration& C, const uintA& frameIDs, const arr& states);
+
   void changeObjectType(rai::Frame* f, int type);
   void addRigidJoint(rai::Frame* from, rai::Frame* to);
   void removeJoint(const rai::Frame* from, const rai::Frame* to);
@@ -50,3 +58,6 @@ struct PhysXInterface {
   rai::Configuration& getDebugConfig();
   rai::PhysX_Options& opt();
 };
+
+/// all PhysXInterfaces share one PxPhysics: threads that use separate interfaces concurrently lock this around their PhysX calls
+Mutex& PhysX_mutex();
@@ -15,6 +15,7 @@
 #include "F_collisions.h"
 #include "../Gui/opengl.h"
 #include "../Algo/SplineCtrlFeed.h"
+#include "../Core/thread.h"
 
 #include <iomanip>
 //#define BACK_BRIDGE
@@ -53,6 +54,16 @@ struct Simulation_self {
   struct ForceRef{ arr f_ref; arr Jf; double kf=0.; double cap=-1.; };
   ForceRef forceRef;
 
+  //-- snapshots, see getSnapshot
+  shared_ptr<const SimulationSnapshot> snapshotBase; //the first snapshot
+  std::weak_ptr<const SimulationSnapshot> synced; //the last taken or restored snapshot: the state equals it, up to the moved bodies
+  intA bodyIndex, frameIndex; //frame ID -> index in snapshotBase->bodies or ->frames (-1 if none)
+  uintA movedBodies; //indices (in snapshotBase->bodies) of bodies moved by steps since 'synced'
+  boolA isMoved;
+  void noteMovedBody(int k) { if(k>=0 && !isMoved(k)) { isMoved(k)=true; movedBodies.append(k); } }
+  void noteMovedBodies(const uintA& frameIDs) { for(uint id:frameIDs) if(id<bodyIndex.N) noteMovedBody(bodyIndex(id)); }
+  void clearMovedBodies() { for(uint k:movedBodies) isMoved(k)=false; movedBodies.clear(); }
+
   void updateDisplayData(double _time, const Configuration& _C);
   void updateDisplayData(const byteA& _image, const floatA& _depth);
 };
@@ -269,6 +280,7 @@ void Simulation::step(const arr& u_control, double tau, ControlMode u_mode) {
     self->physx->step(tau);
     self->physx->pullDynamicStates(C, self->frameVelocities);
     self->physx->pullMotorStates(C, self->qDot);
+    if(self->snapshotBase) { uintA active; self->physx->getActiveBodies(active); self->noteMovedBodies(active); }
   } else if(engine==_bullet) {
     self->bullet->pushKinematicStates(C);
     if(self->bullet->opt().multiBody) {
@@ -277,6 +289,7 @@ void Simulation::step(const arr& u_control, double tau, ControlMode u_mode) {
     }
     self->bullet->step(tau);
     self->bullet->pullDynamicStates(C); //, self->frameVelocities);
+    if(self->snapshotBase) { uintA active; self->bullet->getActiveBodies(active); self->noteMovedBodies(active); }
 #ifdef BACK_BRIDGE
     self->bulletBridge->pullPoses(self->bridgeC, true);
     self->bridgeC.view(false, "bullet bridge");
@@ -543,7 +556,131 @@ void Simulation::pushConfigurationToSimulator(const arr& frameVelocities, const
   } else if(engine==_bullet) {
     self->bullet->pushFullState(C, frameVelocities);
   } else NIY;
+  self->synced.reset(); //the next restoreSnapshot compares all bodies and frames
+  if(self->display) self->updateDisplayData(time, C);
+}
+
+shared_ptr<const SimulationSnapshot> Simulation::getSnapshot() {
+  auto snap = make_shared<SimulationSnapshot>();
+  snap->time = time;
+  snap->stepCount = stepCount;
+  uintA bodies;
+  arr bodyStates;
+  if(engine==_physx) self->physx->getBodyStates(bodies, bodyStates);
+  else if(engine==_bullet) self->bullet->getBodyStates(bodies, bodyStates);
+  snap->q = C.getJointState();
+  snap->qDot = self->qDot;
+
+  const SimulationSnapshot* base = self->snapshotBase.get();
+  if(!base) {
+    //-- the base: all bodies, and all root frames that are not engine bodies
+    snap->bodies = bodies;
+    snap->bodyStates = bodyStates;
+    boolA isBody(C.frames.N);
+    isBody = false;
+    for(uint i:bodies) isBody(i) = true;
+    for(Frame* f:C.frames) if(!f->parent && !isBody(f->ID)) snap->frames.append(f->ID);
+    self->bodyIndex.resize(C.frames.N) = -1;
+    self->frameIndex.resize(C.frames.N) = -1;
+    for(uint k=0; k<bodies.N; k++) self->bodyIndex(bodies(k)) = k;
+    for(uint k=0; k<snap->frames.N; k++) self->frameIndex(snap->frames(k)) = k;
+    self->isMoved.resize(bodies.N) = false;
+  } else {
+    //-- otherwise only bodies and root frames that differ from the base
+    snap->base = self->snapshotBase;
+    CHECK_EQ(bodies, base->bodies, "the engine's bodies changed since the first snapshot");
+    for(uint k=0; k<bodies.N; k++) {
+      if(memcmp(bodyStates.p+13*k, base->bodyStates.p+13*k, 13*sizeof(double))) snap->bodies.append(bodies(k));
+    }
+    snap->bodyStates.resize(snap->bodies.N, 13);
+    for(uint k=0; k<snap->bodies.N; k++) memmove(snap->bodyStates.p+13*k, bodyStates.p+13*self->bodyIndex(snap->bodies(k)), 13*sizeof(double));
+    for(uint k=0; k<base->frames.N; k++) {
+      const Transformation& X = C.frames.elem(base->frames(k))->ensure_X();
+      const double* x = base->X.p+7*k;
+      if(memcmp(x, &X.pos.x, 3*sizeof(double)) || memcmp(x+3, &X.rot.w, 4*sizeof(double))) snap->frames.append(base->frames(k));
+    }
+  }
+  snap->X.resize(snap->frames.N, 7);
+  for(uint k=0; k<snap->frames.N; k++) {
+    const Transformation& X = C.frames.elem(snap->frames(k))->ensure_X();
+    memmove(snap->X.p+7*k, &X.pos.x, 3*sizeof(double));
+    memmove(snap->X.p+7*k+3, &X.rot.w, 4*sizeof(double));
+  }
+
+  if(!base) self->snapshotBase = snap;
+  self->synced = snap;
+  self->clearMovedBodies();
+  return snap;
+}
+
+uint Simulation::restoreSnapshot(const SimulationSnapshot& snap) {
+  CHECK(snap.base ? snap.base==self->snapshotBase : &snap==self->snapshotBase.get(), "snapshot is not from this simulation");
+  const SimulationSnapshot& base = *self->snapshotBase;
+  uint touched=0;
+  time = snap.time;
+  stepCount = snap.stepCount;
+
+  //-- joint state (moves the articulated frames in C)
+  const arr& q = C.getJointState();
+  bool qChanged = (q.N!=snap.q.N || memcmp(q.p, snap.q.p, q.N*q.sizeT));
+  bool qDotChanged = (self->qDot.N!=snap.qDot.N || memcmp(self->qDot.p, snap.qDot.p, snap.qDot.N*snap.qDot.sizeT));
+  if(qChanged) C.setJointState(snap.q);
+  if(qDotChanged) self->qDot = snap.qDot;
+  if((qChanged || qDotChanged) && engine==_physx) self->physx->pushMotorTargets(C, self->qDot, true);
+  if(qChanged || qDotChanged) touched++;
+
+  //-- the candidates to restore, as sorted indices into the base: if the state equals a snapshot 'from' (up to the moved bodies),
+  //   only the bodies and frames in the deltas of 'from' and 'snap' (the base has an empty delta); otherwise all
+  shared_ptr<const SimulationSnapshot> from = self->synced.lock();
+  uintA frameIdx, bodyIdx;
+  if(from) {
+    for(const SimulationSnapshot* s: {from.get(), &snap}) if(s->base) {
+      for(uint id:s->frames) frameIdx.append(self->frameIndex(id));
+      for(uint id:s->bodies) self->noteMovedBody(self->bodyIndex(id));
+    }
+    frameIdx.sort();
+    bodyIdx = self->movedBodies;
+    bodyIdx.sort();
+  } else {
+    frameIdx.setStraightPerm(base.frames.N);
+    bodyIdx.setStraightPerm(base.bodies.N);
+  }
+  uintA none;
+  const uintA& snapFrames = snap.base ? snap.frames : none;
+  const uintA& snapBodies = snap.base ? snap.bodies : none;
+
+  //-- root frames: the snapshot's delta, or else the base
+  for(uint i=0, j=0; i<frameIdx.N; i++) {
+    uint k = frameIdx(i);
+    if(i && k==frameIdx(i-1)) continue;
+    while(j<snapFrames.N && (uint)self->frameIndex(snapFrames(j))<k) j++;
+    const double* x = (j<snapFrames.N && snapFrames(j)==base.frames(k) ? snap.X.p+7*j : base.X.p+7*k);
+    Frame* f = C.frames.elem(base.frames(k));
+    const Transformation& Xf = f->ensure_X();
+    if(!memcmp(x, &Xf.pos.x, 3*sizeof(double)) && !memcmp(x+3, &Xf.rot.w, 4*sizeof(double))) continue;
+    Transformation X;
+    X.set(x);
+    f->set_X() = X; //kinematic actors are pushed to the engine with the next step
+    touched++;
+  }
+
+  //-- engine bodies: the snapshot's delta, or else the base (the engine touches only those whose state differs)
+  uintA bodies(bodyIdx.N);
+  arr states(bodyIdx.N, 13);
+  for(uint i=0, j=0; i<bodyIdx.N; i++) {
+    uint k = bodyIdx(i);
+    while(j<snapBodies.N && (uint)self->bodyIndex(snapBodies(j))<k) j++;
+    bodies(i) = base.bodies(k);
+    const double* x = (j<snapBodies.N && snapBodies(j)==bodies(i) ? snap.bodyStates.p+13*j : base.bodyStates.p+13*k);
+    memmove(states.p+13*i, x, 13*sizeof(double));
+  }
+  if(engine==_physx) touched += self->physx->setBodyStates(C, bodies, states);
+  else if(engine==_bullet) touched += self->bullet->setBodyStates(C, bodies, states);
+
+  self->synced = snap.weak_from_this();
+  self->clearMovedBodies();
   if(self->display) self->updateDisplayData(time, C);
+  return touched;
 }
 
 void Simulation::registerNewObjectWithEngine(Frame* f) {
@@ -553,6 +690,7 @@ void Simulation::registerNewObjectWithEngine(Frame* f) {
   } else if(engine==_bullet) {
     NIY;
   } else NIY;
+  self->synced.reset();
 }
 
 const arr& Simulation::get_qDot() {
@@ -1090,6 +1228,97 @@ void Simulation::loadTeleopCallbacks() {
   self->display->gl->addHoverCall(teleopCallbacks.get());
 }
 
+//===========================================================================
+
+SimulationBatch::SimulationBatch(const Configuration& C, uint n, Simulation::Engine engine) {
+  worlds.resize(n);
+  sims.resize(n);
+  //sequentially, as engine creation (e.g. of the shared PhysX foundation) is not thread safe
+  for(uint w=0; w<n; w++) {
+    worlds(w) = make_shared<Configuration>(C);
+    sims(w) = make_shared<Simulation>(*worlds(w), engine, opt.verbose);
+  }
+}
+
+Mutex::Token SimulationBatch::lockEngine(Simulation& S) {
+  if(S.engine==Simulation::_physx && !opt.parallelPhysx) return PhysX_mutex()(RAI_HERE);
+  return Mutex::Token();
+}
+
+void SimulationBatch::step(const arr& U, double tau, Simulation::ControlMode u_mode) {
+  if(U.N) CHECK_EQ(U.d0, sims.N, "U needs one row per world");
+  parallelFor(sims.N, [&](uint w, uint worker) {
+    auto lock = lockEngine(*sims(w));
+    if(U.N) sims(w)->step(U[w], tau, u_mode);
+    else sims(w)->step({}, tau, u_mode);
+  }, opt.threads);
+}
+
+void SimulationBatch::getState(arr& X, arr& Q, arr& V, arr& QDot) {
+  uint n=sims.N, nFrames=worlds(0)->frames.N, d=worlds(0)->getJointStateDimension();
+  X.resize(n, nFrames, 7);
+  if(!!Q) Q.resize(n, d);
+  if(!!V) V.resize(uintA{n, nFrames, 2, 3});
+  if(!!QDot) QDot.resize(n, d);
+
+  parallelFor(n, [&](uint w, uint worker) {
+    Simulation& S = *sims(w);
+    Configuration& C = S.C;
+    CHECK_EQ(C.frames.N, nFrames, "worlds differ in their number of frames");
+    auto lock = lockEngine(S);
+
+    //-- velocities, pulled directly into the rows of V and QDot
+    arr Vw, QDotw;
+    if(!!V) Vw.referToDim(V, w);
+    if(!!QDot) QDotw.referToDim(QDot, w);
+    if(S.engine==Simulation::_physx) {
+      S.self->physx->pullDynamicStates(C, !!V ? Vw : NoArr);
+      if(!!QDot) S.self->physx->pullMotorStates(C, QDotw);
+    } else if(S.engine==Simulation::_bullet) {
+      S.self->bullet->pullDynamicStates(C, !!V ? Vw : NoArr);
+    } else {
+      if(!!V) Vw.setZero();
+    }
+    if(!!QDot && S.engine!=Simulation::_physx) { //the commanded velocity: BulletInterface has no motor state readout
+      if(S.self->qDot.N==d) QDotw = S.self->qDot; else QDotw.setZero();
+    }
+
+    //-- poses (as in Configuration::getFrameState) and joint state
+    double* x = X.p + w*nFrames*7;
+    for(Frame* f:C.frames) {
+      Transformation Xf = f->ensure_X();
+      Xf.rot.uniqueSign();
+      memmove(x, &Xf.pos.x, 3*sizeof(double));
+      memmove(x+3, &Xf.rot.w, 4*sizeof(double));
+      x += 7;
+    }
+    if(!!Q) {
+      const arr& q = C.getJointState();
+      CHECK_EQ(q.N, d, "worlds differ in their joint dimension");
+      memmove(Q.p + w*d, q.p, d*sizeof(double));
+    }
+  }, opt.threads);
+}
+
+void SimulationBatch::setState(const arr& X, const arr& Q, const arr& V, const arr& QDot) {
+  CHECK_EQ(X.d0, sims.N, "X needs one row per world");
+  parallelFor(sims.N, [&](uint w, uint worker) {
+    Simulation& S = *sims(w);
+    auto lock = lockEngine(S);
+    arr Qw, Vw, QDotw; //references into the rows of Q, V, QDot (if given)
+    if(!!Q && Q.N) Qw.referToDim(Q, w);
+    if(!!V && V.N) Vw.referToDim(V, w);
+    if(!!QDot && QDot.N) QDotw.referToDim(QDot, w);
+    if(S.engine==Simulation::_kinematic) {
+      S.C.setFrameState(X[w]);
+      if(Qw.N) S.C.setJointState(Qw);
+      if(QDotw.N) S.self->qDot = QDotw;
+    } else {
+      S.setState(X[w], Qw, Vw, QDotw);
+    }
+  }, opt.threads);
+}
+
 bool TeleopCallbacks::hasNewMarker() {
   if(markerWasSet) { markerWasSet=false; return true; }
   return false;
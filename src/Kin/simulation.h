@@ -16,6 +16,18 @@ namespace rai {
 struct SimulationImp;
 struct TeleopCallbacks;
 
+/// a snapshot of a simulation's state (see Simulation::getSnapshot); immutable once taken, to be shared (e.g. by the nodes of a search tree)
+struct SimulationSnapshot : std::enable_shared_from_this<SimulationSnapshot> {
+  double time=0.;
+  uint stepCount=0;
+  uintA bodies;    ///< frame IDs of the engine's dynamic bodies whose state differs from the base (all of them in the base)
+  arr bodyStates;  ///< their engine-native states (bodies.N x 13)
+  arr q, qDot;
+  uintA frames;    ///< frame IDs of the remaining root frames whose pose differs from the first snapshot (shared as 'base')
+  arr X;           ///< their poses (frames.N x 7)
+  shared_ptr<const SimulationSnapshot> base; ///< the first snapshot of this simulation, holding the poses of all root frames
+};
+
 //a non-threaded simulation with direct interface and stepping -- in constrast to BotSim, which is threaded (emulating real time) and has
 //the default ctrl interface via low-level reference messages
 struct Simulation {
@@ -97,6 +109,12 @@ struct Simulation {
   void setState(const arr& frameState, const arr& q=NoArr, const arr& frameVelocities=NoArr, const arr& qDot=NoArr);
   void pushConfigurationToSimulator(const arr& frameVelocities=NoArr, const arr& qDot=NoArr);
 
+  //-- cheap snapshots for branching rollouts: only changed bodies and frames are restored (the spline reference is not part of a snapshot);
+  //   after a getSnapshot or restoreSnapshot, only bodies moved by steps and frames differing between the two snapshots are compared --
+  //   root frames of C edited directly in between are not restored, unless the state is pushed with setState or pushConfigurationToSimulator
+  shared_ptr<const SimulationSnapshot> getSnapshot();
+  uint restoreSnapshot(const SimulationSnapshot& snap); ///< returns the number of restored bodies and frames
+
   //-- post-hoc world manipulations
   void registerNewObjectWithEngine(rai::Frame* f);
 
@@ -112,6 +130,42 @@ struct Simulation {
 
 //===========================================================================
 
+struct SimulationBatch_Options {
+  RAI_PARAM("SimulationBatch/", int, threads, 0) //0: all cores
+  RAI_PARAM("SimulationBatch/", int, verbose, 0) //verbose of each Simulation; >1 opens a display per world
+  RAI_PARAM("SimulationBatch/", bool, parallelPhysx, false) //step PhysX worlds concurrently (own scenes, but one shared PxPhysics) -- not known to be safe
+};
+
+/** N independent simulations (each with its own engine instance) of copies of one template configuration.
+ *  Controls and states of all worlds are passed as contiguous arrays with one row per world; output buffers that already have
+ *  the right size are filled in place.
+ *  Only worlds of the bullet and kinematic engines are stepped in parallel. PhysX worlds are serialized by PhysX_mutex(), so a
+ *  PhysX batch is no faster than stepping its worlds in turn; opt.parallelPhysx drops the lock (which testBatch compares against
+ *  the serialized results). */
+struct SimulationBatch {
+  SimulationBatch_Options opt;
+  Array<shared_ptr<Configuration>> worlds;
+  Array<shared_ptr<Simulation>> sims;
+
+  SimulationBatch(const Configuration& C, uint n, Simulation::Engine engine=Simulation::_physx);
+
+  uint size() const { return sims.N; }
+  Simulation& operator()(uint w) { return *sims(w); }
+
+  /// step all worlds; U is empty or (N x control dim), with the control of world w in row w
+  void step(const arr& U= {}, double tau=.01, Simulation::ControlMode u_mode=Simulation::_spline);
+
+  /// X: (N x frames x 7), Q and QDot: (N x joint dim), V: (N x frames x 2 x 3) -- same layouts as Simulation::getState, per row;
+  /// with the bullet engine, QDot is the commanded joint velocity (BulletInterface has no motor state readout)
+  void getState(arr& X, arr& Q=NoArr, arr& V=NoArr, arr& QDot=NoArr);
+  void setState(const arr& X, const arr& Q=NoArr, const arr& V=NoArr, const arr& QDot=NoArr);
+
+ private:
+  Mutex::Token lockEngine(Simulation& S); ///< locks PhysX_mutex() for a PhysX world, unless opt.parallelPhysx
+};
+
+//===========================================================================
+
 struct TeleopCallbacks : OpenGL::GLClickCall, OpenGL::GLKeyCall, OpenGL::GLHoverCall {
   arr q_ref;
   bool stop=false;
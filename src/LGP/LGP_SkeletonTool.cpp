@@ -20,6 +20,7 @@ LGP_SkeletonTool::LGP_SkeletonTool(rai::Configuration& C, const char* lgpFile) {
   Graph lgpConfig(lgpFile);
 
   params()->copy(lgpConfig, true);
+  parametersChanged();
   //cout <<"=== ALL PARAMS ===\n" <<params() <<endl;
 
   /*
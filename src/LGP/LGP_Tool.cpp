@@ -6,6 +6,10 @@
 #include "../Kin/frame.h"
 #include "../Kin/feature.h"
 #include "../Optim/NLP_Sampler.h"
+#include "../Core/thread.h"
+#include "../Core/profiler.h"
+
+#include <queue>
 
 namespace rai{
 
@@ -28,27 +32,43 @@ ActionNode::~ActionNode(){
 }
 
 PTR<KOMO>& ActionNode::get_ways(Configuration& C, Actions2KOMO_Translator& trans, const StringA& explicitCollisions){
-  if(!ways){
-    ActionNodeL path = getTreePath();
-    //      str planString;
-    //      for(ActionNode *a: path){ planString <<"[ "; for(str& s:a->action) planString <<' ' <<s; planString <<']'; }
-    //      LOG(0) <<"planString: " <<planString;q
-
-    ways = trans.setup_sequence(C, path.N-1);
-
-    double t = 0.;
-    for(ActionNode *a: path){
-      trans.add_action_constraints(ways, t, a->action);
-      t+=1.;
+  if(ways) return ways;
+
+  //-- extend the parent's ways by one phase (inheriting its objectives, switches and joint state) and add only this action;
+  //   only if the parent's ways exist already (ancestors are not built just for this), and not with force exchange dofs, which new slices don't copy
+  if(parent && parent->parent && parent->ways){
+    PTR<KOMO>& parentWays = parent->ways;
+    if(!parentWays->hasForceExchanges()) ways = trans.extend_sequence(parentWays, double(parent->step), parent->action);
+    if(ways){
+      trans.add_action_constraints(ways, double(step), action);
+      return ways;
     }
+  }
 
+  ways = create_ways(C, trans, explicitCollisions);
+  return ways;
+}
 
-    for(uint i=0; i<explicitCollisions.N; i+=2) {
-      ways->addObjective({}, FS_distance, {explicitCollisions.elem(i), explicitCollisions.elem(i+1)}, OT_ineq, {1e1});
-    }
+PTR<KOMO> ActionNode::create_ways(Configuration& C, Actions2KOMO_Translator& trans, const StringA& explicitCollisions) const {
+  ActionNodeL path = getTreePath();
+  //      str planString;
+  //      for(ActionNode *a: path){ planString <<"[ "; for(str& s:a->action) planString <<' ' <<s; planString <<']'; }
+  //      LOG(0) <<"planString: " <<planString;q
+
+  PTR<KOMO> komo = trans.setup_sequence(C, path.N-1);
+
+  double t = 0.;
+  for(ActionNode *a: path){
+    trans.add_action_constraints(komo, t, a->action);
+    t+=1.;
   }
 
-  return ways;
+
+  for(uint i=0; i<explicitCollisions.N; i+=2) {
+    komo->addObjective({}, FS_distance, {explicitCollisions.elem(i), explicitCollisions.elem(i+1)}, OT_ineq, {1e1});
+  }
+
+  return komo;
 }
 
 Array<PTR<KOMO_Motif>>& ActionNode::getWayMotifs(){
@@ -172,15 +192,52 @@ str Job::niceMsg(){
 
 //===========================================================================
 
+//-- descriptions for the result cache keys
+
+static void appendFrame(str& description, Frame* f, double res){
+  description <<' ' <<f->name;
+  if(f->parent) description <<'<' <<f->parent->name;
+  ResultCache::appendPose(description, f->ensure_X(), res);
+  if(f->joint){
+    description <<" J" <<f->joint->type;
+    ResultCache::appendArray(description, f->joint->limits, res);
+  }
+  if(f->shape){
+    description <<" S" <<f->shape->type() <<'c' <<int(f->shape->cont);
+    ResultCache::appendArray(description, f->shape->size, res);
+    if(f->shape->_mesh) ResultCache::appendArray(description, f->shape->_mesh->V, res);
+  }
+}
+
+static void appendObjective(str& description, const Configuration& C, GroundedObjective* ob, double res){
+  description <<' ' <<ob->feat->shortTag(C) <<' ' <<ob->type <<ob->feat->order <<ob->timeSlices;
+  ResultCache::appendArray(description, ob->feat->scale, res);
+  ResultCache::appendArray(description, ob->feat->target, res);
+}
+
+//===========================================================================
+
 LGP_Tool::LGP_Tool(Configuration& _C, TAMP_Provider& _tamp, Actions2KOMO_Translator& _trans)
   : C(_C), tamp(_tamp), trans(_trans) {
   actionTreeRoot = new ActionNode(0, {});
 
   newPlanJob = make_shared<Job>(-1.5, actionTreeRoot, nullptr, _new_plan);
   jobs.append(newPlanJob.get());
+
+  //-- the scene enters the cache keys of all problems
+  for(Frame* f:C.frames) appendFrame(sceneDescription, f, cache.opt.poseResolution);
+  StringA explicitCollisions = tamp.explicitCollisions();
+  for(str& s:explicitCollisions) sceneDescription <<" coll:" <<s;
+  if(cache.load() && verbose>0) cache.report(cout);
 }
 
 LGP_Tool::~LGP_Tool(){
+  try{
+    cache.save();
+  }catch(std::runtime_error& err){
+    cout <<"SAVING THE RESULT CACHE FAILED: " <<err.what() <<endl;
+  }
+  if(verbose>0) cache.report(cout);
   view_close();
   delete actionTreeRoot;
 }
@@ -193,6 +250,7 @@ ActionNode* LGP_Tool::addNewOpenPlan(){
 }
 
 void LGP_Tool::solve_step(){
+  RAI_PROFILE("LGP_Tool::solve_step");
   step_count++;
 
   /*
@@ -211,25 +269,7 @@ void LGP_Tool::solve_step(){
    *   marginal prob of being feasible.
    */
 
-  for(Job *j:jobs) j->update();
-
-//  std::sort(jobs.p, jobs.p+jobs.N, Job::compare_priority);
-  std::sort(open_terminal_nodes.p, open_terminal_nodes.p+open_terminal_nodes.N, [](const ActionNode* a, const ActionNode* b){ return a->ways_job->succProb<b->ways_job->succProb; });
-
-  if(verbose>1){
-    cout <<"+++ JOB QUEUE:" <<endl;
-    for(uint i=0;i<jobs.N;i++){
-      cout <<"  " <<i <<' ' <<*jobs(i) <<endl;
-    }
-    cout <<"+++ OPEN TERMINALS:" <<endl;
-    for(ActionNode *t:open_terminal_nodes){
-      cout <<"  " <<' ' <<t->ways_job->getSuccProb() <<' ' <<*t->ways_job <<endl;
-    }
-    cout <<"+++ SOLUTIONS:" <<endl;
-    for(ActionNode *s:solutions){
-      cout <<"  " <<*s->ways_job <<endl;
-    }
-  }
+  update_jobs();
 
 //  wait();
 
@@ -241,47 +281,7 @@ void LGP_Tool::solve_step(){
   for(Job* d: job->dependencies) if(!d->n_succ){ job=d; break; }
 
   if(job->tag==_new_plan){
-    ActionNode *new_terminal = addNewOpenPlan();
-    open_terminal_nodes.append(new_terminal);
-
-    //add the _solve_ways job for the full path (if not yet exists)
-    ActionNodeL path = new_terminal->getTreePath();
-    Array<Job*> pathJobs;
-//    for(ActionNode *a:path) if(a->parent){
-    for(ActionNode *a:path) if(a->isTerminal){ //OPTION! create sub_way_problems? or only motifs?
-      if(a->ways_job){ //job exists
-        pathJobs.append(a->ways_job.get());
-      }else{ //job needs to be created
-        a->ways_job = make_shared<Job>(0., a, nullptr, _solve_ways);
-        a->ways_job->dependencies = pathJobs;
-
-        if(verbose>2) cout <<"+++ addin job" <<*job <<endl;
-        jobs.append(a->ways_job.get());
-        pathJobs.append(a->ways_job.get());
-#if 1
-//        PTR<KOMO>& ways =
-        a->get_ways(C, trans, tamp.explicitCollisions());
-        Array<PTR<KOMO_Motif>>& ways_motifs= a->getWayMotifs();
-        for(PTR<KOMO_Motif>& motif:ways_motifs){
-          std::string hash = motif->getHash().p;
-          if(verbose>2) cout <<"  -- checking hash '" <<hash <<"'" <<endl;
-          Job* motif_job = motifResults[hash];
-          if(!motif_job){
-            if(verbose>2) cout <<"  -- novel! adding new motif job" <<endl;
-            auto job = make_shared<Job>(0., a, motif.get(), _solve_motif);
-            motif_jobs.append(job);
-            jobs.append(job.get());
-            motifResults[hash] = job.get();
-            if(verbose>2) cout <<"+++ addin job" <<*job <<endl;
-            motif_job = job.get();
-          }else{
-            if(verbose>2) cout <<"  -- found!" <<endl;
-          }
-          a->ways_job->dependencies.prepend(motif_job);
-        }
-#endif
-      }
-    }
+    expand_newPlan();
   }
   else if(job->tag == _solve_ways){
 
@@ -319,10 +319,13 @@ void LGP_Tool::solve_step(){
 
     //  ways->view(true, STRING("ways init" <<sub->action));
     ways->opt.verbose=0;
+    std::shared_ptr<SolverReturn> ret = lookup_cache(job);
+    if(ret){
+      if(verbose>0) cout <<"++ cached" <<endl;
+    }else{
 #if 1
-    auto ret = ways->solve();
+    ret = ways->solve();
 #else
-    std::shared_ptr<SolverReturn> ret;
     str opt_or_sample="gauss";
     if(opt_or_sample=="opt"){
       NLP_Solver sol;
@@ -337,23 +340,9 @@ void LGP_Tool::solve_step(){
       ret = sol.sample();
     }
 #endif
-
-    job->rets.append(ret);
-    if(ret->feasible){
-      job->n_succ++;
-      job->priority = -100.;
     }
-    if(!ret->feasible){
-      job->n_fail++;
-      job->priority -= 1.;
-    }
-
-    if(verbose>0) cout <<"++ jobs stats: " <<*job <<endl;
 
-    if(sub->isTerminal && ret->feasible){
-      solutions.append(sub);  //we have a feasible plan
-      open_terminal_nodes.removeValue(job->a);
-    }
+    record_result(job, ret);
 
     //pause debug
 //    ways->view(false, STRING("ways solution " <<sub->action <<"\n" <<*ret));
@@ -369,29 +358,232 @@ void LGP_Tool::solve_step(){
     if(verbose>0) cout <<"+++ solving motif " <<job->niceMsg() <<endl;
 
     PTR<KOMO>& ways_komo = motif_origin->get_ways(C, trans, tamp.explicitCollisions());
-    auto ret = motif->solve(*ways_komo, "gauss", verbose-2);
+    auto ret = lookup_cache(job);
+    if(ret){
+      if(verbose>0) cout <<"++ cached" <<endl;
+    }else{
+      ret = motif->solve(*ways_komo, "gauss", verbose-2);
+    }
+
+    record_result(job, ret);
+
+    if(verbose>1) display(ways_komo, ret, false, job->niceMsg());
+  }
+}
+
+void LGP_Tool::update_jobs(){
+  for(Job *j:jobs) j->update();
 
-    job->rets.append(ret);
-    if(ret->feasible){
-      job->n_succ++;
-      job->priority = -100.;
+//  std::sort(jobs.p, jobs.p+jobs.N, Job::compare_priority);
+  std::sort(open_terminal_nodes.p, open_terminal_nodes.p+open_terminal_nodes.N, [](const ActionNode* a, const ActionNode* b){ return a->ways_job->succProb<b->ways_job->succProb; });
+
+  if(verbose>1){
+    cout <<"+++ JOB QUEUE:" <<endl;
+    for(uint i=0;i<jobs.N;i++){
+      cout <<"  " <<i <<' ' <<*jobs(i) <<endl;
     }
-    if(!ret->feasible){
-      job->n_fail++;
-      job->priority -= 1.;
+    cout <<"+++ OPEN TERMINALS:" <<endl;
+    for(ActionNode *t:open_terminal_nodes){
+      cout <<"  " <<' ' <<t->ways_job->getSuccProb() <<' ' <<*t->ways_job <<endl;
+    }
+    cout <<"+++ SOLUTIONS:" <<endl;
+    for(ActionNode *s:solutions){
+      cout <<"  " <<*s->ways_job <<endl;
     }
+  }
+}
 
-    if(verbose>0) cout <<"++ jobs stats: " <<*job <<endl;
-    if(verbose>1) display(ways_komo, ret, false, job->niceMsg());
+void LGP_Tool::expand_newPlan(){
+  ActionNode *new_terminal = addNewOpenPlan();
+  open_terminal_nodes.append(new_terminal);
+
+  //add the _solve_ways job for the full path (if not yet exists)
+  ActionNodeL path = new_terminal->getTreePath();
+  Array<Job*> pathJobs;
+//    for(ActionNode *a:path) if(a->parent){
+  for(ActionNode *a:path) if(a->isTerminal){ //OPTION! create sub_way_problems? or only motifs?
+    if(a->ways_job){ //job exists
+      pathJobs.append(a->ways_job.get());
+    }else{ //job needs to be created
+      a->ways_job = make_shared<Job>(0., a, nullptr, _solve_ways);
+      a->ways_job->dependencies = pathJobs;
+
+      if(verbose>2) cout <<"+++ addin job" <<*a->ways_job <<endl;
+      jobs.append(a->ways_job.get());
+      pathJobs.append(a->ways_job.get());
+#if 1
+      PTR<KOMO>& ways = a->get_ways(C, trans, tamp.explicitCollisions());
+      //the key includes the objectives (as the translator set them up), not only the plan
+      str waysDescription = STRING("ways " <<a->getPlanString() <<sceneDescription);
+      for(auto& ob:ways->objs) appendObjective(waysDescription, ways->pathConfig, ob.get(), cache.opt.poseResolution);
+      a->ways_job->cacheKey = ResultCache::key(waysDescription);
+      Array<PTR<KOMO_Motif>>& ways_motifs= a->getWayMotifs();
+      for(PTR<KOMO_Motif>& motif:ways_motifs){
+        std::string hash = motif->getHash().p;
+        if(verbose>2) cout <<"  -- checking hash '" <<hash <<"'" <<endl;
+        Job* motif_job = motifResults[hash];
+        if(!motif_job){
+          if(verbose>2) cout <<"  -- novel! adding new motif job" <<endl;
+          auto job = make_shared<Job>(0., a, motif.get(), _solve_motif);
+          str description = STRING("motif " <<hash);
+          for(Frame* f:motif->F){ description <<' ' <<f->name; ResultCache::appendPose(description, f->ensure_X(), cache.opt.poseResolution); }
+          for(GroundedObjective* ob:motif->objs) appendObjective(description, ways->pathConfig, ob, cache.opt.poseResolution);
+          description <<sceneDescription; //other objects may enter collision objectives
+          job->cacheKey = ResultCache::key(description);
+          motif_jobs.append(job);
+          jobs.append(job.get());
+          motifResults[hash] = job.get();
+          if(verbose>2) cout <<"+++ addin job" <<*job <<endl;
+          motif_job = job.get();
+        }else{
+          if(verbose>2) cout <<"  -- found!" <<endl;
+        }
+        a->ways_job->dependencies.prepend(motif_job);
+      }
+#endif
+    }
   }
 }
 
+void LGP_Tool::record_result(Job* job, const PTR<SolverReturn>& ret){
+  job->rets.append(ret);
+  if(ret->feasible && job->cacheKey.size()) cache.put(job->cacheKey, ret);
+  if(ret->feasible){
+    job->n_succ++;
+    job->priority = -100.;
+  }
+  if(!ret->feasible){
+    job->n_fail++;
+    job->priority -= 1.;
+  }
+
+  if(verbose>0) cout <<"++ jobs stats: " <<*job <<endl;
+
+  if(job->tag==_solve_ways && job->a->isTerminal && ret->feasible){
+    solutions.append(job->a);  //we have a feasible plan
+    open_terminal_nodes.removeValue(job->a);
+  }
+}
+
+PTR<SolverReturn> LGP_Tool::lookup_cache(Job* job){
+  if(!job->cacheKey.size()) return PTR<SolverReturn>();
+  PTR<SolverReturn> ret = cache.get(job->cacheKey);
+  if(!ret) return ret;
+  //-- verify the hit with one evaluation on the actual problem; this also sets the cached solution, as solving it would
+  PTR<KOMO>& ways = job->a->ways;
+  arr q = ways->pathConfig.getJointState();
+  bool feasible;
+  if(job->tag==_solve_ways){
+    feasible = ResultCache::verify(*ways->nlp(), ret->x);
+    if(feasible){ ways->x = ret->x;  ways->dual = ret->dual; }
+  }else{
+    feasible = job->motif->verify(*ways, ret->x);
+  }
+  if(!feasible){
+    if(verbose>0) cout <<"++ cached result rejected: " <<job->niceMsg() <<endl;
+    ways->pathConfig.setJointState(q);
+    cache.erase(job->cacheKey);
+    return PTR<SolverReturn>();
+  }
+  return ret;
+}
+
+void LGP_Tool::solve_step_parallel(){
+  step_count++;
+
+  update_jobs();
+
+  //-- new plans are expanded in this thread, if there is no promising open plan
+  if(!open_terminal_nodes.N || open_terminal_nodes.elem(-1)->ways_job->succProb<.5) expand_newPlan();
+
+  //-- priority queue of all ready jobs: not yet solved and all dependencies solved (ties by job ID)
+  auto lower = [](const Job* a, const Job* b){ return a->priority<b->priority || (a->priority==b->priority && a->ID>b->ID); };
+  std::priority_queue<Job*, std::vector<Job*>, decltype(lower)> queue(lower);
+  for(Job* j:jobs) if(j->tag!=_new_plan && !j->n_succ){
+    bool ready=true;
+    for(Job* d:j->dependencies) if(!d->n_succ){ ready=false; break; }
+    if(ready) queue.push(j);
+  }
+
+  //-- cached jobs are completed right away; the best others form the batch
+  Array<Job*> batch;
+  while(batch.N<(uint)threads && !queue.empty()){
+    Job* job = queue.top();
+    queue.pop();
+    PTR<SolverReturn> ret = lookup_cache(job);
+    if(ret) record_result(job, ret);
+    else batch.append(job);
+  }
+  if(!batch.N) return;
+
+  //-- motifs are solved on clones of their origin's ways as of now (the same construction and state as in the serial solve);
+  //   cloned here, as workers must not read the origin's ways while a merge or another job may touch it
+  Array<PTR<KOMO>> komos(batch.N);
+  for(uint i=0;i<batch.N;i++) if(batch(i)->tag==_solve_motif){
+    KOMO& origin = *batch(i)->a->ways;
+    komos(i) = make_shared<KOMO>();
+    komos(i)->clone(origin); //with own features: their memos and caches are not shared across threads
+    komos(i)->fcl.reset(); //and an own collision engine (built on first use), as FclInterface::step is not thread-safe
+    komos(i)->world.coll_fclReset();
+    CHECK(komos(i)->pathConfig.getJointNames()==origin.pathConfig.getJointNames(), "the clone of the ways differs in its joints from its origin");
+    CHECK_ZERO(maxDiff(komos(i)->pathConfig.getJointState(), origin.pathConfig.getJointState()), 0., "the clone of the ways differs in its state from its origin");
+  }
+
+  //-- solve the batch concurrently
+  if(!pool) pool = make_shared<ThreadPool>(threads);
+  Array<PTR<SolverReturn>> rets(batch.N);
+  for(uint i=0;i<batch.N;i++){
+    if(verbose>0) cout <<"+++ solving job " <<*batch(i) <<endl;
+    pool->add([this, &batch, &rets, &komos, i](uint worker){ rets(i) = solve_job(batch(i), komos(i)); });
+  }
+  pool->waitForAll();
+
+  //-- merge results in batch order, independent of which worker finished first
+  for(uint i=0;i<batch.N;i++){
+    Job* job = batch(i);
+    record_result(job, rets(i));
+    if(job->tag==_solve_motif && rets(i)->feasible && rets(i)->x.N){
+      //initialize the origin's ways with the motif solution (as when solving the motif in place)
+      job->motif->initialize(*job->a->ways, rets(i)->x);
+    }
+    if(verbose>1) display(komos(i), rets(i), false, job->niceMsg());
+  }
+}
+
+PTR<SolverReturn> LGP_Tool::solve_job(Job* job, PTR<KOMO>& komo){
+  RAI_PROFILE("LGP_Tool::solve_job");
+  rnd.seed(1000*jobs.findValue(job) + job->rets.N); //results depend neither on the worker nor on other tools (Job::ID is global)
+
+  if(job->tag==_solve_ways){
+    //ways are only touched by their own job
+    komo = job->a->ways;
+    komo->opt.verbose=0;
+    return komo->solve();
+  }
+
+  CHECK_EQ(job->tag, _solve_motif, "");
+  CHECK(komo, "motif jobs are solved on a clone of their origin's ways");
+  //identify the motif in the clone by its slice and frames
+  uintA F = framesToIndices(job->motif->F);
+  F.sort();
+  MotifL motifs = analyzeMotifs(*komo);
+  uint m=0;
+  for(;m<motifs.N;m++){
+    if(motifs(m)->timeSlice!=job->motif->timeSlice) continue;
+    uintA Fm = framesToIndices(motifs(m)->F);
+    if(Fm.sort()==F) break;
+  }
+  CHECK(m<motifs.N, "motif not found in the clone of the ways");
+  return motifs(m)->solve(*komo, "gauss", verbose-2);
+}
+
 void LGP_Tool::solve(int _verbose){
   if(_verbose>=0) verbose=_verbose;
   uint n = solutions.N;
   for(;;){
     if(verbose>0) cout <<"--------------------------------------------------------------------" <<endl;
-    solve_step();
+    if(threads>1) solve_step_parallel();
+    else solve_step();
     if(solutions.N>n){
       if(verbose>0) cout <<"--------------------------------------------------------------------" <<endl;
       if(verbose>0) cout <<"   SOLUTION FOUND:   " <<solutions(-1)->getPlanString() <<endl;
@@ -598,12 +790,7 @@ struct Default_Actions2KOMO_Translator : Actions2KOMO_Translator{
         palm <<"_palm";
       }
 
-      if(time<manip.komo->T/manip.komo->stepsPerPhase){
-        str snapFrame; snapFrame <<"placePose_" <<target <<'_' <<obj <<'_' <<time;
-        manip.komo->addFrameDof(snapFrame, target, JT_free, true, obj); //a permanent free stable target->place joint; and a snap place->object
-        manip.komo->addRigidSwitch(time, {snapFrame, obj});
-        if(manip.komo->stepsPerPhase>2) manip.komo->addObjective({time}, FS_poseDiff, {snapFrame, obj}, OT_eq, {1e0}, NoArr, 0, -1, 0);
-      }
+      if(time<manip.komo->T/manip.komo->stepsPerPhase) add_action_successor_constraints(komo, time, action);
 
       manip.place_box(time, obj, target, palm, "z");
       //gripper center at least inside object
@@ -615,12 +802,7 @@ struct Default_Actions2KOMO_Translator : Actions2KOMO_Translator{
       str& table = action(2);
       str& gripper = action(3);
 
-      if(time<manip.komo->T/manip.komo->stepsPerPhase){
-        str snapFrame; snapFrame <<"pushPose_" <<gripper <<'_' <<obj <<'_' <<time;
-        manip.komo->addFrameDof(snapFrame, gripper, rai::JT_free, true, obj);
-        manip.komo->addRigidSwitch(time, {snapFrame, obj});
-        if(manip.komo->stepsPerPhase>2) manip.komo->addObjective({time}, FS_poseDiff, {snapFrame, obj}, OT_eq, {1e0}, NoArr, 0, -1, 0);
-      }
+      if(time<manip.komo->T/manip.komo->stepsPerPhase) add_action_successor_constraints(komo, time, action);
 
       manip.straight_push({time,time+1}, obj, gripper, table);
 
@@ -630,9 +812,7 @@ struct Default_Actions2KOMO_Translator : Actions2KOMO_Translator{
       //str& floor = action(3);
       str& target = action(4);
 
-      if(time<manip.komo->T/manip.komo->stepsPerPhase){
-        NIY;
-      }
+      if(time<manip.komo->T/manip.komo->stepsPerPhase) add_action_successor_constraints(komo, time, action);
 
       manip.place_box(time, obj, target, 0, "z");
 
@@ -641,6 +821,34 @@ struct Default_Actions2KOMO_Translator : Actions2KOMO_Translator{
     }
   }
 
+  virtual std::shared_ptr<KOMO> extend_sequence(const std::shared_ptr<KOMO>& parent, double prevTime, const StringA& prev_action){
+    auto komo = make_shared<KOMO>();
+    komo->clone(*parent);
+    komo->addPhases(1);
+    if(prev_action.N) add_action_successor_constraints(komo, prevTime, prev_action);
+    return komo;
+  }
+
+  /// the part of the constraints of an action that only exists if it is followed by another (the object snaps to a stable relative pose)
+  void add_action_successor_constraints(std::shared_ptr<KOMO>& komo, double time, const StringA& action){
+    str snapFrame, parent, obj;
+    if(action(0)=="place"){
+      obj = action(1);
+      parent = action(3);
+      snapFrame <<"placePose_" <<parent <<'_' <<obj <<'_' <<time; //a permanent free stable target->place joint; and a snap place->object
+    }else if(action(0)=="gripper_push"){
+      obj = action(1);
+      parent = action(3);
+      snapFrame <<"pushPose_" <<parent <<'_' <<obj <<'_' <<time;
+    }else if(action(0)=="end_push"){
+      NIY;
+    }else return;
+
+    komo->addFrameDof(snapFrame, parent, JT_free, true, obj);
+    komo->addRigidSwitch(time, {snapFrame, obj});
+    if(komo->stepsPerPhase>2) komo->addObjective({time}, FS_poseDiff, {snapFrame, obj}, OT_eq, {1e0}, NoArr, 0, -1, 0);
+  }
+
   virtual void add_action_constraints_motion(std::shared_ptr<KOMO>& komo, double time, const StringA& prev_action, const StringA& action, uint actionPhase){
     if(!action.N) return;
 
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Motif.h"
+#include "ResultCache.h"
 
 #include <LGP/LGP_SkeletonTool.h>
 #include <KOMO/manipTools.h>
 
+struct ThreadPool;
+
 namespace rai {
 
 //===========================================================================
@@ -14,6 +17,10 @@ struct Actions2KOMO_Translator {
   virtual std::shared_ptr<KOMO> setup_sequence(Configuration& C, uint K) = 0;
   virtual void add_action_constraints(std::shared_ptr<KOMO>& komo, double time, const StringA& action) = 0;
   virtual void add_action_constraints_motion(std::shared_ptr<KOMO>& komo, double time, const StringA& prev_action, const StringA& action, uint actionPhase) = 0;
+  /// a copy of the (prepared) parent sequence extended by one phase, for the next action to be added at time prevTime+1;
+  /// prev_action (the parent's last action, at prevTime) may add constraints that only exist for non-final actions;
+  /// nullptr: not supported -- sequences are set up from scratch
+  virtual std::shared_ptr<KOMO> extend_sequence(const std::shared_ptr<KOMO>& parent, double prevTime, const StringA& prev_action) { return nullptr; }
 };
 
 struct TAMP_Provider{
@@ -42,6 +49,7 @@ struct Job{
   KOMO_Motif* motif=0;
   JobTag tag;
   Array<Job*> dependencies;
+  std::string cacheKey; //key of the problem in the ResultCache
 
   //results
   uint n_fail=0, n_succ=0;
@@ -74,7 +82,8 @@ struct ActionNode{
   ActionNode(ActionNode* _parent, StringA _action);
   ~ActionNode();
 
-  PTR<KOMO>& get_ways(Configuration& C, Actions2KOMO_Translator& trans, const StringA& explicitCollisions);
+  PTR<KOMO>& get_ways(Configuration& C, Actions2KOMO_Translator& trans, const StringA& explicitCollisions); //incrementally extends the parent's ways if they exist, the translator supports it, and there are no force exchanges
+  PTR<KOMO> create_ways(Configuration& C, Actions2KOMO_Translator& trans, const StringA& explicitCollisions) const; //a new (not cached) ways problem
   Array<PTR<KOMO_Motif>>& getWayMotifs();
 
 
@@ -101,6 +110,7 @@ struct LGP_Tool{
   TAMP_Provider& tamp;
   Actions2KOMO_Translator& trans;
   int verbose=1;
+  int threads=1; ///< >1: each step solves the best ready (=dependencies solved) jobs concurrently
 
   //internal data structures for action search and job management
   ActionNode* actionTreeRoot;
@@ -111,12 +121,14 @@ struct LGP_Tool{
   Array<ActionNode*> open_terminal_nodes;
   ActionNodeL solutions;
   uint step_count=0;
+  ResultCache cache; //feasible results of motif and ways problems, persistent across runs if cache.opt.file is set
 
   LGP_Tool(const char* lgp_configfile);
   LGP_Tool(Configuration& _C, TAMP_Provider& _tamp, Actions2KOMO_Translator& _trans);
   ~LGP_Tool();
 
   void solve_step();
+  void solve_step_parallel();
 
   void solve(int _verbose=-1);
   StringAA getSolvedPlan();
@@ -136,6 +148,13 @@ struct LGP_Tool{
 private:
   //helpers
   ActionNode *addNewOpenPlan();
+  void update_jobs();
+  void expand_newPlan();
+  void record_result(Job* job, const PTR<SolverReturn>& ret);
+  PTR<SolverReturn> lookup_cache(Job* job);
+  str sceneDescription;
+  PTR<SolverReturn> solve_job(Job* job, PTR<KOMO>& komo); //for motif jobs, komo is a clone of the origin's ways to solve on
+  PTR<ThreadPool> pool;
   PTR<OpenGL> gl;
   PTR<KOMO> gl_komo;
 };
@@ -1,4 +1,5 @@
 #include "Motif.h"
+#include "ResultCache.h"
 
 #include "../KOMO/komo_NLP.h"
 #include "../KOMO/objective.h"
@@ -50,6 +51,26 @@ DofL KOMO_Motif::getDofs(rai::Configuration& C, int verbose){
   return dofs;
 }
 
+void KOMO_Motif::initialize(KOMO& komo, const arr& x){
+  DofL dofs = getDofs(komo.pathConfig, 0);
+  komo.pathConfig.ensure_indexedJoints();
+  DofL orgDofs = komo.pathConfig.activeDofs;
+  komo.pathConfig.selectJoints(dofs);
+  komo.pathConfig.setJointState(x);
+  komo.pathConfig.selectJoints(orgDofs);
+}
+
+bool KOMO_Motif::verify(KOMO& komo, const arr& x){
+  DofL dofs = getDofs(komo.pathConfig, 0);
+  if(!dofs.N) return !x.N;
+
+  komo.pathConfig.ensure_indexedJoints();
+  DofL orgDofs = komo.pathConfig.activeDofs;
+  bool feasible = rai::ResultCache::verify(*make_shared<rai::KOMO_SubNLP>(komo, objs, dofs), x);
+  komo.pathConfig.selectJoints(orgDofs); //undo selectJoint that is done internally by KOMO_SubNLP
+  return feasible;
+}
+
 std::shared_ptr<SolverReturn> KOMO_Motif::solve(KOMO& komo, str opt_or_sample, int verbose){
 #if 0
   //-- selected frames within komo
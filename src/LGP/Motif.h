@@ -14,13 +14,14 @@ struct KOMO_Motif{
 
   DofL getDofs(rai::Configuration& C, int verbose);
 
-//  void initialize(KOMO& komo, const arr& x){
-//    DofL dofs = getDofs(komo.pathConfig);
-//    komo.pathConfig.setDofState(x, dofs);
-//  }
+  /// set the motif's dofs in komo to a solution x (as returned by solve)
+  void initialize(KOMO& komo, const arr& x);
 
   std::shared_ptr<SolverReturn> solve(KOMO& komo, str opt_or_sample, int verbose);
 
+  /// whether a solution x (e.g. from a cache) is feasible for the motif in komo -- one evaluation, which also sets x in komo
+  bool verify(KOMO& komo, const arr& x);
+
 };
 
 typedef rai::Array<std::shared_ptr<KOMO_Motif>> MotifL;
@@ -0,0 +1,137 @@
+#include "ResultCache.h"
+
+#include <math.h>
+#include <string.h>
+#include <fstream>
+
+namespace rai {
+
+//===========================================================================
+
+shared_ptr<SolverReturn> ResultCache::get(const std::string& key) {
+  auto it = entries.find(key);
+  if(it==entries.end()) { misses++; return shared_ptr<SolverReturn>(); }
+  hits++;
+  it->second.lastUse = ++useCount;
+  return it->second.ret;
+}
+
+void ResultCache::put(const std::string& key, const shared_ptr<SolverReturn>& ret) {
+  Entry& e = entries[key];
+  e.ret = ret;
+  e.lastUse = ++useCount;
+  if(entries.size()>(uint)opt.maxEntries) evict();
+}
+
+void ResultCache::erase(const std::string& key) {
+  if(entries.erase(key)) rejected++;
+}
+
+void ResultCache::evict() {
+  //-- drop the least recently used entries, down to 90% of maxEntries
+  uint n = entries.size() - (uint)(.9*opt.maxEntries);
+  std::vector<uint64_t> uses;
+  for(auto& e:entries) uses.push_back(e.second.lastUse);
+  std::nth_element(uses.begin(), uses.begin()+n-1, uses.end());
+  uint64_t threshold = uses[n-1];
+  for(auto it=entries.begin(); it!=entries.end();) {
+    if(it->second.lastUse<=threshold) { it = entries.erase(it); evictions++; }
+    else ++it;
+  }
+}
+
+bool ResultCache::load(const char* file) {
+  if(!file) file = opt.file;
+  if(!file || !file[0] || !FileToken(file).exists()) return false;
+  std::ifstream fil(file, std::ios::binary);
+  uint n;
+  parse(fil, "ResultCache");
+  fil >>n;
+  for(uint i=0; i<n; i++) {
+    std::string key;
+    auto ret = make_shared<SolverReturn>();
+    uint64_t lastUse;
+    fil >>key >>lastUse >>ret->evals >>ret->time >>ret->feasible >>ret->done >>ret->sos >>ret->f >>ret->ineq >>ret->eq;
+    parse(fil, "x");
+    ret->x.readJson(fil);
+    parse(fil, "dual");
+    ret->dual.readJson(fil);
+    CHECK(fil.good(), "failed reading cache entry " <<i <<" from '" <<file <<"'");
+    Entry& e = entries[key];
+    e.ret = ret;
+    e.lastUse = lastUse;
+    if(lastUse>useCount) useCount=lastUse;
+  }
+  return true;
+}
+
+void ResultCache::save(const char* file) {
+  if(!file) file = opt.file;
+  if(!file || !file[0]) return;
+  //write to a temporary file and rename, so that an interrupted process doesn't leave a broken cache
+  rai::String tmpFile = STRING(file <<".tmp");
+  {
+    std::ofstream fil(tmpFile.p, std::ios::binary);
+    fil.precision(17);
+    fil <<"ResultCache " <<entries.size() <<'\n';
+    for(auto& e:entries) {
+      const SolverReturn& r = *e.second.ret;
+      fil <<e.first <<' ' <<e.second.lastUse <<' ' <<r.evals <<' ' <<r.time <<' ' <<r.feasible <<' ' <<r.done
+          <<' ' <<r.sos <<' ' <<r.f <<' ' <<r.ineq <<' ' <<r.eq <<'\n';
+      fil <<"x ";
+      r.x.writeJson(fil);
+      fil <<"\ndual ";
+      r.dual.writeJson(fil);
+      fil <<'\n';
+    }
+  }
+  int err = std::rename(tmpFile.p, file);
+  CHECK(!err, "could not rename '" <<tmpFile <<"' to '" <<file <<"'");
+}
+
+void ResultCache::report(std::ostream& os) const {
+  os <<"ResultCache: entries: " <<entries.size() <<" hits: " <<hits <<" misses: " <<misses
+     <<" hit rate: " <<hitRate() <<" rejected: " <<rejected <<" evictions: " <<evictions <<endl;
+}
+
+static void fnv1a(uint64_t& h, const char* data, uint64_t n) {
+  for(uint64_t i=0; i<n; i++) { h ^= (unsigned char)data[i]; h *= 0x100000001b3ull; }
+}
+
+std::string ResultCache::key(const char* description) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  fnv1a(h, description, strlen(description));
+  char buf[17];
+  snprintf(buf, 17, "%016llx", (unsigned long long)h);
+  return buf;
+}
+
+void ResultCache::appendPose(rai::String& description, const rai::Transformation& X, double res) {
+  rai::Quaternion q = X.rot;
+  if(q.w<0.) q.flipSign(); //canonical sign
+  description <<'(';
+  for(double x: {X.pos.x, X.pos.y, X.pos.z, q.w, q.x, q.y, q.z}) description <<' ' <<(long)::round(x/res);
+  description <<')';
+}
+
+void ResultCache::appendArray(rai::String& description, const arr& x, double res) {
+  description <<'[' <<x.dim();
+  if(x.N<=16) {
+    for(double xi:x) description <<' ' <<(long)::round(xi/res);
+  } else {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for(double xi:x) { long q = ::round(xi/res); fnv1a(h, (const char*)&q, sizeof(q)); }
+    description <<" #" <<std::hex <<h <<std::dec;
+  }
+  description <<']';
+}
+
+bool ResultCache::verify(NLP& nlp, const arr& x) {
+  if(x.N!=nlp.dimension) return false;
+  arr phi;
+  nlp.evaluate(phi, NoArr, x);
+  arr err = nlp.summarizeErrors(phi);
+  return err(OT_ineq)<.1 && err(OT_eq)<.1;
+}
+
+} //namespace
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Core/util.h"
+#include "../Optim/NLP.h"
+#include "../Geo/geo.h"
+
+#include <map>
+
+namespace rai {
+
+//===========================================================================
+
+struct ResultCache_Options {
+  RAI_PARAM("LGP/cache/", rai::String, file, "") //persistent cache file; empty: cache only in memory
+  RAI_PARAM("LGP/cache/", int, maxEntries, 10000)
+  RAI_PARAM("LGP/cache/", double, poseResolution, 1e-3) //quantization of frame poses in the keys
+};
+
+/** A cache of solver results (including x and duals, e.g. for warm starting), keyed by a canonical problem description
+ *  (see key()). It is loaded from and saved to opt.file, so that results persist across processes. When more than
+ *  opt.maxEntries are stored, the least recently used entries are evicted. A description can't capture everything
+ *  that defines a problem: users should verify() a hit on the actual problem and erase() it if it fails. Not thread
+ *  safe. */
+struct ResultCache {
+  ResultCache_Options opt;
+
+  struct Entry {
+    shared_ptr<SolverReturn> ret;
+    uint64_t lastUse=0;
+  };
+  std::map<std::string, Entry> entries;
+  uint64_t useCount=0;
+  uint hits=0, misses=0, evictions=0, rejected=0;
+
+  ResultCache() {}
+
+  /// the cached result, or nullptr
+  shared_ptr<SolverReturn> get(const std::string& key);
+  void put(const std::string& key, const shared_ptr<SolverReturn>& ret);
+  void erase(const std::string& key); ///< drops a hit that failed verification (counted in rejected)
+
+  bool load(const char* file=0); ///< default: opt.file; returns false if there is no such file
+  void save(const char* file=0);
+
+  double hitRate() const { return (hits+misses)?double(hits)/double(hits+misses):0.; }
+  void report(std::ostream& os) const;
+
+  /// a fixed-length key for a problem description (FNV-1a hash, stable across processes and platforms)
+  static std::string key(const char* description);
+  /// append a pose to a problem description, quantized with resolution res
+  static void appendPose(rai::String& description, const rai::Transformation& X, double res);
+  /// append an array (e.g. sizes, limits, mesh vertices), quantized with resolution res; large arrays as a hash
+  static void appendArray(rai::String& description, const arr& x, double res);
+  /// re-evaluate a cached solution x on the actual problem: feasible by the solvers' criterion (eq and ineq < .1)
+  static bool verify(NLP& nlp, const arr& x);
+
+ private:
+  void evict();
+};
+
+} //namespace
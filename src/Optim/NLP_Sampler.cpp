@@ -9,6 +9,7 @@
 #include "NLP_Sampler.h"
 
 #include <Core/util.h>
+#include <Core/thread.h>
 #include <math.h>
 #include <Algo/ann.h>
 
@@ -181,20 +182,9 @@ bool NLP_Sampler::step_GaussNewton(bool slackMode, double penaltyMu, double alph
   //compute delta
   arr delta;
   if(slackMode){
-#if 0
-    arr Hinv = lapack_inverseSymPosDef(((2.*penaltyMu)*~ev.Js)*ev.Js+lambda*eye(x.N));
-    delta = (-2.*penaltyMu) * Hinv * (~ev.Js) * ev.s;
-#else
-    arr R = comp_At_A(ev.Js);
-    R *= 2.*penaltyMu;
-    for(uint i=0;i<R.d1;i++) R.elem(i,i) += lambda;
-    arr g = comp_At_x(ev.Js, ev.s);
-    g *= -2.*penaltyMu;
-    delta = lapack_Ainv_b_sym(R, g);
-#endif
+    delta = get_slackStep(penaltyMu, lambda);
   }else{
-    arr Hinv = lapack_inverseSymPosDef(((2.*penaltyMu)*~ev.Jr)*ev.Jr+lambda*eye(x.N));
-    delta = (-2.*penaltyMu) * Hinv * (~ev.Jr) * ev.r;
+    delta = get_GaussNewtonStep(ev.Jr, ev.r, penaltyMu, lambda);
   }
 
   //adapt step size
@@ -211,6 +201,28 @@ bool NLP_Sampler::step_GaussNewton(bool slackMode, double penaltyMu, double alph
   return true;
 }
 
+arr NLP_Sampler::get_GaussNewtonStep(const arr& J, const arr& r, double penaltyMu, double lambda) {
+  if(rai::isSpecial(J) || !J.d0 || !rai::useLapack) { //sparse or empty: no in-place solve
+    arr H = comp_At_A(J);
+    H *= 2.*penaltyMu;
+    for(uint i=0;i<H.d1;i++) H.elem(i,i) += lambda;
+    arr b = comp_At_x(J, r);
+    b *= -2.*penaltyMu;
+    return lapack_Ainv_b_sym(H, b);
+  }
+  blas_At_A(R, J);
+  R *= 2.*penaltyMu;
+  for(uint i=0;i<R.d1;i++) R(i,i) += lambda;
+  g.resize(J.d1).setZero(); //g = -2 mu J^T r, accumulated row by row
+  for(uint i=0;i<J.d0;i++) {
+    double c = -2.*penaltyMu*r.p[i];
+    const double* Ji = J.p+i*J.d1;
+    for(uint j=0;j<J.d1;j++) g.p[j] += c*Ji[j];
+  }
+  lapack_Ainv_b_symPosDef_inPlace(R, g);
+  return g;
+}
+
 void NLP_Sampler::step_PlainGrad(bool slackMode, double penaltyMu, double alpha, double stepMax) {
   ensure_eval();
   store_eval();
@@ -218,10 +230,11 @@ void NLP_Sampler::step_PlainGrad(bool slackMode, double penaltyMu, double alpha,
   //compute delta
   arr delta;
   if(slackMode){
-    delta = (-2.*penaltyMu) * (~ev.Js) * ev.s;
+    delta = comp_At_x(ev.Js, ev.s);
   }else{
-    delta = (-2.*penaltyMu) * (~ev.Jr) * ev.r;
+    delta = comp_At_x(ev.Jr, ev.r);
   }
+  delta *= -2.*penaltyMu;
 
   //adapt step size
   if(alpha<0.) alpha = opt.slackStepAlpha;
@@ -508,6 +521,32 @@ std::shared_ptr<SolverReturn> NLP_Sampler::sample(){
   return ret;
 }
 
+void NLP_Sampler_runChains(const std::function<shared_ptr<NLP>()>& nlpFactory, const NLP_Sampler_Options& opt,
+                           uint chains, uint samplesPerChain,
+                           const std::function<void(uint chain, const arr& x, uint evals)>& output,
+                           uint nThreads, uint32_t seed) {
+  Mutex outputMutex;
+  rai::Rnd callerRnd = rnd; //the serial path runs on the caller's thread: restore its thread_local rnd afterwards
+  parallelFor(chains, [&](uint chain, uint) {
+    rnd.seed(seed+chain); //thread_local rnd: the chain's random stream is independent of scheduling
+
+    NLP_Sampler sampler(nlpFactory());
+    sampler.setOptions(opt);
+
+    arr data;
+    uintA dataEvals;
+    for(uint k=0; data.d0<samplesPerChain && k<10*samplesPerChain; k++) {
+      uint n=data.d0;
+      sampler.run(data, dataEvals);
+      if(data.d0>n) {
+        auto lock = outputMutex(RAI_HERE);
+        for(uint i=n; i<data.d0 && i<samplesPerChain; i++) output(chain, data[i], dataEvals(i));
+      }
+    }
+  }, nThreads);
+  rnd = callerRnd;
+}
+
 void NLP_Sampler::init_novelty(const arr& data, uint D){
   struct Seed{ NLP_Sampler::Eval ev; arr delta; double align=-1.; };
   rai::Array<Seed> seeds(D);
@@ -107,13 +107,11 @@ private:
   void init_novelty(const arr& data, uint D);
   void init_distance(const arr& data, uint D);
 
-  //--
-  arr compute_slackStep(){
-    ensure_eval();
-    arr Hinv = lapack_inverseSymPosDef(((2.*opt.penaltyMu)*~ev.Js)*ev.Js+opt.slackRegLambda*eye(x.N));
-    arr delta = (-2.*opt.penaltyMu) * Hinv * (~ev.Js) * ev.s;
-    return delta;
-  }
+  //-- Gauss-Newton steps; the (dense) system is solved in place in R and g, which are reused between steps
+  arr R, g;
+  arr get_GaussNewtonStep(const arr& J, const arr& r, double penaltyMu, double lambda);
+  arr get_slackStep(double penaltyMu, double lambda){ return get_GaussNewtonStep(ev.Js, ev.s, penaltyMu, lambda); }
+  arr compute_slackStep(){ ensure_eval(); return get_slackStep(opt.penaltyMu, opt.slackRegLambda); }
 
 public:
   bool run_downhill();
@@ -125,6 +123,15 @@ protected:
   void get_beta_mean(double& beta_mean, double& beta_sdv, const arr& dir, const arr& xbar);
 };
 
+/// runs 'chains' independent NLP_Sampler chains on a thread pool (nThreads=0: all cores) until each has
+/// collected samplesPerChain samples (or failed 10*samplesPerChain downhill runs); each chain owns a problem
+/// from nlpFactory and a rnd seeded with seed+chain, so results per chain are reproducible; every sample is
+/// streamed to output (calls are serialized)
+void NLP_Sampler_runChains(const std::function<shared_ptr<NLP>()>& nlpFactory, const NLP_Sampler_Options& opt,
+                           uint chains, uint samplesPerChain,
+                           const std::function<void(uint chain, const arr& x, uint evals)>& output,
+                           uint nThreads=0, uint32_t seed=0);
+
 //===========================================================================
 
 struct LineSampler {
@@ -17,6 +17,7 @@
 #include "constrained.h"
 #include "utils.h"
 #include "SlackGaussNewton.h"
+#include "../Core/thread.h"
 
 namespace rai {
 
@@ -163,4 +164,10 @@ Graph NLP_Solver::reportLagrangeGradients(const StringA& featureNames) {
   return optCon->L.reportGradients(featureNames);
 }
 
+void solveInParallel(const rai::Array<shared_ptr<NLP_Solver>>& solvers, uint nThreads, int resampleInitialization) {
+  parallelFor(solvers.N, [&solvers, resampleInitialization](uint i, uint) {
+    solvers(i)->solve(resampleInitialization);
+  }, nThreads);
+}
+
 }; //namespace
@@ -53,4 +53,8 @@ struct NLP_Solver : NonCopyable {
   }
 };
 
+/// solves independent problems on a thread pool (nThreads=0: all cores); results are in each solvers(i)->ret
+/// the problems must not share data (e.g., each KOMO owns its own configurations)
+void solveInParallel(const rai::Array<shared_ptr<NLP_Solver>>& solvers, uint nThreads=0, int resampleInitialization=-1);
+
 } //namespace
@@ -208,17 +208,7 @@ double LagrangianProblem::lagrangian(arr& dL, arr& HL, const arr& _x) {
       if(ot==OT_ineqB) coeff.p[i] += (muLB/sqr(phi_x.p[i]));                             //log barrier, check feasibility
       if(ot==OT_eq) coeff.p[i] += hpenalty_dd(phi_x.p[i]);                                    //h-penalty
     }
-    arr tmp = J_x;
-    if(!isSpecial(tmp)) {
-      for(uint i=0; i<phi_x.N; i++) tmp[i] *= sqrt(coeff.p[i]);
-    } else if(isSparseMatrix(tmp)) {
-      arr sqrtCoeff = sqrt(coeff);
-      tmp.sparse().rowWiseMult(sqrtCoeff);
-    } else if(isRowShifted(tmp)) {
-      arr sqrtCoeff = sqrt(coeff);
-      tmp.rowShifted().rowWiseMult(sqrtCoeff);
-    }
-    HL = comp_At_A(tmp); //Gauss-Newton type!
+    HL = comp_At_W_A(J_x, coeff); //Gauss-Newton type!
 
     if(H_x.N) { //For f-terms, the Hessian must be given explicitly, and is not \propto J^T J
       HL += H_x;
@@ -7,6 +7,7 @@
     --------------------------------------------------------------  */
 
 #include "newton.h"
+#include "../Core/profiler.h"
 
 #include <iomanip>
 
@@ -41,13 +42,13 @@ void OptNewton::reinit(const arr& _x) {
 
 //  boundClip(x, bounds_lo, bounds_up);
   boundCheck(x, bounds);
-  timeEval -= rai::cpuTime();
+  rai::ProfileZone zoneEval("Newton evaluation", timeEval);
 #ifdef NewtonLazyLineSearchMode
   fx = f(NoArr, NoArr, x);  evals++;
 #else
   fx = f(gx, Hx, x);  evals++;
 #endif
-  timeEval += rai::cpuTime();
+  zoneEval.end();
 
   //startup verbose
   if(opt.verbose>1) cout <<"----newton---- initial point f(x):" <<fx <<" alpha:" <<alpha <<" beta:" <<beta <<endl;
@@ -57,15 +58,17 @@ void OptNewton::reinit(const arr& _x) {
 //===========================================================================
 
 OptNewton::StopCriterion OptNewton::step() {
+  RAI_PROFILE("OptNewton::step");
   if(!evals) reinit(x);
 
   double fy;
   arr y, gy, Hy, Delta;
 
 #ifdef NewtonLazyLineSearchMode
-  timeEval -= rai::cpuTime();
-  fx = f(gx, Hx, x);  //evals++;
-  timeEval += rai::cpuTime();
+  {
+    rai::ProfileZone zoneEval("Newton evaluation", timeEval);
+    fx = f(gx, Hx, x);  //evals++;
+  }
 #endif
 
   inner_iters++;
@@ -73,7 +76,7 @@ OptNewton::StopCriterion OptNewton::step() {
 
   if(!(fx==fx)) HALT("you're calling a newton step with initial function value = NAN");
 
-  timeNewton -= rai::cpuTime();
+  rai::ProfileZone zone("Newton direction", timeNewton);
 
   //-- check active bounds, and decorrelate Hessian
   arr R=Hx;
@@ -178,7 +181,7 @@ OptNewton::StopCriterion OptNewton::step() {
     return stopCriterion=stopDeltaConverge;
   }
 
-  timeNewton += rai::cpuTime();
+  zone.end();
 
   //-- line search along Delta
   uint lineSearchSteps=0;
@@ -186,25 +189,25 @@ OptNewton::StopCriterion OptNewton::step() {
     if(alpha>1.) alpha=1.;
     if(alphaHiLimit>0. && alpha>alphaHiLimit) alpha=alphaHiLimit;
     if(opt.verbose>1) cout <<"  alpha:" <<std::setw(11) <<alpha <<std::flush;
-    y = x + alpha*Delta;
+    op_scaledSum(y, 1., x, alpha, Delta);
     if(opt.verbose>5) cout <<"  y:" <<y;
     boundClip(y, bounds);
-    timeEval -= rai::cpuTime();
+    rai::ProfileZone zoneEval("Newton evaluation", timeEval);
 #ifdef NewtonLazyLineSearchMode
     fy = f(NoArr, NoArr, y);  evals++;
 #else
     fy = f(gy, Hy, y);  evals++;
 #endif
-    timeEval += rai::cpuTime();
+    zoneEval.end();
     if(opt.verbose>1) cout <<"  evals:" <<std::setw(4) <<evals <<"  f(y):" <<std::setw(11) <<fy <<std::flush;
 
-    bool wolfe = (fy <= fx + opt.wolfe*scalarProduct(y-x, gx));
+    bool wolfe = (fy <= fx + opt.wolfe*scalarProductOfDiff(y, x, gx));
     if(rootFinding) wolfe=true;
     if(fy==fy && wolfe) { //fy==fy is for !NAN
       //== accept new point
       if(opt.verbose>1) cout <<"  ACCEPT" <<endl;
       if(opt.stopFTolerance<0. && fx-fy<opt.stopFTolerance) numTinyFSteps++; else numTinyFSteps=0;
-      if(absMax(y-x)<1e-2*opt.stopTolerance) numTinyXSteps++; else numTinyXSteps=0;
+      if(absMaxDiff(y, x)<1e-2*opt.stopTolerance) numTinyXSteps++; else numTinyXSteps=0;
       x = y;
       fx = fy;
 #ifdef NewtonLazyLineSearchMode
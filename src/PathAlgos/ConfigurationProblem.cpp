@@ -10,6 +10,7 @@
 #include "../Kin/feature.h"
 #include "../Optim/constrained.h"
 #include "../Geo/fclInterface.h"
+#include "../Core/profiler.h"
 
 #include "ConfigurationProblem.h"
 
@@ -40,6 +41,7 @@ void ConfigurationProblem::setExplicitCollisionPairs(const StringA& _collisionPa
 }
 
 shared_ptr<QueryResult> ConfigurationProblem::query(const arr& x) {
+  rai::ProfileZone zone("ConfigurationProblem::query", queryTime);
   // if(limits.N) {
   //   for(uint i=0; i<x.N; i++) {
   //     if(limits(1, i)>limits(0, i) && (x.elem(i)<limits(0, i) || x.elem(i)>limits(1, i))) {
@@ -83,6 +85,7 @@ shared_ptr<QueryResult> ConfigurationProblem::query(const arr& x) {
 
   //display (link of last joint)
   qr->disp3d = C->activeDofs.elem(-1)->frame->getPosition();
+  zone.end();
   if(verbose) {
     C->view(verbose>1, STRING("ConfigurationProblem query:\n" <<*qr));
   }
@@ -90,6 +93,152 @@ shared_ptr<QueryResult> ConfigurationProblem::query(const arr& x) {
   return qr;
 }
 
+//===========================================================================
+
+void ConfigurationProblem::ensureColliders() {
+  if(colliders.N) return;
+  if(!useBroadCollisions) {
+    for(uint i=0; i<collisionPairs.N; i++) colliders.setAppend(C->frames.elem(collisionPairs.elem(i)));
+  } else {
+    colliders = C->getCollidableShapes();
+  }
+  colliderRadius.resize(colliders.N);
+  for(uint i=0; i<colliders.N; i++) {
+    rai::Shape* s = colliders(i)->shape;
+    const arr& V = s->sscCore();
+    double r=0.;
+    for(uint k=0; k<V.d0; k++) r = rai::MAX(r, sumOfSqr(V[k]));
+    colliderRadius(i) = sqrt(r) + s->coll_cvxRadius;
+  }
+  if(!useBroadCollisions) {
+    for(uint i=0; i<collisionPairs.d0; i++) {
+      colliderPairs.append(colliders.findValue(C->frames.elem(collisionPairs(i, 0))));
+      colliderPairs.append(colliders.findValue(C->frames.elem(collisionPairs(i, 1))));
+    }
+  } else {
+    const rai::CollisionMatrix& excludes = *C->coll_filter();
+    for(uint i=0; i<colliders.N; i++) for(uint j=i+1; j<colliders.N; j++) {
+        if(!excludes(colliders(i)->ID, colliders(j)->ID)) colliderPairs.append({i, j});
+      }
+  }
+  colliderPairs.reshape(-1, 2);
+}
+
+/// (colliders x dofs) coefficients: no point of collider i moves more than sum_j coeff(i,j)*|dx_j| when x changes by dx.
+/// Walking up the chain, reach bounds the distance from the current frame's origin to the shape; a rotational dof moves the
+/// shape by at most its angle times the reach, a translational dof by at most its change.
+arr ConfigurationProblem::getMotionCoeffs(const arr& x) {
+  C->setJointState(x);
+  arr coeffs = zeros(colliders.N, x.N);
+  for(uint i=0; i<colliders.N; i++) {
+    double reach = colliderRadius(i);
+    for(rai::Frame* f=colliders(i); f->parent; f=f->parent) {
+      rai::Joint* j = f->joint;
+      rai::Dof* dof = j;
+      if(j && j->mimic) dof = j->mimic;
+      if(j && dof->active && j->dim) {
+        double rot = reach + f->get_Q().pos.length(); //rotations pivot at most |Q.pos| away from the frame origin
+        double quat = RAI_2PI * rot;                 //rotation angle per change of a (near unit) quaternion coordinate
+        arr c(j->dim);
+        switch(j->type) {
+          case rai::JT_hingeX: case rai::JT_hingeY: case rai::JT_hingeZ: case rai::JT_universal:  c = rot;  break;
+          case rai::JT_transX: case rai::JT_transY: case rai::JT_transZ: case rai::JT_transXY: case rai::JT_trans3:  c = 1.;  break;
+          case rai::JT_transXYPhi:  c = {1., 1., rot};  break;
+          case rai::JT_transYPhi:  c = {1., rot};  break;
+          case rai::JT_phiTransXY:  c = {rot, 1., 1.};  break;
+          case rai::JT_circleZ: case rai::JT_quatBall:  c = quat;  break;
+          case rai::JT_XBall:  c = quat;  c(0) = 1.;  break;
+          case rai::JT_free:  c = quat;  c(0) = c(1) = c(2) = 1.;  break;
+          case rai::JT_tau:  c = 0.;  break;
+          default: HALT("motion bounds not implemented for joint type " <<j->type);
+        }
+        c *= j->scale;
+        for(uint k=0; k<j->dim; k++) coeffs(i, dof->qIndex+k) += c(k);
+      }
+      reach += f->get_Q().pos.length();
+    }
+  }
+  return coeffs;
+}
+
+/// a lower bound of the distance between colliders i and j; exact (up to the convex core approximation) only if the bounding
+/// spheres are closer than enough
+double ConfigurationProblem::pairDistance(uint i, uint j, double enough) {
+  rai::Frame* a = colliders(i), *b = colliders(j);
+  double d = (a->ensure_X().pos - b->ensure_X().pos).length() - colliderRadius(i) - colliderRadius(j);
+  if(d>enough) return d;
+  rai::Proxy p;
+  p.a = a;
+  p.b = b;
+  p.calc_coll();
+  edgeDistances++;
+  return p.d;
+}
+
+bool ConfigurationProblem::checkEdge(const arr& x0, const arr& x1, double resolution) {
+  ensureColliders();
+  arr dx = x1 - x0;
+
+  //-- per-collider motion bounds for the whole edge; the chain lengths (reach) are convex along the edge, so the max over both
+  //   ends bounds all intermediate configurations
+  arr coeffs = getMotionCoeffs(x0);
+  arr coeffs1 = getMotionCoeffs(x1);
+  for(uint k=0; k<coeffs.N; k++) coeffs.elem(k) = rai::MAX(coeffs.elem(k), coeffs1.elem(k));
+  arr bound = coeffs * fabs(dx);
+
+  //-- pairs where at least one collider moves; B = their relative motion bound
+  uintA pairs;
+  arr B;
+  for(uint k=0; k<colliderPairs.d0; k++) {
+    double b = bound(colliderPairs(k, 0)) + bound(colliderPairs(k, 1));
+    if(b>0.) { pairs.append(k); B.append(b); }
+  }
+  if(!pairs.N) return true;
+
+  struct Segment { double s0, s1; uintA pairs; arr d0, d1; };
+  auto distances = [&](uintA& idx, double s, double len) -> arr {
+    C->setJointState(x0 + s*dx);
+    edgeEvals++;
+    arr d(idx.N);
+    for(uint k=0; k<idx.N; k++) d(k) = pairDistance(colliderPairs(pairs(idx(k)), 0), colliderPairs(pairs(idx(k)), 1), B(idx(k))*len);
+    return d;
+  };
+
+  uintA all(pairs.N);
+  all.setStraightPerm();
+  std::vector<Segment> stack = { Segment{0., 1., all, distances(all, 0., 1.), distances(all, 1., 1.)} };
+  while(stack.size()) {
+    Segment seg = stack.back();
+    stack.pop_back();
+    double len = seg.s1-seg.s0;
+
+    //-- pairs not yet certified on this segment
+    uintA open;
+    arr d0, d1;
+    for(uint k=0; k<seg.pairs.N; k++) {
+      double b = B(seg.pairs(k))*len;
+      if(seg.d0(k)+seg.d1(k) > b) continue; //certified: the pair can't close the gap
+      if(b<resolution) continue; //certified up to resolution
+      open.append(seg.pairs(k));
+      d0.append(seg.d0(k));
+      d1.append(seg.d1(k));
+    }
+    if(!open.N) continue;
+
+    //-- bisect
+    double s = .5*(seg.s0+seg.s1);
+    arr dm = distances(open, s, .5*len);
+    double penetration=0.;
+    for(double d:dm) if(d<0.) penetration -= d;
+    if(penetration>=collisionTolerance) return false;
+    stack.push_back(Segment{seg.s0, s, open, d0, dm});
+    stack.push_back(Segment{s, seg.s1, open, dm, d1});
+  }
+  return true;
+}
+
+//===========================================================================
+
 void QueryResult::write(std::ostream& os) const {
   os <<" isFeasible: " <<isFeasible;
 }
@@ -43,6 +43,7 @@ struct ConfigurationProblem {
   //user info
   int verbose=0;
   uint evals=0;
+  uint edgeEvals=0, edgeDistances=0; //configurations and exact pair distances evaluated by checkEdge
   double queryTime=0.;
 
   ConfigurationProblem(shared_ptr<rai::Configuration> _C, bool _useBroadCollisions=true, double _collisionTolerance=1e-3, int _verbose=0);
@@ -50,4 +51,17 @@ struct ConfigurationProblem {
   void setExplicitCollisionPairs(const StringA& _collisionPairs);
 
   shared_ptr<QueryResult> query(const arr& x);
+
+  /// continuous collision check of the straight edge x0->x1 by conservative advancement: a pair is certified on a segment
+  /// if its motion bound is less than the sum of its distances at the segment ends; otherwise the segment is bisected,
+  /// down to motion bounds below resolution (in meters)
+  bool checkEdge(const arr& x0, const arr& x1, double resolution=1e-3);
+
+ private:
+  FrameL colliders;    //shapes considered by checkEdge
+  arr colliderRadius;  //bounding sphere radius around the frame origin
+  uintA colliderPairs; //(n x 2) indices into colliders
+  void ensureColliders();
+  arr getMotionCoeffs(const arr& x);
+  double pairDistance(uint i, uint j, double enough);
 };
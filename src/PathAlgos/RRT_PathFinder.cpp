@@ -11,6 +11,7 @@
 #include "../Gui/opengl.h"
 #include "../Kin/viewer.h"
 #include "../KOMO/pathTools.h"
+#include "../Core/profiler.h"
 
 #ifdef RAI_GL
 #  include <GL/glew.h>
@@ -190,8 +191,11 @@ bool RRT_PathFinder::growTreeToTree(RRT_SingleTree& rrt_A, RRT_SingleTree& rrt_B
   //evaluate the sample
   auto qr = P->query(q);
 
-  //checking subsamples
-  if(qr->isFeasible && opt.subsamples>0) {
+  //checking the edge
+  if(qr->isFeasible && opt.continuousEdges) {
+    const arr start = rrt_A.ann.X[parentID];
+    qr->isFeasible = P->checkEdge(start, q, opt.edgeResolution);
+  } else if(qr->isFeasible && opt.subsamples>0) {
     const arr start = rrt_A.ann.X[parentID];
     qr->isFeasible = checkConnection(*P, start, q, opt.subsamples, true);
   }
@@ -200,7 +204,7 @@ bool RRT_PathFinder::growTreeToTree(RRT_SingleTree& rrt_A, RRT_SingleTree& rrt_B
 
   //finally adding the new node to the tree
   if(qr->isFeasible){
-    rrt_A.add(q, parentID, qr);
+    uint newID = rrt_A.add(q, parentID, qr);
     if(P->sphericalCoordinates.N){
       CHECK_LE(P->sphericalCoordinates.d0, 1, "");
       arr q_org = q;
@@ -211,7 +215,10 @@ bool RRT_PathFinder::growTreeToTree(RRT_SingleTree& rrt_A, RRT_SingleTree& rrt_B
       q = q_org;
     }
     double dist = rrt_B.getNearest(q);
-    if(opt.subsamples>0) { if(dist<opt.stepsize/opt.subsamples) return true; }
+    if(opt.continuousEdges) { //the connecting edge is certified as well, and the path includes q
+      if(dist<opt.stepsize && P->checkEdge(q, rrt_B.getNode(rrt_B.nearestID), opt.edgeResolution)) { rrt_A.nearestID = newID; return true; }
+    }
+    else if(opt.subsamples>0) { if(dist<opt.stepsize/opt.subsamples) return true; }
     else { if(dist<opt.stepsize) return true; }
   }
 
@@ -293,6 +300,7 @@ void RRT_PathFinder::report(){
 }
 
 int RRT_PathFinder::stepConnect() {
+  RAI_PROFILE("RRT_PathFinder::stepConnect");
   iters++;
   if(iters>(uint)opt.maxIters) return -1;
 
@@ -55,6 +55,8 @@ struct RRT_PathFinder_Options {
   RAI_PARAM("rrt/", int, verbose, 0)
   RAI_PARAM("rrt/", double, stepsize, .1)
   RAI_PARAM("rrt/", int, subsamples, 4)
+  RAI_PARAM("rrt/", bool, continuousEdges, false) //check edges by conservative advancement instead of subsamples
+  RAI_PARAM("rrt/", double, edgeResolution, 1e-3) //for continuousEdges: bisect edges down to motion bounds below this (meters)
   RAI_PARAM("rrt/", int, maxIters, 5000)
   RAI_PARAM("rrt/", double, p_connect, .5)
   RAI_PARAM("rrt/", double, collisionTolerance, 1e-4)
@@ -107,4 +109,7 @@ private:
 
 void revertPath(arr& path);
 
+/// check the edge start->end at num-1 (binary: van der Corput ordered) intermediate points
+bool checkConnection(ConfigurationProblem& P, const arr& start, const arr& end, const uint num, const bool binary);
+
 } //namespace
@@ -160,7 +160,7 @@ void init_DataGen(pybind11::module& m) {
       .def(pybind11::init<>())
 
       .def("getSample", &RndStableConfigs::getSample,
-           "sample a random configuration - displayed, access via config passed at construction",
+           "sample a random stable configuration - on success (returns True) the passed config holds it",
            pybind11::arg("config"),
            pybind11::arg("supports"))
 
@@ -87,7 +87,7 @@ void init_Frame(pybind11::module& m) {
   }, "get frame attributes")
 
   .def_readonly("ID", &rai::Frame::ID, "the unique ID of the frame, which is also its index in lists/arrays (e.g. when the frameState is returned as matrix) (readonly)")
-  .def_readwrite("name", &rai::Frame::name, "the name of the frame (editable)")
+  .def_property("name", [](rai::Frame& f) { return f.name; }, [](rai::Frame& f, const rai::String& name) { f.name=name; f.C.resetNameIndex(); }, "the name of the frame (editable)")
 
   .def("getParent", [](shared_ptr<rai::Frame>& self) { if(self->parent) return shared_ptr<rai::Frame>(self->parent, &null_deleter);  return shared_ptr<rai::Frame>(); }, "")
   .def("getChildren", [](shared_ptr<rai::Frame>& self) {
@@ -230,6 +230,7 @@ void init_enums(pybind11::module& m) {
   ENUMVAL(FS, physics)
   ENUMVAL(FS, contactConstraints)
   ENUMVAL(FS, energy)
+  ENUMVAL(FS, jointTorques)
 
   ENUMVAL(FS, transAccelerations)
   ENUMVAL(FS, transVelocities)
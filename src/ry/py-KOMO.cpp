@@ -12,6 +12,7 @@
 #include "py-Config.h"
 #include "../KOMO/komo.h"
 #include "../KOMO/skeleton.h"
+#include "../Optim/NLP_Solver.h"
 
 //#include "../LGP/bounds.h"
 #include "../Kin/frame.h"
@@ -156,6 +157,27 @@ void init_KOMO(pybind11::module& m) {
   //  pybind11::class_<ry::ConfigViewer>(m, "ConfigViewer");
   pybind11::class_<Objective, shared_ptr<Objective>>(m, "KOMO_Objective");
 
+  m.def("KOMO_solveInParallel", [](const std::vector<shared_ptr<KOMO>>& komos, const rai::OptOptions& opt, uint threads) {
+    rai::Array<shared_ptr<rai::NLP_Solver>> solvers(komos.size());
+    for(uint i=0; i<solvers.N; i++) {
+      solvers(i) = make_shared<rai::NLP_Solver>();
+      solvers(i)->setProblem(komos[i]->nlp()).setOptions(opt);
+    }
+    {
+      pybind11::gil_scoped_release release;
+      rai::solveInParallel(solvers, threads);
+    }
+    std::vector<shared_ptr<SolverReturn>> rets;
+    for(auto& S:solvers) rets.push_back(S->ret);
+    return rets;
+  }, "solve a list of independent KOMO problems on a C++ thread pool (without the GIL); each KOMO is left in its solution state"
+  "\n* komos: list of KOMO objects -- each needs to be a distinct object"
+  "\n* opt: the solver options used for all problems"
+  "\n* threads: number of threads; 0 means all cores",
+  pybind11::arg("komos"),
+  pybind11::arg("opt")=rai::OptOptions(),
+  pybind11::arg("threads")=0);
+
 }
 
 #endif
@@ -21,6 +21,7 @@ void init_LGP(pybind11::module& m) {
       .def(pybind11::init<rai::Configuration&, rai::TAMP_Provider&, rai::Actions2KOMO_Translator&>(), "initialization")
 
       .def("solve", &rai::LGP_Tool::solve, "compute new solution", pybind11::arg("verbose")=1)
+      .def_readwrite("threads", &rai::LGP_Tool::threads, "number of jobs (motif and waypoint problems) solved concurrently in each step")
       .def("getSolvedPlan", &rai::LGP_Tool::getSolvedPlan, "return list of discrete decisions of current solution")
       .def("getSolvedKOMO", &rai::LGP_Tool::getSolvedKOMO, "return the solved KOMO object (including its continuous solution) of current solution")
 
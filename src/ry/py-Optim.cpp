@@ -31,7 +31,14 @@ struct PyNLP : NLP {
     bounds = numpy2arr<double>(py_nlp.attr("getBounds")());
   }
 
+  //solvers run with the GIL released -> all calls into python need to re-acquire it
+  ~PyNLP(){
+    pybind11::gil_scoped_acquire gil;
+    py_nlp = pybind11::object();
+  }
+
   virtual void evaluate(arr& phi, arr& J, const arr& x){
+    pybind11::gil_scoped_acquire gil;
     pybind11::object _phiJ = py_nlp.attr("evaluate")(arr2numpy(x));
     auto phiJ = _phiJ.cast< std::tuple< pybind11::array_t<double>, pybind11::array_t<double> > >();
     phi = numpy2arr(std::get<0>(phiJ));
@@ -43,16 +50,19 @@ struct PyNLP : NLP {
   }
 
   virtual void getFHessian(arr& H, const arr& x) {
+    pybind11::gil_scoped_acquire gil;
     pybind11::object _H = py_nlp.attr("getFHessian")(arr2numpy(x));
     H = numpy2arr(_H.cast<pybind11::array_t<double>>());
   }
 
   virtual arr getInitializationSample(){
+    pybind11::gil_scoped_acquire gil;
     pybind11::object _x = py_nlp.attr("getInitializationSample")();
     return numpy2arr(_x.cast<pybind11::array_t<double>>());
   }
 
   virtual void report(ostream& os, int verbose, const char* nomsg=0){
+    pybind11::gil_scoped_acquire gil;
     NLP::report(os, verbose, "(binding in py-Optim.cpp:52)");
     pybind11::object _msg = py_nlp.attr("report")(verbose);
     auto msg = _msg.cast<std::string>();
@@ -225,7 +235,7 @@ void init_Optim(pybind11::module& m) {
            pybind11::arg("problem")
           )
 
-      .def("sample", &NLP_Sampler::sample, "")
+      .def("sample", &NLP_Sampler::sample, "", pybind11::call_guard<pybind11::gil_scoped_release>())
       .def("setOptions", [](std::shared_ptr<NLP_Sampler>& self
     #define MEMBER(type, name, x) ,type name
            MEMBER(double, eps, .05)
@@ -325,8 +335,9 @@ void init_Optim(pybind11::module& m) {
 
       .def("setTracing", &rai::NLP_Solver::setTracing, "")
       .def("solve", &rai::NLP_Solver::solve,
-           "resampleInitialization=-1 means: only when not already solved",
-           pybind11::arg("resampleInitialization")=-1, pybind11::arg("verbose")=-100)
+           "resampleInitialization=-1 means: only when not already solved (releases the GIL while solving)",
+           pybind11::arg("resampleInitialization")=-1, pybind11::arg("verbose")=-100,
+           pybind11::call_guard<pybind11::gil_scoped_release>())
 
       .def("getProblem", &rai::NLP_Solver::getProblem, "returns the NLP problem")
       .def("getTrace_x", &rai::NLP_Solver::getTrace_x, "returns steps-times-n array with queries points in each row")
@@ -38,10 +38,11 @@ void init_Simulation(pybind11::module& m) {
 //  }))
 
       .def("step", &rai::Simulation::step,
-           "",
+           "(releases the GIL while stepping)",
            pybind11::arg("u_control"),
            pybind11::arg("tau") = .01,
-           pybind11::arg("u_mode") = rai::Simulation::_velocity
+           pybind11::arg("u_mode") = rai::Simulation::_velocity,
+           pybind11::call_guard<pybind11::gil_scoped_release>()
           )
 
       .def("setSplineRef", &rai::Simulation::setSplineRef,
@@ -132,12 +132,74 @@ void testKinematics(bool withCollisions, uint N=100000){
 
 // =============================================================================
 
+void TEST(EdgeChecking){
+  //a rotating/translating bar among thin walls: dense subsampling misses edges that pass through walls
+  auto C = make_shared<rai::Configuration>();
+  C->addFrame("base") -> setPosition({0.,0.,.05});
+  C->addFrame("ego", "base")-> setShape(rai::ST_ssBox, {.05, .3, .1, .01}) .setJoint(rai::JT_transXYPhi, {-1.,-1.,-3.,1.,1.,3.}) .setContact(1);
+  for(uint i=0;i<5;i++){
+    C->addFrame(STRING("wall"<<i))-> setShape(rai::ST_ssBox, {.01, .4, .1, .002}) .setPosition({-.8+.4*i, .3*(i%2?1.:-1.), .05}) .setContact(1);
+  }
+
+  ConfigurationProblem P(C, true, 1e-4);
+  uint N=1000, subsamples=4;
+  double stepsize = .5;
+
+  //-- random feasible edges
+  arr X0, X1;
+  while(X0.d0<N){
+    arr q0 = P.limits[0] + rand(3) % (P.limits[1]-P.limits[0]);
+    arr dq = randn(3);
+    arr q1 = q0 + (stepsize*rnd.uni()/length(dq)) * dq;
+    if(!P.query(q0)->isFeasible || !P.query(q1)->isFeasible) continue;
+    X0.append(q0); X0.reshape(-1,3);
+    X1.append(q1); X1.reshape(-1,3);
+  }
+
+  //-- ground truth by very dense subsampling
+  boolA truth(N);
+  for(uint i=0;i<N;i++) truth(i) = rai::checkConnection(P, X0[i], X1[i], 1000, false);
+  uint colliding=0;
+  for(bool t:truth) if(!t) colliding++;
+  CHECK_GE(colliding, N/50, "too few colliding edges to compare the checks");
+
+  auto benchmark = [&](const char* name, std::function<bool(const arr&, const arr&)> check){
+    P.evals=0;
+    P.edgeEvals=0;
+    uint misses=0, falseAlarms=0, collisions=0;
+    double time = -rai::cpuTime();
+    for(uint i=0;i<N;i++){
+      bool free = check(X0[i], X1[i]);
+      if(!truth(i)) collisions++;
+      if(free && !truth(i)) misses++;
+      if(!free && truth(i)) falseAlarms++;
+    }
+    time += rai::cpuTime();
+    cout <<name <<": time/edge: " <<1000.*time/N <<"msec  queries/edge: " <<double(P.evals+P.edgeEvals)/N
+         <<"  misses: " <<misses <<'/' <<collisions <<"  false alarms: " <<falseAlarms <<endl;
+    return misses;
+  };
+
+  uint subMisses = benchmark(STRING("subsampling(" <<subsamples <<")"), [&](const arr& q0, const arr& q1){ return rai::checkConnection(P, q0, q1, subsamples, true); });
+  benchmark(STRING("subsampling(" <<4*subsamples <<")"), [&](const arr& q0, const arr& q1){ return rai::checkConnection(P, q0, q1, 4*subsamples, true); });
+  uint caMisses = benchmark("conservative advancement", [&](const arr& q0, const arr& q1){ return P.checkEdge(q0, q1, 1e-4); });
+  cout <<"  exact pair distances: " <<P.edgeDistances <<endl;
+  //conservative advancement never reports an edge as free that the ground truth finds in collision
+  CHECK_EQ(caMisses, 0, "conservative advancement missed a collision");
+  CHECK_LE(caMisses, subMisses, "");
+}
+
+// =============================================================================
+
 int MAIN(int argc,char **argv){
   rai::initCmdLine(argc, argv);
 
 //  rnd.clockSeed();
   // test_minimalistic(); return 0;
 
+  cout <<"=== edge checking benchmark" <<endl;
+  testEdgeChecking();
+
   cout <<"=== RRT test" <<endl;
   testRRT();
 
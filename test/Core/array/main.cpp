@@ -2,6 +2,7 @@
 #include <Core/util.h>
 
 #include <math.h>
+#include <thread>
 
 using namespace std;
 
@@ -384,6 +385,55 @@ void TEST(MemoryBound){
 
 //===========================================================================
 
+void TEST(AllocationModes){
+  cout <<"\n*** inline buffer, arena, allocation counting\n";
+  rai::ArrayAllocCounter count;
+
+  //tiny arrays need no allocation, and survive moves and growing beyond the inline buffer
+  arr a = {1., 2., 3.};
+  uintA pair = {4, 5};
+  CHECK_EQ(a.memSource, a.memInline, "");
+  arr b(std::move(a));
+  CHECK_EQ(b, arr({1., 2., 3.}), "");
+  CHECK_EQ(a.N, 0, "");
+  b.append(4.);
+  b.append(5.);
+  rai::ArrayAllocStats s = count();
+  cout <<s <<endl;
+  CHECK_EQ(s.heapAllocs, 1, "only growing beyond the inline buffer allocates");
+  CHECK_EQ(b, arr({1., 2., 3., 4., 5.}), "");
+  CHECK_EQ(pair(1), 5, "");
+
+  //in an arena scope, temporaries come from blocks -- also those that escape the scope or are freed on other threads
+  arr kept;
+  count.reset();
+  {
+    rai::ArrayArena::Scope arena;
+    for(uint k=0; k<1000; k++) {
+      arr x = rand(20), J = randn(6, 20);
+      arr y = J*x;
+      if(k==500) kept = y;
+    }
+    arr big(100000); //too large for the arena
+    big = 1.;
+  }
+  s = count();
+  cout <<s <<endl;
+  CHECK_GE(s.arenaAllocs, 3000, "");
+  CHECK_LE(s.heapAllocs, 10, "");
+  CHECK_EQ(kept.N, 6, "");
+
+  arr* shared;
+  {
+    rai::ArrayArena::Scope arena;
+    shared = new arr(rand(100));
+  }
+  std::thread th([shared](){ delete shared; });
+  th.join();
+}
+
+//===========================================================================
+
 void TEST(BinaryIO){
   cout <<"\n*** acsii and binary IO\n";
   arr a,b; a.resize(1000,100); rndUniform(a,0.,1.,false);
@@ -438,6 +488,35 @@ void TEST(Expression){
 
 //===========================================================================
 
+void TEST(FusedKernels){
+  cout <<"\n*** fused kernels\n";
+  arr A = randn(50, 20), x = randn(20), y = randn(20), b = randn(50), c = randn(50), w = rand(50);
+  w(3) = 0.; A(7, 2) = 0.;
+
+  arr z = y;
+  op_axpy(z, .3, x);
+  CHECK_ZERO(maxDiff(z, y + .3*x), 1e-12, "");
+  op_scaledSum(z, 2., x, -1., y);
+  CHECK_ZERO(maxDiff(z, 2.*x - y), 1e-12, "");
+  arr x0 = x;
+  op_scaledSum(x, 1., x, .5, y); //in place
+  CHECK_ZERO(maxDiff(x, x0 + .5*y), 1e-12, "");
+  CHECK_ZERO(scalarProductOfDiff(x, y, z) - scalarProduct(x-y, z), 1e-12, "");
+  CHECK_ZERO(absMaxDiff(x, y) - absMax(x-y), 1e-12, "");
+
+  CHECK_ZERO(maxDiff(comp_At_x(A, b), ~A*b), 1e-10, "");
+  CHECK_ZERO(maxDiff(comp_At_xpy(A, b, c), ~A*(b+c)), 1e-10, "");
+  CHECK_ZERO(maxDiff(comp_At_A(A), ~A*A), 1e-10, "");
+  CHECK_ZERO(maxDiff(comp_At_W_A(A, w), ~A*diag(w)*A), 1e-10, "");
+
+  //sparse matrices take the same route
+  arr S = A;
+  S.sparse();
+  CHECK_ZERO(maxDiff(unpack(comp_At_W_A(S, w)), ~A*diag(w)*A), 1e-10, "");
+}
+
+//===========================================================================
+
 void TEST(Permutation){
   cout <<"\n*** permutation\n";
   uintA p;
@@ -948,8 +1027,10 @@ int MAIN(int argc, char **argv){
   testMatlab();
   testException();
   testMemoryBound();
+  testAllocationModes();
   testBinaryIO();
   testExpression();
+  testFusedKernels();
   testPermutation();
   testGnuplot();
   testDeterminant();
@@ -0,0 +1,149 @@
+#include <Core/binary.h>
+#include <Core/h5.h>
+#include <iomanip>
+
+//===========================================================================
+
+rai::Graph testGraph(){
+  rai::Graph G = {"x", "b", {"a", 3.}, {"b", {"x"}, 5.}, {"c", rai::String("BLA")} };
+  G["d"] = arr{{2,1},{1., 2.5}};
+  G["e"] = StringA{"alpha", "beta"};
+  G.add<int>("i", -3);
+  G.add<uint>("u", 7);
+  G.add<bool>("off", false);
+  G.add<byteA>("bytes", {1, 2, 3});
+  G.add<intAA>("nested", {{1, 2}, {3}}); //no binary encoding: stored as text
+  rai::Graph& sub = G.addSubgraph("sub", {G.findNode("a")});
+  sub.add<double>("y", 1.);
+  sub.add<floatA>("f", {1.f, 2.f});
+  sub.add<bool>("edge", true)->setParents({G.findNode("b"), sub.findNode("y")});
+  return G;
+}
+
+void TEST(Arrays){
+  arr x = rand({3,4,2});
+  intA i = {1, -2, 3};
+  uint16A s(100);
+  for(uint k=0;k<s.N;k++) s(k)=k;
+  arr empty;
+
+  {
+    rai::BinaryWriter W("z.rbin");
+    W.add("x", x);
+    W.add("i", i);
+    W.add("s", s);
+    W.add("empty", empty);
+    W.addGraph("info", testGraph());
+  }
+
+  rai::BinaryReader R("z.rbin");
+  CHECK_EQ(R.records.N, 5, "");
+  CHECK_ZERO(maxDiff(R.read<double>("x"), x), 0., "");
+  CHECK_EQ(R.read<int>("i"), i, "");
+  CHECK_EQ(R.read<uint16_t>("s"), s, "");
+  CHECK_EQ(R.read<double>("empty").N, 0, "");
+  CHECK(!R.exists("y"), "");
+  CHECK_EQ(R.read<double>("y", true).N, 0, "");
+
+  arr y = R.refer<double>("x");
+  CHECK(y.isReference, "");
+  CHECK_EQ(y.dim(), x.dim(), "");
+  CHECK_ZERO(maxDiff(y, x), 0., "");
+
+  rai::Graph G = R.readGraph("info");
+  cout <<G <<endl;
+  G.checkConsistency();
+  CHECK_EQ(STRING(G), STRING(testGraph()), "");
+  CHECK_EQ(G["sub"]->parents.N, 1, "");
+  CHECK_EQ(G["sub"]->graph()["edge"]->parents(0), G["b"], "");
+
+  rai::Graph A = R.readAll();
+  cout <<A <<endl;
+  CHECK_EQ(A.N, 5, "");
+}
+
+//===========================================================================
+
+void TEST(Append){
+  {
+    rai::BinaryWriter W("z.rbin");
+    W.add("x", arr{0.});
+  }
+  for(uint t=1;t<10;t++){
+    rai::BinaryWriter W("z.rbin", true);
+    W.add("x", arr{double(t)});
+  }
+
+  //a truncated record (e.g. a killed process) is dropped
+  {
+    std::ofstream fil("z.rbin", std::ios::binary | std::ios::app);
+    fil <<"garbage";
+  }
+  {
+    rai::BinaryReader R("z.rbin");
+    CHECK_EQ(R.records.N, 10, "");
+    for(uint t=0;t<10;t++) CHECK_EQ(R.read<double>(t).scalar(), double(t), "");
+    CHECK_EQ(R.read<double>("x").scalar(), 9., "the last record of a name");
+  }
+  {
+    rai::BinaryWriter W("z.rbin", true);
+    W.add("x", arr{10.});
+  }
+  rai::BinaryReader R("z.rbin");
+  CHECK_EQ(R.records.N, 11, "");
+  CHECK_EQ(R.read<double>("x").scalar(), 10., "");
+}
+
+//===========================================================================
+
+void TEST(Benchmark){
+  arr x = randn(2000, 500);
+
+  rai::Graph G;
+  for(uint i=0;i<20000;i++){
+    rai::Graph& frame = G.addSubgraph(STRING("frame" <<i));
+    frame.add<double>("time", .1*i);
+    frame.add<arr>("pose", rand(7));
+    frame.add<rai::String>("shape", "box");
+  }
+
+  double t;
+  auto tic = [&t](){ t = rai::cpuTime(); };
+  auto toc = [&t](const char* what){ cout <<"  " <<std::setw(28) <<std::left <<what <<rai::cpuTime()-t <<"sec" <<endl; };
+
+  cout <<"== array " <<x.dim() <<endl;
+  tic();  x.writeTagged(FILE("z.arr"), "x");  toc("text write");
+  arr y;
+  tic();  y.readTagged(FILE("z.arr"), "x");  toc("text read");
+  tic();  { rai::BinaryWriter W("z.rbin");  W.add("x", x); }  toc("binary write");
+  tic();  { rai::BinaryReader R("z.rbin");  y = R.read<double>("x"); }  toc("binary read");
+  CHECK_ZERO(maxDiff(x, y), 0., "");
+  tic();  { rai::BinaryReader R("z.rbin");  arr z = R.refer<double>("x");  CHECK_EQ(z.N, x.N, ""); }  toc("binary map"); //z must not outlive R
+#ifdef RAI_H5
+  tic();  { rai::H5_Writer H("z.h5");  H.add("x", x); }  toc("h5 write");
+  tic();  { rai::H5_Reader H("z.h5");  y = H.read<double>("x"); }  toc("h5 read");
+#endif
+
+  cout <<"== graph of " <<G.N <<" subgraphs" <<endl;
+  tic();  FILE("z.g") <<G;  toc("text write");
+  rai::Graph H;
+  tic();  H.read(FILE("z.g"));  toc("text read");
+  CHECK_EQ(H.N, G.N, "");
+  tic();  { rai::BinaryWriter W("z.rbin");  W.addGraph("G", G); }  toc("binary write");
+  tic();  { rai::BinaryReader R("z.rbin");  rai::Graph B = R.readGraph("G");  CHECK_EQ(B.N, G.N, ""); }  toc("binary read");
+  rai::BinaryReader R("z.rbin");
+  rai::Graph B = R.readGraph("G");
+  CHECK_ZERO(maxDiff(B.elem(-1)->graph().get<arr>("pose"), G.elem(-1)->graph().get<arr>("pose")), 0., "");
+}
+
+//===========================================================================
+
+int MAIN(int argc, char** argv){
+  rai::initCmdLine(argc, argv);
+
+  testArrays();
+  testAppend();
+  testBenchmark();
+
+  return 0;
+}
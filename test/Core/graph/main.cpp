@@ -1,4 +1,5 @@
 #include <Core/graph.h>
+#include <thread>
 
 //const char *filename="/home/mtoussai/git/3rdHand/documents/USTT/14-meeting3TUD/box.g";
 const char *filename=nullptr;
@@ -132,6 +133,44 @@ void TEST(Random){
 
 //===========================================================================
 
+void TEST(KeyIndex){
+  //large graphs are looked up by a hash index -- compare with a linear scan under random edits
+  rai::Graph G;
+  auto linear = [&G](const char* key){ rai::NodeL L; for(rai::Node* n:G) if(n->key==key) L.append(n); return L; };
+  for(uint k=0;k<2000;k++){
+    rai::String key = STRING("n" <<rnd(300));
+    switch(rnd(4)){
+      case 0: G.add<double>(key, k);  break;
+      case 1: G.add<rai::String>(key, key);  break;
+      case 2: if(G.N) delete G.rndElem();  G.index();  break;
+      case 3: if(G.N){ G.rndElem()->key = key;  G.resetKeyIndex(); }  break;
+    }
+    key = STRING("n" <<rnd(300));
+    CHECK_EQ(G.findNodes(key), linear(key), "key index inconsistent");
+    rai::NodeL L = linear(key);
+    CHECK_EQ(G.findNode(key), (L.N?L(0):nullptr), "");
+    rai::Node* s=0;
+    for(rai::Node* n:L) if(n->is<rai::String>()){ s=n; break; }
+    CHECK_EQ(G.findNodeOfType(typeid(rai::String), key), s, "");
+  }
+  cout <<"** key index consistent for " <<G.N <<" nodes" <<endl;
+
+  //concurrent const lookups, including the first one that creates the index
+  for(uint k=0;k<20;k++){
+    rai::Graph H;
+    for(uint i=0;i<100;i++) H.add<double>(STRING("n" <<i), i);
+    std::vector<std::thread> threads;
+    std::atomic<uint> found{0};
+    for(uint t=0;t<4;t++) threads.emplace_back([&H, &found, t](){
+      for(uint i=t;i<100;i+=4) if(H.findNode(STRING("n" <<i))==H(i)) found++;
+    });
+    for(std::thread& th:threads) th.join();
+    CHECK_EQ(found.load(), 100u, "concurrent lookups inconsistent");
+  }
+}
+
+//===========================================================================
+
 void TEST(Dot){
   rai::Graph G;
   G <<FILE(filename?filename:"coffee_shop.fg");
@@ -167,6 +206,7 @@ int MAIN(int argc, char** argv){
   if(argc>1 && argv[1][0]!='-') filename=argv[1];
 
   testRandom();
+  testKeyIndex();
   testRead();
   testInit();
   testDot();
@@ -38,9 +38,61 @@ int read(const char* filename){
   return 0; // successfully terminated
 }
 
+void stream(const char* filename){
+  rai::H5_Writer H(filename, true);
+  H.opt.chunkBytes = 1<<12; //small chunks and queues: many chunk writes, wrapping queues
+  H.opt.queueChunks = 2;
+  uint q = H.addStream<double>("q", {7});
+  uint depth = H.addStream<uint16_t>("depth", {48, 64});
+
+  arr x(7);
+  uint16A d(48, 64);
+  double time = -rai::clockTime();
+  for(uint t=0;t<2000;t++){
+    x = double(t);
+    d = uint16_t(t);
+    H.append(q, x);
+    H.append(depth, d);
+    if(t==999){ //inspect the growing file from another process
+      H.flush();
+      CHECK_EQ(std::system(STRING(rai::argv[0] <<" -inspect " <<filename)), 0, "inspecting the growing file failed");
+    }
+  }
+  time += rai::clockTime();
+  cout <<"appended 2x2000 frames: " <<time <<"sec" <<endl;
+  CHECK_EQ(H.dropped(), 0, "");
+}
+
+void inspect(const char* filename){
+  rai::H5_Reader R(filename, true);
+  arr q = R.read<double>("q");
+  uint16A d = R.read<uint16_t>("depth");
+  cout <<"inspected: " <<q.dim() <<' ' <<d.dim() <<endl;
+  CHECK_EQ(q.d0, 1000, "");
+  CHECK_EQ(d.d0, 1000, "");
+  CHECK_EQ(q(-1, 0), 999., "");
+}
+
+void checkStream(const char* filename){
+  rai::H5_Reader R(filename);
+  arr q = R.read<double>("q");
+  uint16A d = R.read<uint16_t>("depth");
+  CHECK_EQ(q.dim(), uintA({2000, 7}), "");
+  CHECK_EQ(d.dim(), uintA({2000, 48, 64}), "");
+  for(uint t=0;t<q.d0;t++){
+    CHECK_EQ(q(t, 3), double(t), "");
+    CHECK_EQ(d(t, 47, 63), uint16_t(t), "");
+  }
+}
 
 int main(int argn, char** argv){
+  rai::initCmdLine(argn, argv);
+  if(rai::checkCmdLineTag("inspect")){ inspect(rai::argv[2]); return 0; }
+
   write("bla.h5");
   read("bla.h5");
+
+  stream("stream.h5");
+  checkStream("stream.h5");
   return 0;
 }
@@ -170,6 +170,92 @@ void PairSorter::step(){
   }
 }
 
+//==============================================================================
+
+void TEST(ThreadPool){
+  uint n=1000;
+  arr y = zeros(n);
+  uintA workerOf(n);
+  parallelFor(n, [&](uint i, uint worker){
+    y(i) = double(i)*i;
+    workerOf(i) = worker;
+  }, 4);
+  for(uint i=0;i<n;i++) CHECK_EQ(y(i), double(i)*i, "");
+  CHECK_LE(max(workerOf), 3u, "");
+
+  //exceptions thrown in jobs are passed on to waitForAll
+  ThreadPool pool(2);
+  pool.add([](uint){ HALT("job failure"); });
+  bool caught=false;
+  try{ pool.waitForAll(); } catch(...){ caught=true; }
+  CHECK(caught, "");
+}
+
+//==============================================================================
+//
+// lock-free variables
+//
+
+// one writer and several readers exchange arrays; compare lock-free and RWLock-based variables
+template<class V> void benchmarkVar(V& x, uint readers, double duration, const char* name){
+  std::atomic<bool> stop{false};
+  std::atomic<uint> reads{0};
+  uint writes=0;
+
+  std::vector<std::thread> R;
+  for(uint r=0;r<readers;r++) R.emplace_back([&x, &stop, &reads](){
+    V y(x);
+    uint n=0;
+    int lastRev=-1;
+    while(!stop){
+      auto a = y.get();
+      const arr& X = a();
+      if(X.N){
+        CHECK_EQ(X.first(), X.last(), "read a partially written value");
+        CHECK_GE(int(X.first()), lastRev, "revision went backward");
+        lastRev = X.first();
+      }
+      n++;
+    }
+    reads += n;
+  });
+
+  double t0=rai::realTime();
+  while(rai::realTime()-t0<duration){
+    auto a = x.set();
+    arr& X = a();
+    X.resize(1000);
+    X = double(++writes);
+  }
+  stop=true;
+  for(auto& r:R) r.join();
+  cout <<name <<": readers: " <<readers <<" writes/s: " <<writes/duration <<" reads/s: " <<reads/duration <<endl;
+}
+
+void TEST(LockFreeVar){
+  //-- revisions
+  LockFreeVar<arr> x(4);
+  CHECK(!x.hasNewRevision(), "");
+  x.set() = arr{1.,2.};
+  CHECK(x.hasNewRevision(), "");
+  CHECK_EQ(x.get()->N, 2, "");
+  CHECK(!x.hasNewRevision(), "");
+
+  std::thread th([&x](){ rai::wait(.1); x.set() = arr{3.}; });
+  x.waitForNextRevision();
+  CHECK_EQ(x.get()->elem(0), 3., "");
+  CHECK_EQ(x.last_read_revision, 2, "");
+  th.join();
+
+  //-- benchmark against Var
+  for(uint readers:{1u, 3u}){
+    LockFreeVar<arr> a(readers);
+    benchmarkVar(a, readers, .5, "LockFreeVar");
+    Var<arr> b;
+    benchmarkVar(b, readers, .5, "Var        ");
+  }
+}
+
 //==============================================================================
 //
 // logging with threads
@@ -209,6 +295,8 @@ int MAIN(int argc,char** argv){
   testMetronome();
   testThread();
   testSorter();
+  testThreadPool();
+  testLockFreeVar();
 
   testWay0();
   testWay1();
@@ -1,7 +1,9 @@
 #include <Core/util.h>
 #include <Core/graph.h>
+#include <Core/profiler.h>
 #include <math.h>
 #include <iomanip>
+#include <thread>
 
 void TEST(String){
   //-- basic IO
@@ -50,6 +52,26 @@ void TEST(Parameter){
   double d = rai::getParameter<double>("number");
 
   cout <<p1 <<endl <<p2 <<endl <<d <<endl;
+
+  //-- RAI_PARAMs resolve their key once, and again after changes
+  struct Options {
+    RAI_PARAM("test/", double, number, 1.)
+    RAI_PARAM("test/", int, count, 3)
+  };
+  Options a;
+  CHECK_EQ(a.number, 1., "");
+  rai::setParameter<double>("test/number", 2.);
+  Options b;
+  CHECK_EQ(b.number, 2., "");
+  CHECK_EQ(b.count, 3, "");
+  CHECK_EQ(a.number, 1., "options keep the value of their construction");
+
+  //-- all used parameters, e.g. to be stored with results
+  rai::Graph used = rai::getUsedParameters();
+  cout <<used <<endl;
+  CHECK_EQ(used.get<double>("number"), d, "");
+  CHECK_EQ(used.get<double>("test/number"), 2., "");
+  CHECK_EQ(used.get<int>("test/count"), 3, "");
 }
 
 void TEST(Wait){
@@ -105,6 +127,78 @@ void TEST(Inotify){
   }
 }
 
+//===========================================================================
+
+void TEST(RndThreads){
+  uint32_t a=0, b=0, c=0, d=0;
+  std::thread t1([&a](){ a=rnd.num(); });
+  std::thread t2([&b](){ b=rnd.num(); });
+  t1.join(); t2.join();
+  rai::Rnd mainRnd;
+  mainRnd.seedThread(0);
+  uint32_t m = mainRnd.num();
+  CHECK(a!=b && a!=m && b!=m, "lazily seeded threads draw different streams");
+
+  std::thread t3([&c](){ rnd.seedThread(2); c=rnd.num(); });
+  t3.join();
+  std::thread t4([&d](){ rnd.seedThread(2); d=rnd.num(); });
+  t4.join();
+  CHECK_EQ(c, d, "seedThread is reproducible");
+}
+
+//===========================================================================
+
+void burn(double sec){ double t=rai::realTime(); while(rai::realTime()-t<sec){} }
+
+void TEST(Profiler){
+  rai::Profiler& P = rai::profiler();
+  P.enable();
+
+  auto work = [](){
+    for(uint i=0;i<10;i++){
+      RAI_PROFILE("outer");
+      burn(1e-3);
+      { RAI_PROFILE("inner"); burn(1e-3); }
+      rai::ProfileZone zone("explicit");
+      burn(1e-4);
+      zone.end();
+    }
+  };
+  work();
+  std::thread th(work);
+  th.join();
+  CHECK_EQ(P.liveThreads(), 1, "the exited thread's buffers are freed");
+
+  P.report();
+  CHECK_GE(P.time("inner"), .018, "");
+  CHECK_GE(P.time("outer"), P.time("inner") + P.time("explicit"), "nested zones are included in their parent");
+  P.writeChromeTrace("z.trace.json");
+
+  P.clear();
+  CHECK_EQ(P.time("outer"), 0., "");
+  P.enable(false);
+  { RAI_PROFILE("outer"); }
+  CHECK_EQ(P.time("outer"), 0., "disabled profiler records nothing");
+
+  double counter=0.;
+  { rai::ProfileZone zone("counted", counter); burn(1e-3); }
+  CHECK_GE(counter, 1e-3, "counters are measured also when disabled");
+
+  //zones must end innermost first (in a thread of its own, as its zone stack is left inconsistent)
+  P.enable();
+  bool thrown=false;
+  std::thread th2([&thrown](){
+    rai::ProfileZone a("a");
+    rai::ProfileZone b("b");
+    try{ a.end(); } catch(...){ thrown=true; }
+  });
+  th2.join();
+  CHECK(thrown, "ending a zone before its nested zone is an error");
+  P.enable(false);
+}
+
+//===========================================================================
+
 int MAIN(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
@@ -119,6 +213,8 @@ int MAIN(int argc,char** argv){
   testTimer();
   testLogging();
   testException();
+  testRndThreads();
+  testProfiler();
   testInotify();
 
   return 0;
@@ -1,4 +1,5 @@
 #include <DataGen/shapenetGrasps.h>
+#include <DataGen/shardedGenerator.h>
 #include <Core/h5.h>
 
 //===========================================================================
@@ -106,6 +107,23 @@ void displayGraspsFiles(uint N=10) {
   SG.displaySamples(convert<double>(X), shapes);
 }
 
+//===========================================================================
+
+void generateShards() {
+  //parallel generation into z.shards/shard*.rbin -- rerun to resume after a kill
+  rai::system("rm -rf z.shards");
+  ShardedGenerator gen(ShapenetGrasps_generator());
+  gen.opt.set_path("z.shards").set_shards(2).set_samplesPerShard(3).set_threads(2);
+  gen.run();
+
+  rai::Graph data = ShardedGenerator::readShard(gen.shardFile(0));
+  arr X = data.get<arr>("x");
+  arr S = data.get<arr>("scores");
+  CHECK_EQ(X.d0, 3, "");
+  uint succ=0;
+  for(uint i=0;i<S.d0;i++) if(min(S[i])>0.) succ++;
+  cout <<"shard 0: #samples: " <<X.d0 <<" #success: " <<succ <<endl;
+}
 
 //===========================================================================
 
@@ -118,6 +136,7 @@ int main(int argc,char** argv){
   // testBatchGeneration();
   // generateGraspsFiles(100);
   // displayGraspsFiles();
+  generateShards();
 
   return 0;
 }
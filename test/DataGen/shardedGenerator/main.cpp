@@ -0,0 +1,92 @@
+#include <DataGen/shardedGenerator.h>
+
+//===========================================================================
+
+void TEST(Shards) {
+  //a synthetic generator that fails about every other attempt
+  auto factory = [](uint worker) -> ShardedGenerator::SampleFct {
+    return [](rai::Graph& sample) {
+      if(rnd.uni()<.5) return false;
+      sample.add<arr>("x", rand(3));
+      return true;
+    };
+  };
+
+  rai::system("rm -rf z.shards1 z.shards4");
+  rai::Graph shard1;
+  for(uint threads:{1, 4}) {
+    ShardedGenerator gen(factory);
+    gen.opt.set_verbose(0).set_path(STRING("z.shards" <<threads)).set_shards(4).set_samplesPerShard(25).set_chunkSamples(10).set_threads(threads);
+    gen.run();
+    CHECK_EQ(gen.shardsDone, 4, "");
+    rai::Graph data = ShardedGenerator::readShard(gen.shardFile(1));
+    CHECK_EQ(data.get<arr>("x").d0, 25, "");
+    CHECK_EQ(data.get<arr>("x").d1, 3, "");
+    if(threads==1) shard1 = data;
+    else CHECK_ZERO(maxDiff(data.get<arr>("x"), shard1.get<arr>("x")), 0., "shards depend on threading");
+
+    //resume: existing shards are skipped
+    ShardedGenerator again(factory);
+    again.opt = gen.opt;
+    again.run();
+    CHECK_EQ(again.shardsSkipped, 4, "");
+    CHECK_EQ(again.shardsDone, 0, "");
+  }
+
+  //a generator that always fails gives up (and leaves no shard file)
+  rai::system("rm -rf z.shards0");
+  ShardedGenerator fail([](uint worker) -> ShardedGenerator::SampleFct { return [](rai::Graph& sample) { return false; }; });
+  fail.opt.set_verbose(0).set_path("z.shards0").set_shards(2).set_samplesPerShard(5).set_maxAttemptsPerSample(10);
+  fail.run();
+  CHECK_EQ(fail.shardsFailed, 2, "");
+  CHECK_EQ(fail.attempts, 2*5*10, "");
+  CHECK(!rai::FileToken(fail.shardFile(0)).exists(), "");
+}
+
+//===========================================================================
+
+void TEST(Merge) {
+  //shards of two processes are merged in shard order
+  auto factory = [](uint worker) -> ShardedGenerator::SampleFct {
+    return [](rai::Graph& sample) {
+      sample.add<arr>("x", arr{rnd.uni(), rnd.uni()});
+      sample.add<arr>("id", arr{1.});
+      return true;
+    };
+  };
+
+  rai::system("rm -rf z.shardsM");
+  ShardedGenerator_Options opt;
+  opt.set_verbose(0).set_path("z.shardsM").set_shards(5).set_samplesPerShard(7).set_chunkSamples(3).set_processes(2);
+  for(int process:{1, 0}) {
+    ShardedGenerator gen(factory);
+    gen.opt = opt;
+    gen.opt.set_process(process);
+    gen.run();
+    CHECK_EQ(gen.shardsDone, (process ? 2u : 3u), "process i generates the shards k%2==i");
+  }
+
+  ShardedGenerator gen(factory);
+  gen.opt = opt;
+  rai::Graph all = gen.readShards();
+  arr X = all.get<arr>("x");
+  CHECK_EQ(X.d0, 5*7, "");
+  CHECK_EQ(X.d1, 2, "");
+  CHECK_EQ(all.get<arr>("id").d0, 5*7, "");
+  for(int k=0; k<5; k++) {
+    arr Xk = ShardedGenerator::readShard(gen.shardFile(k)).get<arr>("x");
+    CHECK_ZERO(maxDiff(Xk, X({k*7, k*7+7})), 0., "shard " <<k <<" is not at its place in the merge");
+  }
+}
+
+
+//===========================================================================
+
+int main(int argc,char** argv){
+  rai::initCmdLine(argc,argv);
+
+  testShards();
+  testMerge();
+
+  return 0;
+}
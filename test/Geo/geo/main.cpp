@@ -1,4 +1,5 @@
 #include <Geo/geo.h>
+#include <Geo/depth2PointCloud.h>
 #include <Core/array.h>
 #include <Core/util.h>
 #include <math.h>
@@ -139,9 +140,83 @@ void TEST(QuaternionJacobian){
 
 //===========================================================================
 
+void TEST(DepthStream){
+  uint H=480, W=640;
+  arr fxycxy = {500., 500., 320., 240.};
+  floatA depth(H, W);
+  for(uint i=0;i<H;i++) for(uint j=0;j<W;j++) depth(i,j) = 1.+.001*i;
+  depth(10,10) = -1.; //invalid
+
+  //-- compare with depthData2pointCloud
+  arr pts;
+  depthData2pointCloud(pts, depth, fxycxy);
+  pts.reshape(-1,3);
+
+  DepthStream S(fxycxy);
+  const floatA& P = S.process(depth);
+  CHECK_EQ(P.d0, H*W-1, "");
+  arr P2;
+  copy(P2, P);
+  for(uint k=0, l=0;k<pts.d0;k++){
+    if(pts(k,2)<=0.) continue;
+    CHECK_ZERO(maxDiff(pts[k], P2[l]), 1e-5, "");
+    l++;
+  }
+  arr P0 = P2;
+
+  //-- world frame
+  rai::Transformation X;
+  X.setRandom();
+  const floatA& Q = S.process(depth, X);
+  arr Q2;
+  copy(Q2, Q);
+  X.applyOnPointArray(P2);
+  CHECK_ZERO(maxDiff(P2, Q2), 1e-4, "");
+
+  //-- stride and voxels
+  DepthStream V(fxycxy);
+  V.opt.set_stride(2).set_voxelSize(.05);
+  uint n = V.process(depth).d0;
+  cout <<"voxels: " <<n <<endl;
+  CHECK(n>0 && n<H*W/4, "");
+
+  //-- timing: no allocations after the first frame
+  int64_t mem = rai::globalMemoryTotal;
+  double time=-rai::cpuTime();
+  for(uint t=0;t<100;t++) S.process(depth, X);
+  time+=rai::cpuTime();
+  CHECK_EQ(mem, rai::globalMemoryTotal, "DepthStream reallocated");
+  cout <<"DepthStream: " <<1e3*time/100. <<"ms per frame" <<endl;
+
+  //-- the thread: a copy of the compact cloud, and per-pixel points as before (when referred to)
+  Var<floatA> depthVar;
+  Depth2PointCloud D(depthVar, fxycxy);
+  depthVar.set() = depth;
+  D.cloud.waitForRevisionGreaterThan(0);
+  floatA cloud = D.cloud.get();
+  CHECK_EQ(cloud.d0, H*W-1, "");
+  CHECK_EQ(D.points.getRevision(), 0, "points are not computed without readers");
+
+  Var<arr> pointsVar(nullptr, D.points);
+  for(int t=1;t<=3;t++){
+    depthVar.set() = depth;
+    pointsVar.waitForRevisionGreaterThan(t-1);
+    if(t==1) mem = rai::globalMemoryTotal; //the first frame with points allocates them
+    else CHECK_EQ(mem, rai::globalMemoryTotal, "Depth2PointCloud reallocated");
+  }
+  arr points = pointsVar.get();
+  CHECK_EQ(points.dim(), uintA({H, W, 3}), "");
+  CHECK_ZERO(maxDiff(points.reshape(-1,3), pts), 1e-10, "");
+  cloud = D.cloud.get();
+  CHECK_ZERO(maxDiff(rai::convert<double>(cloud), P0), 1e-5, "");
+}
+
+//===========================================================================
+
 int MAIN(int argc,char **argv){
   rai::initCmdLine(argc, argv);
 
+  testDepthStream();
   testQuaternions(); return 0;
 
   testBasics();
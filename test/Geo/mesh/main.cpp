@@ -3,6 +3,8 @@
 #include <Gui/RenderData.h>
 #include <Geo/qhull.h>
 #include <Geo/signedDistanceFunctions.h>
+#include <Geo/assetCache.h>
+#include <iomanip>
 
 #include <math.h>
 
@@ -132,6 +134,79 @@ void TEST(SimpleImplicitSurfaces) {
 
 //===========================================================================
 
+void TEST(AssetCache) {
+  rai::AssetCache& cache = rai::assetCache();
+  cache.opt.path = "z.assets";
+  rai::system("rm -rf z.assets");
+
+  //hulls: computed once, then shared in memory; after clear() loaded from disk
+  rai::Mesh m;
+  m.setRandom(1000);
+  double time=-rai::realTime();
+  auto h1 = cache.convexHull(m.V);
+  time += rai::realTime();
+  auto h2 = cache.convexHull(m.V);
+  CHECK_EQ(h1, h2, "not shared");
+  cache.clear();
+  double timeDisk=-rai::realTime();
+  auto h3 = cache.convexHull(m.V);
+  timeDisk += rai::realTime();
+  CHECK_ZERO(maxDiff(h1->V, h3->V), 0., "");
+  CHECK_EQ(h1->T, h3->T, "");
+  cout <<"hull: computed in " <<time <<"sec, loaded in " <<timeDisk <<"sec" <<endl;
+
+  //meshes from files: keyed by content and scale, invalidated by modification
+  m.writeTriFile("z.tri");
+  uint loads=0;
+  auto load = [&loads](rai::Mesh& m) { loads++; m.read(FILE("z.tri"), "tri", "z.tri"); };
+  auto m1 = cache.mesh("z.tri", 1., load);
+  auto m2 = cache.mesh("z.tri", 1., load);
+  auto m3 = cache.mesh("z.tri", 2., load);
+  CHECK(m1==m2 && m1!=m3 && loads==2, "");
+  rai::wait(.01);
+  m.scale(2.);
+  m.writeTriFile("z.tri");
+  auto m4 = cache.mesh("z.tri", 1., load);
+  CHECK(m4!=m1 && loads==3, "modified file was not reloaded");
+
+  //missing files fail (instead of sharing one key)
+  bool failed=false;
+  try { cache.mesh("z.missing.tri", 1., load); } catch(std::runtime_error&) { failed=true; }
+  CHECK(failed && loads==3, "missing file did not fail");
+
+  //disk entries whose stored key does not match are recomputed
+  rai::AssetCache::Key key = rai::AssetCache::Key().add(m.V);
+  cache.clear();
+  uint misses = cache.stats().misses;
+  {
+    rai::String file = STRING("z.assets/hull-" <<std::hex <<std::setw(16) <<std::setfill('0') <<key.h <<".arr");
+    std::ofstream fil(file.p);
+    fil <<"key " <<key.h <<' ' <<key.check+1 <<' ' <<key.bytes <<"\nV [] T []\n"; //same name, different content
+  }
+  auto h4 = cache.convexHull(m.V);
+  CHECK_EQ(cache.stats().misses, misses+1, "mismatching disk entry was used");
+  CHECK_EQ(h4->T, h1->T, "");
+
+  //memory and disk are limited: least recently used entries are dropped, users keep theirs
+  cache.opt.maxMegabytes = 1e-3;
+  cache.opt.maxDiskMegabytes = 1e-3;
+  rai::Array<shared_ptr<const rai::Mesh>> hulls;
+  for(uint i=0; i<10; i++) { rai::Mesh r;  r.setRandom(100);  hulls.append(cache.convexHull(r.V)); }
+  CHECK_GE(cache.stats().evictions, 1, "");
+  CHECK_GE(cache.stats().diskEvictions, 1, "");
+  for(auto& h:hulls) CHECK_GE(h->T.d0, 4, "an evicted entry was destroyed for its user");
+  cache.opt.maxMegabytes = 1000.;
+  cache.opt.maxDiskMegabytes = 1000.;
+
+  cache.report(cout);
+  auto stats = cache.stats();
+  CHECK_GE(stats.diskHits, 1, "");
+  CHECK_GE(stats.memHits, 2, "");
+  cache.opt.path.clear();
+}
+
+//===========================================================================
+
 int MAIN(int argc, char** argv){
   rai::initCmdLine(argc, argv);
 
@@ -139,6 +214,7 @@ int MAIN(int argc, char** argv){
   testVolume();
   testDistanceFunctions();
   testSimpleImplicitSurfaces();
+  testAssetCache();
 
   return 0;
 }
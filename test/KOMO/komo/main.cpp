@@ -58,6 +58,43 @@ void TEST(Easy){
 
 //===========================================================================
 
+void TEST(FeatureMemo){
+  rai::Configuration C(rai::raiPath("../rai-robotModels/tests/arm.g"));
+
+  KOMO komo;
+  komo.setConfig(C, false);
+  komo.setTiming(1., 100, 5., 2);
+  komo.addControlObjective({}, 1, 1.);
+  komo.addControlObjective({}, 2, 1.);
+  komo.addObjective({}, FS_position, {"endeff"}, OT_sos, {1e-1}, {}, 1);
+  komo.addObjective({}, FS_position, {"endeff"}, OT_sos, {1e-1}, {}, 2);
+  komo.addObjective({1.}, FS_positionDiff, {"endeff", "target"}, OT_eq, {1e2});
+  komo.run_prepare(.1);
+
+  //-- the memo must not change values or Jacobians
+  auto nlp = komo.nlp();
+  arr phi0, J0, phi1, J1;
+  komo.opt.memoFeatures=false;
+  double time0 = -rai::cpuTime();
+  for(uint k=0; k<10; k++) nlp->evaluate(phi0, J0, komo.x);
+  time0 += rai::cpuTime();
+  komo.opt.memoFeatures=true;
+  double time1 = -rai::cpuTime();
+  for(uint k=0; k<10; k++) nlp->evaluate(phi1, J1, komo.x);
+  time1 += rai::cpuTime();
+
+  CHECK_EQ(maxDiff(phi0, phi1), 0., "memoized feature values differ");
+  CHECK_EQ(maxDiff(J0.sparse().unsparse(), J1.sparse().unsparse()), 0., "memoized Jacobians differ");
+  cout <<"memo hits: " <<komo.featureMemo.hits <<" misses: " <<komo.featureMemo.misses
+       <<" time without memo: " <<time0 <<"sec with memo: " <<time1 <<"sec" <<endl;
+  //each order-1 and order-2 objective is a miss itself, but reuses the per-slice values of its finite difference window
+  CHECK_GE(2*komo.featureMemo.hits, komo.featureMemo.misses, "finite difference windows should be reused");
+
+  nlp->checkJacobian(komo.x, 1e-6);
+}
+
+//===========================================================================
+
 void TEST(Align){
   rai::Configuration C(rai::raiPath("../rai-robotModels/tests/arm.g"));
   cout <<"configuration space dim=" <<C.getJointStateDimension() <<endl;
@@ -243,6 +280,7 @@ int MAIN(int argc,char** argv){
 //  rnd.clockSeed();
 
   testEasy();
+  testFeatureMemo();
   testAlign();
   testThin();
   testPR2();
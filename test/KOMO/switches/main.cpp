@@ -4,6 +4,8 @@
 #include <Core/graph.h>
 #include <KOMO/switch.h>
 #include <Kin/frame.h>
+#include <Kin/F_collisions.h>
+#include <Kin/proxy.h>
 #include <Optim/NLP_Solver.h>
 #include <KOMO/skeletonSymbol.h>
 
@@ -209,9 +211,116 @@ void testFloat(uint order){
 
 //===========================================================================
 
+void testAddPhases(){
+  rai::Configuration C("model2.g");
+
+  //phase 1: grasp (a switch that persists), and open-ended objectives
+  auto phase1 = [&C](KOMO& komo, double phases){
+    komo.setConfig(C, false);
+    komo.setTiming(phases, 10, 5., 2);
+    komo.addControlObjective({}, 2);
+    komo.addControlObjective({}, 0, 1e-1);
+    komo.addQuaternionNorms();
+    komo.addModeSwitch({1., -1.}, rai::SY_stable, {"gripper", "box"}, true);
+    komo.addObjective({1.}, FS_positionDiff, {"gripper", "box"}, OT_eq, {1e2});
+    komo.addObjective({1.}, FS_vectorZ, {"gripper"}, OT_eq, {1e2}, {0., 0., 1.});
+    komo.addObjective({.5, -1.}, FS_position, {"gripper"}, OT_sos, {1e-1}, {}, 0, 0, -2); //open-ended, ending two steps early
+  };
+  //phase 2: bring the box above the table
+  auto phase2 = [](KOMO& komo){
+    komo.addObjective({2.}, FS_positionDiff, {"box", "table"}, OT_eq, {1e2}, {0., 0., .2});
+  };
+
+  KOMO fresh;
+  phase1(fresh, 2.);
+  phase2(fresh);
+
+  KOMO incremental;
+  phase1(incremental, 1.);
+  incremental.run_prepare(0.);
+  incremental.addPhases(1);
+  phase2(incremental);
+
+  //a clone keeps each objective's groundings (motif analysis iterates them)
+  KOMO copy;
+  copy.clone(incremental, false);
+  CHECK_EQ(copy.objectives.N, incremental.objectives.N, "");
+  for(uint i=0; i<copy.objectives.N; i++) CHECK_EQ(copy.objectives(i)->groundings.N, incremental.objectives(i)->groundings.N, "");
+
+  //same dimensions, and same feature values and Jacobians (up to the order in which objectives are grounded)
+  fresh.run_prepare(0.);
+  incremental.run_prepare(0.);
+  CHECK_EQ(fresh.T, incremental.T, "");
+  CHECK_EQ(fresh.pathConfig.frames.N, incremental.pathConfig.frames.N, "");
+  auto nlpF = fresh.nlp(), nlpI = incremental.nlp();
+  CHECK_EQ(nlpF->dimension, nlpI->dimension, "");
+  CHECK_EQ(nlpF->featureTypes.N, nlpI->featureTypes.N, "");
+
+  arr x = fresh.x + .01*randn(fresh.x.N);
+  arr phiF, JF, phiI, JI;
+  nlpF->evaluate(phiF, JF, x);
+  nlpI->evaluate(phiI, JI, x);
+  JF = JF.sparse().unsparse();
+  JI = JI.sparse().unsparse();
+  CHECK_ZERO(maxDiff(~JF*JF, ~JI*JI), 1e-8, "");
+  CHECK_ZERO(maxDiff(~JF*phiF, ~JI*phiI), 1e-8, "");
+  phiF.sort();
+  phiI.sort();
+  CHECK_ZERO(maxDiff(phiF, phiI), 1e-10, "");
+
+  //solving both from the same initialization reaches the same costs
+  incremental.x = fresh.x;
+  incremental.pathConfig.setJointState(fresh.x);
+  auto retF = rai::NLP_Solver().setProblem(fresh.nlp()).solve();
+  auto retI = rai::NLP_Solver().setProblem(incremental.nlp()).solve();
+  cout <<"from scratch: " <<*retF <<"\nincremental:  " <<*retI <<endl;
+  CHECK_ZERO(retF->sos-retI->sos, 1e-4*(1.+retF->sos), "");
+  CHECK_ZERO(retF->eq-retI->eq, 1e-4, "");
+}
+
+//===========================================================================
+
+void testCollisionFilter(){
+  //a box overlapping the gripper, rigidly attached to it from phase 1 on (contact -1: no collisions with the link it is attached to)
+  rai::Configuration C;
+  C.addFrame("gripper")->setPosition({0., 0., 1.}).setShape(rai::ST_sphere, {.1}).setContact(1);
+  C.addFrame("box")->setPosition({0., 0., 1.05}).setShape(rai::ST_box, {.1, .1, .1}).setContact(-1);
+
+  KOMO komo;
+  komo.setConfig(C, true);
+  komo.setTiming(2., 2, 1., 1);
+  komo.addRigidSwitch(1., {"gripper", "box"});
+  komo.addObjective({}, FS_accumulatedCollisions, {}, OT_eq, {1e1});
+  komo.addPhases(1); //frames added after the filter was built are filtered as well
+  komo.set_x(komo.x);
+
+  //in the slices where the box is attached, the pair is excluded: no proxy, no collision cost
+  uint g=C["gripper"]->ID, b=C["box"]->ID;
+  uint attachedSlices=0;
+  for(uint t=0; t<komo.T; t++){
+    rai::Frame *gt = komo.timeSlices(komo.k_order+t, g), *bt = komo.timeSlices(komo.k_order+t, b);
+    bool attached = (bt->parent==gt);
+    if(attached) attachedSlices++;
+    CHECK_EQ(komo.pathConfig.coll_isExcluded(gt->ID, bt->ID), attached, "filter wrong in slice " <<t);
+    bool proxy=false;
+    for(rai::Proxy& p:komo.pathConfig.proxies) if((p.a==gt && p.b==bt) || (p.a==bt && p.b==gt)) proxy=true;
+    CHECK_EQ(proxy, !attached, "proxy of slice " <<t);
+    FrameL F = komo.timeSlices[komo.k_order+t];
+    double cost = F_AccumulatedCollisions().eval(F).scalar();
+    if(attached){ CHECK_EQ(cost, 0., "an excluded pair contributes to the collision feature"); }
+    else{ CHECK_GE(cost, 1e-3, "the overlapping pair must contribute before the switch"); }
+  }
+  CHECK(attachedSlices>0 && attachedSlices<komo.T, "");
+}
+
+//===========================================================================
+
 int main(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
+  testCollisionFilter();
+  testAddPhases();
+
   testPickAndPlace(2);
   testPickAndPlace(1);
   testPickAndPlace(0);
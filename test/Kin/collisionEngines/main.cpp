@@ -2,6 +2,8 @@
 //#include <Kin/kin_swift.h>
 #include <Gui/opengl.h>
 #include <Kin/frame.h>
+#include <KOMO/switch.h>
+#include <Geo/fclInterface.h>
 
 /*void TEST(Swift) {
   rai::Configuration C("swift_test.g");
@@ -101,11 +103,87 @@ void TEST(CollisionTiming){
   cout <<" query time: " <<rai::timerRead(true) <<"sec" <<endl;
 }
 
+void TEST(CollisionFilter){
+  //a gripper (two links with two shapes each) and two free objects
+  rai::Configuration C;
+  C.addFrame("table")->setShape(rai::ST_ssBox, {2., 2., .1, .02}).setContact(1);
+  rai::Frame* base = C.addFrame("base", "table");
+  base->setShape(rai::ST_ssBox, {.2, .2, .2, .02}).setContact(1);
+  rai::Frame* finger = C.addFrame("finger", "base");
+  finger->setJoint(rai::JT_hingeX);
+  finger->setShape(rai::ST_capsule, {.2, .02}).setContact(-1);
+  C.addFrame("fingertip", "finger")->setShape(rai::ST_sphere, {.03}).setContact(1);
+  C.addFrame("obj1")->setShape(rai::ST_box, {.1, .1, .1}).setContact(1);
+  C.addFrame("obj2")->setShape(rai::ST_box, {.1, .1, .1}).setContact(-1); //excludes collisions with its parent link
+
+  //the bitset must agree with Shape::canCollideWith on all pairs (except explicit ones)
+  auto checkFilter = [&C](){
+    auto M = C.coll_filter();
+    for(rai::Frame* a:C.frames) for(rai::Frame* b:C.frames) if(a!=b && a->shape && b->shape && a->shape->cont && b->shape->cont){
+      if(a->name.startsWith("obj") && b->name.startsWith("obj")) continue;
+      CHECK_EQ((*M)(a->ID, b->ID), !a->shape->canCollideWith(b), "filter wrong for " <<a->name <<' ' <<b->name);
+    }
+  };
+  checkFilter();
+  uint shapes=0;
+  for(rai::Frame* f:C.frames) if(f->shape && f->shape->cont) shapes++;
+  CHECK_LE(C.coll_filter()->IDs.N, shapes, "the filter has rows only for collision shapes");
+  uint ex = C.coll_filter()->count();
+  cout <<"#excluded pairs: " <<ex <<endl;
+
+  //explicit pairs persist across rebuilds
+  C.coll_addExcludePair(C["obj1"]->ID, C["obj2"]->ID);
+  CHECK(C.coll_isExcluded(C["obj2"]->ID, C["obj1"]->ID), "");
+  C.coll_fclReset();
+  CHECK(C.coll_filter()->count()==ex+1, "");
+
+  //incremental update after a switch equals a rebuild
+  CHECK(!C.coll_isExcluded(C["finger"]->ID, C["obj2"]->ID), "");
+  rai::KinematicSwitch(rai::SW_joint, rai::JT_rigid, "fingertip", "obj2", C).apply(C.frames);
+  CHECK(C.coll_isExcluded(C["finger"]->ID, C["obj2"]->ID), "attached object must be excluded from its parent link");
+  checkFilter();
+  rai::CollisionMatrix M = *C.coll_filter();
+  C.coll_fclReset();
+  CHECK(C.coll_filter()->getPairs()==M.getPairs(), "incremental update differs from rebuild");
+
+  //a copy referencing the filter does not modify the original's
+  {
+    rai::Configuration C2;
+    C2.copy(C, true);
+    CHECK(C2.coll_isExcluded(C2["obj1"]->ID, C2["obj2"]->ID), "");
+    C2.coll_addExcludePair(C2["table"]->ID, C2["obj1"]->ID);
+    rai::KinematicSwitch(rai::SW_joint, rai::JT_rigid, "fingertip", "obj1", C2).apply(C2.frames);
+    CHECK(C2.coll_isExcluded(C2["table"]->ID, C2["obj1"]->ID), "");
+    CHECK(!C.coll_isExcluded(C["table"]->ID, C["obj1"]->ID), "the copy's exclude pair leaked into the original");
+    CHECK(C.coll_filter()->getPairs()==M.getPairs(), "the copy's switch modified the original's filter");
+  }
+
+  //deleting and sorting frames renumbers IDs: explicit pairs follow their frames, the filter stays consistent
+  C.addFrame("objExtra")->setShape(rai::ST_box, {.1, .1, .1}).setContact(1);
+  C.coll_addExcludePair(C["objExtra"]->ID, C["obj1"]->ID);
+  delete C["fingertip"];
+  C.coll_filter(); //IDs changed: the filter is rebuilt on demand
+  CHECK(C.coll_isExcluded(C["obj1"]->ID, C["obj2"]->ID), "explicit pair lost after deleting a frame");
+  CHECK(C.coll_isExcluded(C["objExtra"]->ID, C["obj1"]->ID), "explicit pair lost after deleting a frame");
+  checkFilter();
+  C["obj1"]->setParent(C["objExtra"]); //forces a reordering
+  C.sortFrames();
+  C.coll_filter();
+  CHECK_EQ(C.frames, C.calc_topSort(), "");
+  CHECK(C.coll_isExcluded(C["obj1"]->ID, C["obj2"]->ID), "explicit pair lost after sorting");
+  CHECK(C.coll_isExcluded(C["objExtra"]->ID, C["obj1"]->ID), "explicit pair lost after sorting");
+  checkFilter();
+  M = *C.coll_filter();
+  C.coll_fclReset();
+  CHECK(C.coll_filter()->getPairs()==M.getPairs(), "");
+}
+
 int MAIN(int argc, char** argv){
   rai::initCmdLine(argc, argv);
 
   //  testSwift();
   testFCL();
+  testCollisionFilter();
   testCollisionTiming();
 
   return 0;
@@ -1,5 +1,6 @@
 #include <Kin/kin.h>
 #include <Kin/kin_ode.h>
+#include <Kin/kin_feather.h>
 #include <Algo/spline.h>
 #include <Algo/rungeKutta.h>
 #include <Gui/opengl.h>
@@ -91,9 +92,64 @@ void TEST(Dynamics){
 
 // =============================================================================
 
+//---------- compare the recursive (RNEA, ABA) against the explicit (M, F) dynamics, and check the RNEA derivatives
+void TEST(InverseDynamics){
+  rai::Configuration C("arm7.g");
+  C.processStructure();
+  C.sortFrames();
+
+  uint n=C.getJointStateDimension();
+  arr q = C.getJointState();
+  for(uint k=0;k<5;k++){
+    q += .5*randn(n);
+    arr qd = randn(n), qdd = randn(n);
+    C.setJointState(q);
+
+    C.fs().update();
+    C.fs().setGravity();
+
+    //-- RNEA against M*qdd+F
+    arr M, F, tau, tau_q, tau_qd;
+    C.fs().equationOfMotion(M, F, qd);
+    C.fs().invDynamics(tau, qd, qdd, tau_q, tau_qd);
+    double err = maxDiff(tau, M*qdd+F);
+    cout <<"RNEA vs M*qdd+F: " <<err <<endl;
+    CHECK_LE(err, 1e-8, "RNEA and equation of motion inconsistent");
+
+    //-- ABA against the inverse of RNEA
+    arr qdd_;
+    C.fs().fwdDynamics_aba_1D(qdd_, qd, tau);
+    err = maxDiff(qdd_, qdd);
+    cout <<"ABA vs qdd: " <<err <<endl;
+    CHECK_LE(err, 1e-8, "ABA and RNEA inconsistent");
+
+    //-- derivatives against finite differences
+    double eps=1e-6;
+    arr Jq(n,n), Jqd(n,n), tau1, tau2;
+    for(uint i=0;i<n;i++){
+      arr dq = zeros(n);
+      dq(i) = eps;
+      C.setJointState(q+dq);  C.fs().update();  C.fs().setGravity();  C.fs().invDynamics(tau1, qd, qdd);
+      C.setJointState(q-dq);  C.fs().update();  C.fs().setGravity();  C.fs().invDynamics(tau2, qd, qdd);
+      Jq[i] = (tau1-tau2)/(2.*eps);
+      C.setJointState(q);  C.fs().update();  C.fs().setGravity();
+      C.fs().invDynamics(tau1, qd+dq, qdd);
+      C.fs().invDynamics(tau2, qd-dq, qdd);
+      Jqd[i] = (tau1-tau2)/(2.*eps);
+    }
+    double errq = maxDiff(tau_q, ~Jq), errqd = maxDiff(tau_qd, ~Jqd);
+    cout <<"dtau/dq: " <<errq <<"  dtau/dqd: " <<errqd <<endl;
+    CHECK_LE(errq, 1e-5, "RNEA q-derivative wrong");
+    CHECK_LE(errqd, 1e-5, "RNEA qd-derivative wrong");
+  }
+}
+
+// =============================================================================
+
 int MAIN(int argc,char **argv){
   rai::initCmdLine(argc, argv);
 
+  testInverseDynamics();
   testDynamics();
 
   return 0;
@@ -105,12 +105,71 @@ void testFeature() {
 
 //===========================================================================
 
+void testJointTorques() {
+  //-- a small serial arm
+  rai::Configuration C;
+  C.addFrame("base");
+  rai::String parent="base";
+  for(uint i=0;i<4;i++){
+    rai::Frame *f = C.addFrame(STRING("link" <<i), parent);
+    f->setRelativePosition({.1, 0., .3});
+    f->setJoint(i%2 ? rai::JT_hingeY : rai::JT_hingeX);
+    f->setMass(1., {.01, .02, .03});
+    parent = f->name;
+  }
+
+  double tau=.1;
+  rai::Configuration pathConfig;
+  for(uint t=0;t<3;t++) pathConfig.addConfigurationCopy(C, {}, tau);
+  pathConfig.jacMode = rai::Configuration::JM_sparse;
+
+  F_JointTorques f;
+  f.setFrameIDs(framesToIndices(C.frames));
+  uint n=pathConfig.getJointStateDimension(), m=C.getJointStateDimension();
+
+  for(uint k=0;k<20;k++){
+    arr x = 2.*(rand(n)-.5);
+    bool succ = checkJacobian(f.asFct(f.getFrames(pathConfig)), x, 1e-5);
+    CHECK(succ, "joint torque Jacobian wrong");
+
+    //-- same as the inverse dynamics of the single configuration
+    FrameL F = f.getFrames(pathConfig);
+    pathConfig.setJointState(x);
+    arr q(3, m);
+    for(uint s=0;s<3;s++) q[s] = pathConfig.getJointState(F[s]); //x is not ordered by slices
+    arr y = f.eval(F);
+    arr torques;
+    C.setJointState(q[1]);
+    C.inverseDynamics(torques, (q[1]-q[0])/tau, (q[2]-2.*q[1]+q[0])/(tau*tau));
+    CHECK_LE(maxDiff(y, torques), 1e-8, "joint torques inconsistent with inverseDynamics");
+  }
+
+  //-- editing a mass and a joint type after evaluation: the feature's cached trees follow
+  for(uint s=0;s<4;s++){
+    rai::Frame *link = (s<3 ? pathConfig.frames.elem(s*C.frames.N+2) : C.frames.elem(2));
+    link->inertia->mass = 3.;
+    link->joint->setType(rai::JT_hingeZ);
+  }
+  FrameL F = f.getFrames(pathConfig);
+  pathConfig.setJointState(2.*(rand(n)-.5));
+  arr q(3, m);
+  for(uint s=0;s<3;s++) q[s] = pathConfig.getJointState(F[s]);
+  arr y = f.eval(F);
+  arr torques;
+  C.setJointState(q[1]);
+  C.inverseDynamics(torques, (q[1]-q[0])/tau, (q[2]-2.*q[1]+q[0])/(tau*tau));
+  CHECK_LE(maxDiff(y, torques), 1e-8, "joint torques stale after editing masses or joint types");
+}
+
+//===========================================================================
+
 int MAIN(int argc, char** argv){
   rai::initCmdLine(argc, argv);
 
   rnd.clockSeed();
 
   testFeature();
+  testJointTorques();
 
   return 0;
 }
@@ -265,6 +265,140 @@ void TEST(Copy){
 
   CHECK_EQ(g1, g2, "copy operator failed!")
   cout <<"** copy operator success" <<endl;
+
+  //repeated copies and path configurations recycle the frame arena; frames can still be added and deleted individually
+  rai::Configuration G3;
+  double time=-rai::cpuTime();
+  for(uint k=0; k<1000; k++) {
+    G3.copy(G1);
+    G3.addConfigurationCopy(G1, "b_");
+    G3.addFrame("extra", G3.frames.last()->name)->setShape(rai::ST_sphere, {.1});
+    delete G3.frames.elem(3);
+  }
+  time += rai::cpuTime();
+  G3.checkConsistency();
+  CHECK_EQ(G3.frames.N, 2*G1.frames.N, "");
+  cout <<"** 1000 copies: " <<time <<"sec" <<endl;
+}
+
+//===========================================================================
+
+void TEST(FrameArena){
+  struct Obj : rai::FrameArenaAllocated { char data[1000]; };
+  uint n=100;
+  size_t batch = n*rai::FrameArena::footprint(sizeof(Obj));
+  rai::FrameArena* A = new rai::FrameArena;
+
+  auto allocBatch = [&](){
+    rai::FrameArena::Scope scope(A);
+    A->reserve(batch);
+    rai::Array<Obj*> objs(n);
+    for(uint i=0; i<n; i++) objs(i) = new Obj;
+    //a reserved batch is contiguous (the reserve accounts for headers and alignment)
+    CHECK_EQ((char*)objs.last()-(char*)objs.first(), (n-1)*rai::FrameArena::footprint(sizeof(Obj)), "");
+    return objs;
+  };
+
+  //blocks without live objects are recycled, also while other blocks are in use
+  rai::Array<Obj*> keep = allocBatch();
+  for(uint k=0; k<100; k++) {
+    rai::Array<Obj*> objs = allocBatch();
+    CHECK_EQ(A->live(), 2*n, "");
+    for(Obj* o:objs) delete o;
+  }
+  CHECK_LE(A->capacity(), 2*batch, "blocks were not recycled");
+
+  for(Obj* o:keep) delete o;
+  CHECK_EQ(A->live(), 0, "");
+  A->unref();
+}
+
+//===========================================================================
+
+void TEST(NameIndex){
+  rai::Configuration C("kinematicTests.g");
+  //getFrame must return the first frame of each name
+  auto checkIndex = [&C](){
+    for(rai::Frame* f:C.frames) {
+      rai::Frame* g = C.getFrame(f->name, false);
+      CHECK(g && g->name==f->name && g->ID<=f->ID, "wrong frame found for '" <<f->name <<"'");
+    }
+  };
+  rai::Frame* a = C.frames.elem(1);
+  rai::Frame* b = C.frames.elem(2);
+  CHECK_EQ(C.getFrame(a->name), a, "");
+
+  //-- rename (requires resetNameIndex)
+  a->name = "renamed";
+  C.resetNameIndex();
+  CHECK_EQ(C.getFrame("renamed"), a, "");
+
+  //-- prefix a subtree
+  rai::Frame* root = C.frames.first();
+  FrameL sub = {root};
+  root->getSubtree(sub);
+  root->prefixSubtree("p_");
+  checkIndex();
+  CHECK_EQ(C.getFrame("renamed", false), (sub.contains(a) ? 0 : a), "");
+
+  //-- delete a frame in the middle
+  rai::String bName = b->name;
+  rai::Frame* last = C.frames.last();
+  delete a;
+  CHECK_EQ(C.getFrame(bName), b, "");
+  checkIndex();
+
+  //-- reorder
+  FrameL order = C.frames;
+  order.reverse();
+  C.setFrameOrder(order);
+  CHECK_EQ(C.frames.first(), last, "");
+  checkIndex();
+  C.sortFrames();
+  checkIndex();
+  C.checkConsistency();
+}
+
+//===========================================================================
+
+void TEST(BinaryFile){
+  rai::Configuration C("kinematicTests.g");
+  C.addFrame("cvxMesh")->setConvexMesh(rai::Mesh().setRandom().V).setContact(1).setMass(.1);
+  new rai::Shape(*C.addFrame("sharedMesh", "cvxMesh"), C["cvxMesh"]->shape); //shares the mesh
+
+  double time=-rai::realTime();
+  C.writeBinaryFile("z.gbin");
+  time += rai::realTime();
+  cout <<"** compile: " <<time <<"sec" <<endl;
+
+  time=-rai::realTime();
+  rai::Configuration C2("z.gbin");
+  time += rai::realTime();
+  cout <<"** binary load: " <<time <<"sec" <<endl;
+
+  //round trip: same .g text, same geometry
+  rai::String g1, g2;
+  g1 <<C;
+  g2 <<C2;
+  CHECK_EQ(g1, g2, "binary round trip failed");
+  CHECK_EQ(C.frames.N, C2.frames.N, "");
+  for(uint i=0; i<C.frames.N; i++) {
+    rai::Shape* s1 = C.frames(i)->shape, *s2 = C2.frames(i)->shape;
+    CHECK_EQ(!s1, !s2, "");
+    if(!s1) continue;
+    CHECK_EQ(s1->type(), s2->type(), "");
+    CHECK_EQ(s1->cont, s2->cont, "");
+    CHECK_EQ(!s1->_sscCore, !s2->_sscCore, "");
+    if(s1->_sscCore) CHECK_ZERO(maxDiff(*s1->_sscCore, *s2->_sscCore), 0., "");
+    CHECK_EQ(!s1->_mesh, !s2->_mesh, "");
+    if(s1->_mesh) {
+      CHECK_ZERO(maxDiff(s1->_mesh->V, s2->_mesh->V), 0., "");
+      CHECK_EQ(s1->_mesh->T, s2->_mesh->T, "");
+    }
+  }
+  CHECK_EQ(C2["cvxMesh"]->shape->_mesh, C2["sharedMesh"]->shape->_mesh, "meshes are not shared");
+  CHECK_ZERO(C["cvxMesh"]->inertia->mass-C2["cvxMesh"]->inertia->mass, 1e-10, "");
+  cout <<"** binary round trip success" <<endl;
 }
 
 //===========================================================================
@@ -784,6 +918,9 @@ int MAIN(int argc,char **argv){
   testMini();
   testLoadSave();
   testCopy();
+  testFrameArena();
+  testNameIndex();
+  testBinaryFile();
   testGraph();
   testPlaySpline();
   testViewer();
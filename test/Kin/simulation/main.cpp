@@ -602,6 +602,87 @@ void testResetState(){
 }
 //===========================================================================
 
+void testBatch(){
+  rai::Configuration C;
+  C.addFile("../bullet/bots.g");
+
+  uint n=8, T=100;
+  double tau=.01;
+
+  //-- kinematic worlds on one thread, then on all cores; PhysX worlds serialized, then stepped concurrently
+  arr Xserial;
+  for(rai::Simulation::Engine engine:{rai::Simulation::_kinematic, rai::Simulation::_physx}) for(bool parallel:{false, true}){
+    arr X0, Q0;
+    rai::SimulationBatch B(C, n, engine);
+    if(engine==rai::Simulation::_physx) B.opt.parallelPhysx = parallel;
+    else B.opt.threads = (parallel ? 0 : 1);
+
+    B.getState(X0, Q0);
+    CHECK_EQ(X0.d0, n, "");
+    CHECK_EQ(Q0.d0, n, "");
+
+    //-- all worlds with the same constant position control
+    arr U = replicate(Q0[0]+.2, n);
+    double time = -rai::realTime();
+    for(uint t=0;t<T;t++) B.step(U, tau, rai::Simulation::_position);
+    time += rai::realTime();
+    cout <<"batch of " <<n <<" " <<rai::Enum<rai::Simulation::Engine>(engine) <<(parallel?" (parallel)":" (serialized)") <<": " <<time/double(T*n) <<"sec/step/world" <<endl;
+
+    arr X, Q, V, QDot;
+    B.getState(X, Q, V, QDot);
+    CHECK_EQ(V.d0, n, "");
+    CHECK_EQ(QDot.d0, n, "");
+    for(uint w=1;w<n;w++) CHECK_ZERO(maxDiff(X[w], X[0]), 1e-6, "world " <<w <<" deviates from world 0");
+    if(!parallel) Xserial = X;
+    else CHECK_ZERO(maxDiff(X, Xserial), 1e-6, "concurrent stepping deviates from serialized stepping");
+
+    //-- reset all worlds
+    B.setState(X0, Q0);
+    B.getState(X, Q);
+    CHECK_ZERO(maxDiff(Q, Q0), 1e-6, "reset failed");
+    CHECK_ZERO(maxDiff(X, X0), 1e-6, "reset failed");
+  }
+}
+
+//===========================================================================
+
+void testSnapshots(){
+  rai::Configuration C;
+  for(uint i=0;i<5;i++){
+    rai::Frame *f = C.addFrame(STRING("block_" <<i));
+    f->setShape(rai::ST_ssBox, {.2,.3,.2,.02});
+    f->setPosition({.01*i, 0., .25*(i+1)});
+    f->setMass(.1);
+  }
+
+  double tau = .01;
+  rai::Simulation S(C, S._physx, 0);
+  auto snap0 = S.getSnapshot();
+  arr X0 = C.getFrameState();
+
+  //-- branch 1
+  for(uint t=0;t<50;t++) S.step({}, tau, S._none);
+  auto snap1 = S.getSnapshot();
+  for(uint t=0;t<50;t++) S.step({}, tau, S._none);
+  arr X1 = C.getFrameState();
+
+  //-- rewind to the start, then to the branching point and replay
+  uint n = S.restoreSnapshot(*snap0);
+  cout <<"restored " <<n <<" bodies/frames, error: " <<maxDiff(C.getFrameState(), X0) <<endl;
+  CHECK_LE(maxDiff(C.getFrameState(), X0), 1e-6, "restoring the initial snapshot failed");
+
+  double time = -rai::realTime();
+  S.restoreSnapshot(*snap1);
+  time += rai::realTime();
+  CHECK_EQ(S.restoreSnapshot(*snap1), 0, "restoring the synced snapshot again should touch nothing");
+  for(uint t=0;t<50;t++) S.step({}, tau, S._none);
+  double dev = maxDiff(C.getFrameState(), X1);
+  cout <<"restore time: " <<time <<"sec, replay deviation: " <<dev <<endl;
+  CHECK_LE(dev, 1e-3, "replay from a restored snapshot deviates"); //the engine states are restored exactly, but contact caches are not
+}
+
+//===========================================================================
+
 int MAIN(int argc,char **argv){
   rai::initCmdLine(argc, argv);
 
@@ -620,6 +701,8 @@ int MAIN(int argc,char **argv){
   testGrasp();
   testResetState();
   testSplineMode();
+  testBatch();
+  testSnapshots();
 
   return 0;
 }
@@ -5,6 +5,115 @@
 
 //===========================================================================
 
+void testThreads(const rai::String& problem){
+  //the first solution found with several workers (twice, to check independence of scheduling)
+  auto solve = [&problem](int threads){
+    rai::Configuration C;
+    C.addFile(problem+".g");
+    auto trans = rai::default_Actions2KOMO_Translator();
+    auto tamp = rai::default_TAMP_Provider(C, problem+".lgp");
+    rai::LGP_Tool lgp(tamp->getConfig(), *tamp, *trans);
+    lgp.threads = threads;
+    lgp.solve(0);
+    return std::make_pair(lgp.getSolvedPlan(), lgp.getSolvedKOMO()->x);
+  };
+
+  auto two = solve(2);
+  auto parallel = solve(4);
+  auto again = solve(4);
+  cout <<"threads=2: " <<two.first <<"\nthreads=4: " <<parallel.first <<endl;
+  CHECK(two.first.N && parallel.first.N, "no plan found");
+  CHECK_EQ(again.first, parallel.first, "parallel results depend on scheduling");
+  CHECK_ZERO(maxDiff(again.second, parallel.second), 0., "parallel results depend on scheduling");
+}
+
+//===========================================================================
+
+void testCache(const rai::String& problem){
+  //a second run reuses the saved results; a changed scene (the size of one shape) misses
+  rai::system("rm -f z.cache");
+  auto solve = [&problem](double scale, uint& hits){
+    rai::Configuration C;
+    C.addFile(problem+".g");
+    auto trans = rai::default_Actions2KOMO_Translator();
+    auto tamp = rai::default_TAMP_Provider(C, problem+".lgp");
+    rai::Frame* f = tamp->getConfig().frames.elem(-1);
+    for(rai::Frame* g:tamp->getConfig().frames) if(g->shape && !g->joint) f=g;
+    f->shape->size *= scale;
+    rai::LGP_Tool lgp(tamp->getConfig(), *tamp, *trans);
+    lgp.cache.opt.set_file("z.cache");
+    lgp.cache.load();
+    lgp.solve(0);
+    hits = lgp.cache.hits;
+    CHECK(!lgp.cache.rejected, "a valid cached result was rejected");
+    return lgp.getSolvedPlan();
+  };
+
+  uint hits;
+  StringAA plan = solve(1., hits);
+  CHECK_EQ(hits, 0, "");
+  CHECK_EQ(solve(1., hits), plan, "");
+  CHECK(hits>0, "no cached result was reused");
+  solve(1.2, hits);
+  CHECK_EQ(hits, 0, "a changed scene hit the cache");
+}
+
+//===========================================================================
+
+void testResultCache(const rai::String& problem){
+  //a motif result stored by one cache is a hit in a fresh cache loaded from its file; moving the object misses
+  auto setup = [&problem](double shift, PTR<KOMO>& ways, PTR<KOMO_Motif>& motif){
+    rai::Configuration C;
+    C.addFile(problem+".g");
+    auto trans = rai::default_Actions2KOMO_Translator();
+    auto tamp = rai::default_TAMP_Provider(C, problem+".lgp");
+    rai::Configuration& CC = tamp->getConfig();
+    StringA action = tamp->getNewPlan()(0);
+    rai::Frame* obj = CC[action(1)];
+    obj->setPosition(obj->getPosition() + arr{shift, 0., 0.});
+    ways = trans->setup_sequence(CC, 1);
+    trans->add_action_constraints(ways, 1., action);
+    motif = rai::analyzeMotifs(*ways)(0);
+    str description = STRING("motif " <<motif->getHash());
+    for(rai::Frame* f:motif->F){ description <<' ' <<f->name; rai::ResultCache::appendPose(description, f->ensure_X(), 1e-3); }
+    return rai::ResultCache::key(description);
+  };
+
+  rai::system("rm -f z.resultCache");
+  PTR<KOMO> ways;
+  PTR<KOMO_Motif> motif;
+  std::string key = setup(0., ways, motif);
+  auto ret = motif->solve(*ways, "gauss", 0);
+  CHECK(ret->feasible, "");
+  {
+    rai::ResultCache cache;
+    cache.put(key, ret);
+    cache.save("z.resultCache");
+  }
+
+  //reload in a fresh instance: same problem hits, with the stored solution that verifies on the rebuilt problem
+  rai::ResultCache cache;
+  CHECK(cache.load("z.resultCache"), "");
+  std::string key2 = setup(0., ways, motif);
+  CHECK_EQ(key2, key, "the key is not reproducible");
+  auto hit = cache.get(key2);
+  CHECK(hit, "no hit after reloading");
+  CHECK_ZERO(maxDiff(hit->x, ret->x), 1e-10, "");
+  CHECK_EQ(hit->feasible, ret->feasible, "");
+  CHECK(motif->verify(*ways, hit->x), "the cached solution does not verify");
+
+  //invalidation: a moved object gives a different key (miss); a rejected hit is erased
+  std::string key3 = setup(.1, ways, motif);
+  CHECK(!cache.get(key3), "a changed scene hit the cache");
+  cache.erase(key);
+  CHECK(!cache.get(key), "an erased entry hit the cache");
+  CHECK_EQ(cache.hits, 1, "");
+  CHECK_EQ(cache.misses, 2, "");
+  CHECK_EQ(cache.rejected, 1, "");
+}
+
+//===========================================================================
+
 int main(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
@@ -12,12 +121,17 @@ int main(int argc,char** argv){
 
   rai::String problem = rai::getParameter<rai::String>("problem", STRING("none"));
 
+  if(rai::getParameter<bool>("testThreads", true)) testThreads(problem);
+  if(rai::getParameter<bool>("testCache", true)) testCache(problem);
+  if(rai::getParameter<bool>("testResultCache", true)) testResultCache(problem);
+
   rai::Configuration C;
   C.addFile(problem+".g");
   auto trans = rai::default_Actions2KOMO_Translator();
   auto tamp = rai::default_TAMP_Provider(C, problem+".lgp");
 
   rai::LGP_Tool lgp(tamp->getConfig(), *tamp, *trans);
+  lgp.threads = rai::getParameter<int>("threads", 1);
 
   bool fixWaypoints = rai::getParameter<bool>("fixWaypoints", true);
 
@@ -1,7 +1,7 @@
 #include <Optim/testProblems_Opt.h>
 #include <functional>
 #include <Optim/NLP_Solver.h>
-// #include <Optim/NLP_Sampler.h>
+#include <Optim/NLP_Sampler.h>
 #include <Optim/SlackGaussNewton.h>
 #include <Optim/lagrangian.h>
 #include <Optim/constrained.h>
@@ -100,6 +100,32 @@ void testSpherePacking(){
 
 //===========================================================================
 
+void testSamplerChains(){
+  uint chains=4, samples=5;
+
+  auto runChains = [&](uint nThreads){
+    rai::Array<arr> X(chains);
+    NLP_Sampler_runChains([](){ return make_shared<BoxNLP>(); }, NLP_Sampler_Options(), chains, samples,
+                          [&X](uint chain, const arr& x, uint evals){ X(chain).append(x); },
+                          nThreads, 0);
+    return X;
+  };
+
+  rnd.seed(42);
+  rai::Rnd before = rnd;
+  rai::Array<arr> X1 = runChains(1);
+  CHECK_EQ(rnd.num(), before.num(), "the serial path changed the caller's rnd");
+  rai::Array<arr> X4 = runChains(4);
+  for(uint c=0;c<chains;c++){
+    cout <<"chain " <<c <<": " <<X4(c) <<endl;
+    CHECK_EQ(X1(c).N, X4(c).N, "chain results depend on threading");
+    CHECK_ZERO(maxDiff(X1(c), X4(c)), 1e-10, "chain results depend on threading");
+    CHECK_LE(absMax(X4(c)), 1.1, "sample is not feasible");
+  }
+}
+
+//===========================================================================
+
 int MAIN(int argc,char** argv){
   rai::initCmdLine(argc,argv);
 
@@ -110,5 +136,6 @@ int MAIN(int argc,char** argv){
   // testSolver();
 
   testSpherePacking();
+  testSamplerChains();
   return 0;
 }